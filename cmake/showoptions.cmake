@@ -61,6 +61,12 @@ else()
   message(STATUS "Build METRICs         : No  (default)")
 endif()
 
+if(BUILD_BENCHMARKS)
+  message(STATUS "Build benchmarks      : Yes")
+else()
+  message(STATUS "Build benchmarks      : No  (default)")
+endif()
+
 if(BUILD_DEPRECATED_PLAYERBOT)
   message(STATUS "Build OLD Playerbot   : Yes")
 else()
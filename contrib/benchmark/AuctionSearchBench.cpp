@@ -0,0 +1,299 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Compares the throughput of auction house searches answered through the search index of the house with
+/// the same searches done as before it: every auction of the house sorted, then filtered one by one with its
+/// item name localised and lower cased. The house is filled with auctions of random item templates, as an
+/// auction house bot would, and the searches are the ones of a player browsing it: a category, often a
+/// subcategory, sometimes a quality, level range or part of a name, sorted by a column or two and one of the
+/// first pages. The auctions listed by both are compared, a difference is reported as an error.
+///
+/// The world is loaded as mangosd does from the given configuration file, see MapTickBench. Auctions and
+/// their items are only created in memory, nothing is saved to the database.
+///
+/// Usage: AuctionSearchBench <mangosd.conf> [auctions = 30000] [searches = 10000] [account = 1000000]
+
+#include "Common.h"
+#include "Log/Log.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+#include "Entities/Player.h"
+#include "Entities/Item.h"
+#include "Globals/ObjectMgr.h"
+#include "Server/SQLStorages.h"
+#include "Server/WorldPacket.h"
+#include "Server/WorldSession.h"
+#include "AuctionHouse/AuctionHouseMgr.h"
+#include "Anticheat/Anticheat.hpp"
+#include "Util/Util.h"
+#include "BenchmarkGlobals.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+struct Search
+{
+    std::wstring name;
+    uint32 listfrom;
+    uint32 levelmin, levelmax;
+    uint32 usable;
+    uint32 inventoryType, itemClass, itemSubClass, quality;
+    uint8 sort[MAX_AUCTION_SORT];
+};
+
+// the way every search went before the index
+static void SearchAll(AuctionHouseObject* house, Player* player, Search& search, WorldPacket& data, uint32& count, uint32& totalcount)
+{
+    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
+
+    std::vector<AuctionEntry*> auctions;
+    auctions.reserve(house->GetCount());
+    for (auto const& itr : house->GetAuctions())
+        auctions.push_back(itr.second);
+
+    std::sort(auctions.begin(), auctions.end(), AuctionSorter(search.sort, player));
+
+    for (AuctionEntry* Aentry : auctions)
+    {
+        if (Aentry->moneyDeliveryTime)
+            continue;
+        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+        if (!item)
+            continue;
+
+        ItemPrototype const* proto = item->GetProto();
+
+        if (search.itemClass != 0xffffffff && proto->Class != search.itemClass)
+            continue;
+
+        if (search.itemSubClass != 0xffffffff && proto->SubClass != search.itemSubClass)
+            continue;
+
+        if (search.inventoryType != 0xffffffff && proto->InventoryType != search.inventoryType)
+            if (search.inventoryType != INVTYPE_CHEST || proto->InventoryType != INVTYPE_ROBE)
+                continue;
+
+        if (search.quality != 0xffffffff && proto->Quality < search.quality)
+            continue;
+
+        if (search.levelmin != 0x00 && (proto->RequiredLevel < search.levelmin || (search.levelmax != 0x00 && proto->RequiredLevel > search.levelmax)))
+            continue;
+
+        if (search.usable != 0x00)
+        {
+            if (player->CanUseItem(item) != EQUIP_ERR_OK)
+                continue;
+
+            if (proto->Class == ITEM_CLASS_RECIPE)
+                if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
+                    if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                        continue;
+        }
+
+        std::string name = proto->Name1;
+        sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+
+        if (!search.name.empty() && !Utf8FitTo(name, search.name))
+            continue;
+
+        if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= search.listfrom)
+        {
+            ++count;
+            Aentry->BuildAuctionInfo(data);
+        }
+
+        ++totalcount;
+    }
+}
+
+static void SearchIndex(AuctionHouseObject* house, Player* player, Search& search, WorldPacket& data, uint32& count, uint32& totalcount)
+{
+    house->BuildListAuctionItems(data, player, search.name, search.listfrom, search.levelmin, search.levelmax, search.usable,
+                                 search.inventoryType, search.itemClass, search.itemSubClass, search.quality, search.sort, count, totalcount, false);
+}
+
+// ids of the auctions listed, the first field of records of the same size
+static std::vector<uint32> ListedIds(WorldPacket const& data, uint32 count)
+{
+    std::vector<uint32> ids;
+    if (!count)
+        return ids;
+
+    size_t stride = data.size() / count;
+    for (uint32 i = 0; i < count; ++i)
+        ids.push_back(data.read<uint32>(i * stride));
+    return ids;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <mangosd.conf> [auctions = 30000] [searches = 10000] [account = 1000000]\n", argv[0]);
+        return 1;
+    }
+
+    uint32 const auctionCount = argc > 2 ? uint32(atoi(argv[2])) : 30000;
+    uint32 const searches = argc > 3 ? uint32(atoi(argv[3])) : 10000;
+    uint32 const account = argc > 4 ? uint32(atoi(argv[4])) : 1000000;
+    if (!auctionCount || !searches || !account)
+        return 1;
+
+    if (!StartBenchmarkWorld(argv[1]))
+        return 1;
+
+    WorldSession* session = new WorldSession(account, nullptr, SEC_PLAYER, sWorld.getConfig(CONFIG_UINT32_EXPANSION), 0, LOCALE_enUS, "bench", 0, 0, false);
+    session->AssignAnticheat(std::unique_ptr<SessionAnticheatInterface>(new NullSessionAnticheat(session)));
+
+    Player* player = new Player(session);
+    if (!player->Create(sObjectMgr.GeneratePlayerLowGuid(), "Benchauction", RACE_HUMAN, CLASS_WARRIOR, GENDER_MALE, 0, 0, 0, 0, 0, 0))
+    {
+        printf("Cannot create the character\n");
+        delete player;
+        delete session;
+        return 1;
+    }
+
+    session->SetPlayer(player, player->GetGUIDLow());
+
+    std::vector<ItemPrototype const*> protos;
+    for (uint32 id = 0; id < sItemStorage.GetMaxEntry(); ++id)
+        if (ItemPrototype const* proto = sItemStorage.LookupEntry<ItemPrototype>(id))
+            protos.push_back(proto);
+
+    if (protos.empty())
+    {
+        printf("No item templates loaded\n");
+        return 1;
+    }
+
+    std::mt19937 rand(1);
+    AuctionHouseEntry const* houseEntry = sAuctionHouseStore.LookupEntry(7);
+    AuctionHouseObject* house = sAuctionMgr.GetAuctionsMap(houseEntry);
+
+    std::vector<ItemPrototype const*> auctioned;
+    for (uint32 i = 0; i < auctionCount; ++i)
+    {
+        ItemPrototype const* proto = protos[rand() % protos.size()];
+        Item* item = Item::CreateItem(proto->ItemId, 1);
+        if (!item)
+            continue;
+
+        AuctionEntry* auction = new AuctionEntry;
+        auction->Id = sObjectMgr.GenerateAuctionID();
+        auction->itemGuidLow = item->GetGUIDLow();
+        auction->itemTemplate = proto->ItemId;
+        auction->itemCount = 1;
+        auction->itemRandomPropertyId = 0;
+        auction->owner = 0;
+        auction->startbid = 1 + rand() % 100000;
+        auction->bid = rand() % 4 ? 0 : auction->startbid + rand() % 1000;
+        auction->bidder = auction->bid ? 1 + rand() % 100 : 0;
+        auction->buyout = rand() % 3 ? auction->startbid * 2 : 0;
+        auction->expireTime = time(nullptr) + HOUR * (12 + rand() % 36);
+        auction->moneyDeliveryTime = 0;
+        auction->deposit = 0;
+        auction->auctionHouseEntry = houseEntry;
+
+        sAuctionMgr.AddAItem(item);
+        house->AddAuction(auction);
+        auctioned.push_back(proto);
+    }
+
+    // columns the client sorts by: level, quality, buyout then bid, duration, name, bid
+    uint8 const sortColumns[] = { 0, 1, 2, 3, 5, 8 };
+
+    std::vector<Search> queries(searches);
+    for (Search& search : queries)
+    {
+        ItemPrototype const* proto = auctioned[rand() % auctioned.size()];
+        search.itemClass = proto->Class;
+        search.itemSubClass = rand() % 4 ? proto->SubClass : 0xffffffff;
+        search.inventoryType = rand() % 5 ? 0xffffffff : proto->InventoryType;
+        search.quality = rand() % 3 ? 0xffffffff : proto->Quality;
+        search.levelmin = rand() % 3 ? 0 : proto->RequiredLevel;
+        search.levelmax = search.levelmin ? search.levelmin + rand() % 10 : 0;
+        search.usable = rand() % 10 ? 0 : 1;
+        search.listfrom = rand() % 3 ? 0 : MAX_AUCTION_ITEMS_CLIENT_UI_PAGE * (rand() % 4);
+
+        if (!(rand() % 3))
+        {
+            std::wstring name = sAuctionMgr.GetItemName(proto, -1).lowerName;
+            if (name.size() > 3)
+                search.name = name.substr(rand() % (name.size() - 3), 3);
+        }
+
+        memset(search.sort, MAX_AUCTION_SORT, MAX_AUCTION_SORT);
+        uint32 sortCount = rand() % 3;
+        for (uint32 i = 0; i < sortCount; ++i)
+            search.sort[i] = sortColumns[rand() % sizeof(sortColumns)] | (rand() % 2 ? AUCTION_SORT_REVERSED : 0);
+    }
+
+    printf("AuctionSearchBench: %u auctions of %u item templates, %u searches\n", house->GetCount(), uint32(protos.size()), searches);
+
+    uint64 allListed = 0, indexListed = 0, allFound = 0, indexFound = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (Search& search : queries)
+    {
+        WorldPacket data(SMSG_AUCTION_LIST_RESULT);
+        uint32 count = 0, totalcount = 0;
+        SearchAll(house, player, search, data, count, totalcount);
+        allListed += count;
+        allFound += totalcount;
+    }
+    double allTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (Search& search : queries)
+    {
+        WorldPacket data(SMSG_AUCTION_LIST_RESULT);
+        uint32 count = 0, totalcount = 0;
+        SearchIndex(house, player, search, data, count, totalcount);
+        indexListed += count;
+        indexFound += totalcount;
+    }
+    double indexTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint32 mismatches = 0;
+    for (uint32 i = 0; i < std::min(searches, 1000u); ++i)
+    {
+        WorldPacket allData(SMSG_AUCTION_LIST_RESULT), indexData(SMSG_AUCTION_LIST_RESULT);
+        uint32 allCount = 0, allTotal = 0, indexCount = 0, indexTotal = 0;
+        SearchAll(house, player, queries[i], allData, allCount, allTotal);
+        SearchIndex(house, player, queries[i], indexData, indexCount, indexTotal);
+        if (allTotal != indexTotal || ListedIds(allData, allCount) != ListedIds(indexData, indexCount))
+            ++mismatches;
+    }
+
+    printf("%-10s %16s %16s %16s\n", "", "searches/s", "found/search", "listed/search");
+    printf("%-10s %16.0f %16.2f %16.2f\n", "all", searches / allTime, double(allFound) / searches, double(allListed) / searches);
+    printf("%-10s %16.0f %16.2f %16.2f\n", "index", searches / indexTime, double(indexFound) / searches, double(indexListed) / searches);
+    if (mismatches)
+        printf("ERROR: %u searches listed other auctions through the index\n", mismatches);
+
+    session->SetPlayer(nullptr, 0);
+    delete player;
+    delete session;
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Globals the game library expects from the executable, as defined by mangosd's Main.cpp, and the world
+/// bootstrap of the benchmarks.
+
+#include "BenchmarkGlobals.h"
+#include "Config/Config.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+#include "Maps/MapManager.h"
+
+#include <cstdio>
+
+DatabaseType WorldDatabase;
+DatabaseType CharacterDatabase;
+DatabaseType LoginDatabase;
+DatabaseType LogsDatabase;
+
+uint32 realmID;
+
+static bool StartDatabase(DatabaseType& database, char const* name)
+{
+    std::string dbstring = sConfig.GetStringDefault((std::string(name) + "DatabaseInfo").c_str(), "");
+    if (dbstring.empty())
+    {
+        printf("%sDatabaseInfo not specified in configuration file\n", name);
+        return false;
+    }
+
+    if (!database.Initialize(dbstring.c_str(), 1))
+    {
+        printf("Cannot connect to %s database %s\n", name, dbstring.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool StartBenchmarkWorld(char const* configFile)
+{
+    if (!sConfig.SetSource(configFile, "Mangosd_"))
+    {
+        printf("Could not find configuration file %s\n", configFile);
+        return false;
+    }
+
+    realmID = sConfig.GetIntDefault("RealmID", 0);
+
+    if (!StartDatabase(WorldDatabase, "World") || !StartDatabase(CharacterDatabase, "Character") ||
+        !StartDatabase(LoginDatabase, "Login") || !StartDatabase(LogsDatabase, "Logs"))
+        return false;
+
+    sWorld.SetInitialWorldSettings();
+    return true;
+}
+
+Map* CreateBenchmarkMap(uint32 mapId)
+{
+    Map* map = sMapMgr.CreateMap(mapId, nullptr);
+    if (!map)
+        printf("Cannot create map %u\n", mapId);
+
+    return map;
+}
+
+void StopBenchmarkWorld()
+{
+    CharacterDatabase.HaltDelayThread();
+    WorldDatabase.HaltDelayThread();
+    LoginDatabase.HaltDelayThread();
+    LogsDatabase.HaltDelayThread();
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// World bootstrap shared by the benchmarks which run on a loaded world.
+
+#ifndef MANGOS_BENCHMARK_GLOBALS_H
+#define MANGOS_BENCHMARK_GLOBALS_H
+
+#include "Common.h"
+
+class Map;
+
+// Loads the world as mangosd does: the given configuration file, the realm id, the world, character, login
+// and logs databases and World::SetInitialWorldSettings. Prints the reason and returns false on failure.
+bool StartBenchmarkWorld(char const* configFile);
+
+// Creates the map mapId on the loaded world, prints the reason and returns nullptr on failure.
+Map* CreateBenchmarkMap(uint32 mapId);
+
+// Executes the requests still queued for the databases and stops their worker threads.
+void StopBenchmarkWorld();
+
+#endif
@@ -0,0 +1,171 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Compares the throughput of unit range searches walking the object lists of the cells with the same
+/// searches answered from the position indexes of the cells. Creatures of the given entry are spawned
+/// close together around a point of a map, so the cells searched are crowded, and every search looks for
+/// the living units within range of one of them, once through the lists and once through the indexes.
+/// The units found by both are compared, a difference is reported as an error.
+///
+/// The world is loaded as mangosd does from the given configuration file, see MapTickBench.
+///
+/// Usage: CellIndexBench <mangosd.conf> <mapId> <x> <y> <creature entry> [creatures = 2000] [spread = 60] [range = 10] [searches = 100000]
+
+#include "Common.h"
+#include "Log/Log.h"
+#include "Maps/Map.h"
+#include "Entities/Creature.h"
+#include "Entities/TemporarySpawn.h"
+#include "Grids/CellImpl.h"
+#include "Grids/GridNotifiers.h"
+#include "Grids/GridNotifiersImpl.h"
+#include "BenchmarkGlobals.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+typedef MaNGOS::UnitListSearcher<MaNGOS::AnyUnitInObjectRangeCheck> RangeSearcher;
+
+// the way every search went before the indexes
+static void SearchLists(Map* map, Creature* center, float range, UnitList& found)
+{
+    MaNGOS::AnyUnitInObjectRangeCheck check(center, range);
+    RangeSearcher searcher(found, check);
+
+    CellPair p(MaNGOS::ComputeCellPair(center->GetPositionX(), center->GetPositionY()));
+    Cell cell(p);
+    cell.SetNoCreate();
+    TypeContainerVisitor<RangeSearcher, GridTypeMapContainer> gridVisitor(searcher);
+    TypeContainerVisitor<RangeSearcher, WorldTypeMapContainer> worldVisitor(searcher);
+    cell.Visit(p, gridVisitor, *map, *center, range);
+    cell.Visit(p, worldVisitor, *map, *center, range);
+}
+
+static void SearchIndexes(Creature* center, float range, UnitList& found)
+{
+    MaNGOS::AnyUnitInObjectRangeCheck check(center, range);
+    RangeSearcher searcher(found, check);
+    Cell::VisitAllObjects(center, searcher, range);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 6)
+    {
+        printf("Usage: %s <mangosd.conf> <mapId> <x> <y> <creature entry> [creatures = 2000] [spread = 60] [range = 10] [searches = 100000]\n", argv[0]);
+        return 1;
+    }
+
+    uint32 const mapId = uint32(atoi(argv[2]));
+    float const centerX = float(atof(argv[3]));
+    float const centerY = float(atof(argv[4]));
+    uint32 const entry = uint32(atoi(argv[5]));
+    uint32 const creatures = argc > 6 ? uint32(atoi(argv[6])) : 2000;
+    float const spread = argc > 7 ? float(atof(argv[7])) : 60.0f;
+    float const range = argc > 8 ? float(atof(argv[8])) : 10.0f;
+    uint32 const searches = argc > 9 ? uint32(atoi(argv[9])) : 100000;
+    if (!creatures || !searches || spread <= 0.0f || range <= 0.0f)
+        return 1;
+
+    if (!StartBenchmarkWorld(argv[1]))
+        return 1;
+
+    Map* map = CreateBenchmarkMap(mapId);
+    if (!map)
+        return 1;
+
+    std::mt19937 rand(1);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<Creature*> spawned;
+    spawned.reserve(creatures);
+    for (uint32 i = 0; i < creatures; ++i)
+    {
+        float distance = spread * std::sqrt(unit(rand));
+        float angle = unit(rand) * 2 * M_PI_F;
+        float x = centerX + distance * std::cos(angle);
+        float y = centerY + distance * std::sin(angle);
+        float z = map->GetHeight(PHASEMASK_NORMAL, x, y, MAX_HEIGHT);
+        if (z <= INVALID_HEIGHT)
+            z = 0.0f;
+
+        TempSpawnSettings settings(nullptr, entry, x, y, z, angle, TEMPSPAWN_MANUAL_DESPAWN, 0);
+        if (Creature* creature = WorldObject::SummonCreature(settings, map, PHASEMASK_NORMAL))
+            spawned.push_back(creature);
+    }
+
+    if (spawned.empty())
+    {
+        printf("Cannot spawn creature %u on map %u\n", entry, mapId);
+        return 1;
+    }
+
+    std::vector<Creature*> centers(searches);
+    for (Creature*& center : centers)
+        center = spawned[rand() % spawned.size()];
+
+    printf("CellIndexBench: map %u, %u creatures within %.1f yards, %u searches of %.1f yards\n",
+           mapId, uint32(spawned.size()), spread, searches, range);
+
+    uint64 listFound = 0, indexFound = 0;
+    uint32 mismatches = 0;
+    UnitList found;
+
+    auto start = std::chrono::steady_clock::now();
+    for (Creature* center : centers)
+    {
+        found.clear();
+        SearchLists(map, center, range, found);
+        listFound += found.size();
+    }
+    double listTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (Creature* center : centers)
+    {
+        found.clear();
+        SearchIndexes(center, range, found);
+        indexFound += found.size();
+    }
+    double indexTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // same units, whatever the order
+    for (uint32 i = 0; i < std::min(searches, 1000u); ++i)
+    {
+        UnitList fromLists, fromIndexes;
+        SearchLists(map, centers[i], range, fromLists);
+        SearchIndexes(centers[i], range, fromIndexes);
+        fromLists.sort();
+        fromIndexes.sort();
+        if (fromLists != fromIndexes)
+            ++mismatches;
+    }
+
+    printf("%-10s %16s %16s\n", "", "searches/s", "units/search");
+    printf("%-10s %16.0f %16.2f\n", "lists", searches / listTime, double(listFound) / searches);
+    printf("%-10s %16.0f %16.2f\n", "indexes", searches / indexTime, double(indexFound) / searches);
+    if (mismatches)
+        printf("ERROR: %u searches found other units through the indexes\n", mismatches);
+
+    return mismatches ? 1 : 0;
+}
@@ -0,0 +1,225 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Saves a freshly created character a number of times through Player::SaveToDB and reports, per kind of
+/// save, the statements executed and the bytes sent to the database server, as counted by the server
+/// itself. The first save writes the whole character, later ones only what changed since the save before:
+/// a position for an idle autosave, or also money and experience for a character that is playing.
+///
+/// The world is loaded as mangosd does from the given configuration file. Saves are executed on this thread
+/// and the counters are global ones of the server, so the character database should not be used by anything
+/// else while the benchmark runs. The character is created on the given account, whose entered instances
+/// are overwritten by the saves, and is deleted at the end. Only MySQL exposes these counters.
+///
+/// Before the measured saves it checks that money and titles written outside of SaveToDB, as trades, mails
+/// and arena rewards do, reach the database again when they went back to the values of the last save.
+///
+/// Usage: CharacterSaveBench <mangosd.conf> [saves = 100] [account = 1000000]
+
+#include "Common.h"
+#include "Log/Log.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+#include "Entities/Player.h"
+#include "Globals/ObjectMgr.h"
+#include "Server/WorldSession.h"
+#include "Anticheat/Anticheat.hpp"
+#include "BenchmarkGlobals.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+
+#if !defined(DO_POSTGRESQL) && !defined(DO_SQLITE)
+
+struct ServerCounters
+{
+    uint64 statements = 0;
+    uint64 bytes = 0;
+};
+
+static ServerCounters ReadServerCounters()
+{
+    std::map<std::string, uint64> values;
+    if (auto result = CharacterDatabase.Query("SHOW GLOBAL STATUS WHERE Variable_name IN "
+                      "('Com_stmt_execute', 'Com_insert', 'Com_update', 'Com_delete', 'Com_replace', 'Bytes_received')"))
+    {
+        do
+        {
+            Field* fields = result->Fetch();
+            values[fields[0].GetCppString()] = fields[1].GetUInt64();
+        }
+        while (result->NextRow());
+    }
+
+    ServerCounters counters;
+    counters.statements = values["Com_stmt_execute"] + values["Com_insert"] + values["Com_update"] + values["Com_delete"] + values["Com_replace"];
+    counters.bytes = values["Bytes_received"];
+    return counters;
+}
+
+struct SaveStats
+{
+    uint32 saves = 0;
+    uint64 statements = 0;
+    uint64 bytes = 0;
+};
+
+// counters of an interval without any save, reading them costs a query and its bytes
+static ServerCounters s_overhead;
+
+// async transactions are never allowed here, so a save is executed before SaveToDB returns
+static void MeasureSave(Player* player, SaveStats& stats)
+{
+    ServerCounters before = ReadServerCounters();
+    player->SaveToDB();
+    ServerCounters after = ReadServerCounters();
+
+    ++stats.saves;
+    stats.statements += after.statements - before.statements - s_overhead.statements;
+    stats.bytes += after.bytes - before.bytes - s_overhead.bytes;
+}
+
+static uint32 LoadSavedMoney(Player* player)
+{
+    auto result = CharacterDatabase.PQuery("SELECT money FROM characters WHERE guid = '%u'", player->GetGUIDLow());
+    return result ? result->Fetch()[0].GetUInt32() : 0;
+}
+
+static std::string LoadSavedTitles(Player* player)
+{
+    auto result = CharacterDatabase.PQuery("SELECT knownTitles FROM characters WHERE guid = '%u'", player->GetGUIDLow());
+    return result ? result->Fetch()[0].GetCppString() : "";
+}
+
+// values written out of band and changed back before the next save, which must not skip them as unchanged
+static bool CheckOutOfBandSaves(Player* player)
+{
+    bool ok = true;
+
+    player->ModifyMoney(100);
+    player->SaveGoldToDB();
+    player->ModifyMoney(-100);
+    player->SaveToDB();
+    if (LoadSavedMoney(player) != player->GetMoney())
+    {
+        printf("Money saved by SaveGoldToDB was kept after it went back to the value of the last save\n");
+        ok = false;
+    }
+
+    std::string const titles = LoadSavedTitles(player);
+    player->SetFlag(PLAYER__FIELD_KNOWN_TITLES, 1 << 1);
+    player->SaveTitles();
+    player->RemoveFlag(PLAYER__FIELD_KNOWN_TITLES, 1 << 1);
+    player->SaveToDB();
+    if (LoadSavedTitles(player) != titles)
+    {
+        printf("Titles saved by SaveTitles were kept after they went back to the ones of the last save\n");
+        ok = false;
+    }
+
+    return ok;
+}
+
+static void PrintStats(char const* name, SaveStats const& stats)
+{
+    if (!stats.saves)
+        return;
+
+    printf("%-20s %8u %16.1f %16.1f\n", name, stats.saves, double(stats.statements) / stats.saves, double(stats.bytes) / stats.saves);
+}
+
+#endif
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <mangosd.conf> [saves = 100] [account = 1000000]\n", argv[0]);
+        return 1;
+    }
+
+#if defined(DO_POSTGRESQL) || defined(DO_SQLITE)
+    printf("CharacterSaveBench reads the counters of a MySQL server, it is not supported by this build\n");
+    return 1;
+#else
+    uint32 const saves = argc > 2 ? uint32(atoi(argv[2])) : 100;
+    uint32 const account = argc > 3 ? uint32(atoi(argv[3])) : 1000000;
+    if (!saves || !account)
+        return 1;
+
+    if (!StartBenchmarkWorld(argv[1]))
+        return 1;
+
+    WorldSession* session = new WorldSession(account, nullptr, SEC_PLAYER, sWorld.getConfig(CONFIG_UINT32_EXPANSION), 0, LOCALE_enUS, "bench", 0, 0, false);
+    session->AssignAnticheat(std::unique_ptr<SessionAnticheatInterface>(new NullSessionAnticheat(session)));
+
+    Player* player = new Player(session);
+    if (!player->Create(sObjectMgr.GeneratePlayerLowGuid(), "Benchsave", RACE_HUMAN, CLASS_WARRIOR, GENDER_MALE, 0, 0, 0, 0, 0, 0))
+    {
+        printf("Cannot create the character\n");
+        delete player;
+        delete session;
+        return 1;
+    }
+
+    session->SetPlayer(player, player->GetGUIDLow());
+    // one level below the cap, so it still gains experience
+    player->GiveLevel(sWorld.getConfig(CONFIG_UINT32_MAX_PLAYER_LEVEL) - 1);
+
+    ServerCounters first = ReadServerCounters();
+    ServerCounters second = ReadServerCounters();
+    s_overhead.statements = second.statements - first.statements;
+    s_overhead.bytes = second.bytes - first.bytes;
+
+    SaveStats full, idle, playing;
+    MeasureSave(player, full);
+
+    bool const outOfBandSaved = CheckOutOfBandSaves(player);
+
+    for (uint32 i = 1; i < saves; ++i)
+    {
+        player->Relocate(player->GetPositionX() + 1.0f, player->GetPositionY(), player->GetPositionZ(), player->GetOrientation());
+        if (i % 2)
+        {
+            player->ModifyMoney(1);
+            player->GiveXP(1, nullptr);
+            MeasureSave(player, playing);
+        }
+        else
+            MeasureSave(player, idle);
+    }
+
+    printf("CharacterSaveBench: %u saves of a level %u character on account %u\n", saves, player->GetLevel(), account);
+    printf("%-20s %8s %16s %16s\n", "", "saves", "statements/save", "bytes/save");
+    PrintStats("first save", full);
+    PrintStats("moved", idle);
+    PrintStats("moved, money, xp", playing);
+
+    ObjectGuid guid = player->GetObjectGuid();
+    session->SetPlayer(nullptr, 0);
+    delete player;
+    delete session;
+
+    Player::DeleteFromDB(guid, account, false, true);
+
+    StopBenchmarkWorld();
+    return outOfBandSaved ? 0 : 1;
+#endif
+}
@@ -0,0 +1,76 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Loads all DBC stores from a data directory as mangosd does at startup and reports the time it took and
+/// the memory of the process before and after. DBC files are mapped into memory, so their pages are
+/// counted as file backed (RssFile) and shared with other processes loading the same files, while data
+/// converted from them is private (RssAnon). Memory is only reported on Linux.
+///
+/// Usage: DBCLoadBench <DataDir>
+
+#include "Common.h"
+#include "Server/DBCStores.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static void PrintMemory(char const* when)
+{
+    std::ifstream status("/proc/self/status");
+    if (!status)
+        return;
+
+    printf("%s:", when);
+    std::string line;
+    while (std::getline(status, line))
+    {
+        std::istringstream in(line);
+        std::string key;
+        uint64 kilobytes;
+        if ((in >> key >> kilobytes) && (key == "VmRSS:" || key == "RssAnon:" || key == "RssFile:"))
+            printf(" %s %8.1f MB", key.c_str(), kilobytes / 1024.0);
+    }
+    printf("\n");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        printf("Usage: %s <DataDir>\n", argv[0]);
+        return 1;
+    }
+
+    std::string dataPath = argv[1];
+    if (!dataPath.empty() && dataPath.back() != '/' && dataPath.back() != '\\')
+        dataPath.push_back('/');
+
+    PrintMemory("before");
+
+    auto start = std::chrono::steady_clock::now();
+    LoadDBCStores(dataPath);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    printf("DBCLoadBench: loaded DBC stores from %s in %.1f ms\n", dataPath.c_str(), elapsed / 1000.0);
+    PrintMemory("after");
+    return 0;
+}
@@ -0,0 +1,306 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Runs Map::Update of a single map for a fixed number of ticks with a fixed diff, without network and
+/// without a world thread, and reports percentiles of the tick time, of the updated objects and of the
+/// update data built for clients.
+///
+/// The world is loaded as mangosd does from the given configuration file: extracted maps, vmaps and mmaps
+/// from DataDir and the databases from the *DatabaseInfo settings, which may point to SQLite files when
+/// built with SQLITE. The map is then populated from a spawn file, see MapTickBench.spawns. Players are
+/// socketless sessions walking on circles, creatures wander around their spawn point with their own AI.
+/// All random rolls of the benchmark and of the tick thread use the seed of the spawn file. For results
+/// comparable between runs set MapUpdate.Threads = 0, so the whole tick runs on this thread.
+///
+/// Usage: MapTickBench <mangosd.conf> <spawn file> [ticks = 1000] [diff = 50]
+
+#include "Common.h"
+#include "Log/Log.h"
+#include "Database/DatabaseEnv.h"
+#include "World/World.h"
+#include "Maps/Map.h"
+#include "Maps/MapManager.h"
+#include "Entities/Creature.h"
+#include "Entities/Player.h"
+#include "Globals/ObjectMgr.h"
+#include "Globals/ObjectAccessor.h"
+#include "Server/WorldSession.h"
+#include "Anticheat/Anticheat.hpp"
+#include "MotionGenerators/MotionMaster.h"
+#include "Util/Util.h"
+#include "BenchmarkGlobals.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+struct SpawnFile
+{
+    struct CreatureGroup
+    {
+        uint32 entry;
+        uint32 count;
+        float radius;                                       // spawned within this distance of the map center
+        float wander;                                       // random movement radius around the spawn point
+    };
+
+    struct PlayerGroup
+    {
+        uint8 race;
+        uint8 class_;
+        uint32 count;
+        float radius;                                       // circles walked have a radius up to this
+    };
+
+    uint32 seed = 1;
+    uint32 mapId = 0;
+    float x = 0.0f, y = 0.0f, z = 0.0f;
+    std::vector<CreatureGroup> creatures;
+    std::vector<PlayerGroup> players;
+};
+
+static bool LoadSpawnFile(char const* fileName, SpawnFile& spawns)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        printf("Cannot open spawn file %s\n", fileName);
+        return false;
+    }
+
+    std::string line;
+    for (uint32 lineNumber = 1; std::getline(file, line); ++lineNumber)
+    {
+        line = line.substr(0, line.find('#'));
+        std::istringstream in(line);
+        std::string keyword;
+        if (!(in >> keyword))
+            continue;
+
+        bool ok;
+        if (keyword == "seed")
+            ok = bool(in >> spawns.seed);
+        else if (keyword == "map")
+            ok = bool(in >> spawns.mapId >> spawns.x >> spawns.y >> spawns.z);
+        else if (keyword == "creatures")
+        {
+            SpawnFile::CreatureGroup group;
+            ok = bool(in >> group.entry >> group.count >> group.radius >> group.wander);
+            spawns.creatures.push_back(group);
+        }
+        else if (keyword == "players")
+        {
+            uint32 race, class_;
+            SpawnFile::PlayerGroup group;
+            ok = bool(in >> race >> class_ >> group.count >> group.radius);
+            group.race = uint8(race);
+            group.class_ = uint8(class_);
+            spawns.players.push_back(group);
+        }
+        else
+            ok = false;
+
+        if (!ok)
+        {
+            printf("%s:%u: cannot parse '%s'\n", fileName, lineNumber, line.c_str());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+struct BenchPlayer
+{
+    Player* player;
+    float centerX, centerY;
+    float radius;
+    float angle;
+    float angularSpeed;                                     // radians per millisecond
+};
+
+static Player* SpawnPlayer(Map* map, SpawnFile::PlayerGroup const& group, uint32 index, float x, float y, float z)
+{
+    WorldSession* session = new WorldSession(index + 1, nullptr, SEC_PLAYER, sWorld.getConfig(CONFIG_UINT32_EXPANSION), 0, LOCALE_enUS, "bench", 0, 0, false);
+    session->AssignAnticheat(std::unique_ptr<SessionAnticheatInterface>(new NullSessionAnticheat(session)));
+
+    Player* player = new Player(session);
+    std::string name = "Bench" + std::to_string(index);
+    if (!player->Create(sObjectMgr.GeneratePlayerLowGuid(), name, group.race, group.class_, GENDER_MALE, 0, 0, 0, 0, 0, 0))
+    {
+        printf("Cannot create player of race %u class %u\n", uint32(group.race), uint32(group.class_));
+        delete player;
+        delete session;
+        return nullptr;
+    }
+
+    session->SetPlayer(player, player->GetGUIDLow());
+    player->Relocate(x, y, z, 0.0f);
+    player->SetMap(map);
+    map->Add(player);
+    sObjectAccessor.AddObject(player);
+    return player;
+}
+
+static Creature* SpawnCreature(Map* map, SpawnFile::CreatureGroup const& group, float x, float y, float z, float ori)
+{
+    TempSpawnSettings settings(nullptr, group.entry, x, y, z, ori, TEMPSPAWN_MANUAL_DESPAWN, 0);
+    Creature* creature = WorldObject::SummonCreature(settings, map, PHASEMASK_NORMAL);
+    if (creature && group.wander > 0.0f)
+        creature->GetMotionMaster()->MoveRandomAroundPoint(x, y, z, group.wander);
+    return creature;
+}
+
+template <class T>
+static void PrintPercentiles(char const* name, std::vector<T> values)
+{
+    std::sort(values.begin(), values.end());
+    auto at = [&values](double fraction) { return double(values[std::min(values.size() - 1, size_t(fraction * values.size()))]); };
+
+    double sum = 0.0;
+    for (T value : values)
+        sum += double(value);
+
+    printf("%-20s %12.1f %12.1f %12.1f %12.1f %12.1f\n", name, sum / values.size(), at(0.50), at(0.90), at(0.99), double(values.back()));
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s <mangosd.conf> <spawn file> [ticks = 1000] [diff = 50]\n", argv[0]);
+        return 1;
+    }
+
+    uint32 const ticks = argc > 3 ? uint32(atoi(argv[3])) : 1000;
+    uint32 const diff = argc > 4 ? uint32(atoi(argv[4])) : 50;
+    if (!ticks || !diff)
+        return 1;
+
+    SpawnFile spawns;
+    if (!LoadSpawnFile(argv[2], spawns))
+        return 1;
+
+    if (!StartBenchmarkWorld(argv[1]))
+        return 1;
+
+    GetRandomGenerator()->seed(spawns.seed);
+    std::mt19937 rand(spawns.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    Map* map = CreateBenchmarkMap(spawns.mapId);
+    if (!map)
+        return 1;
+
+    // positions uniformly spread over a disc around the center, on the ground when terrain data is there
+    auto randomPosition = [&](float radius, float& x, float& y, float& z)
+    {
+        float distance = radius * std::sqrt(unit(rand));
+        float angle = unit(rand) * 2 * M_PI_F;
+        x = spawns.x + distance * std::cos(angle);
+        y = spawns.y + distance * std::sin(angle);
+        float ground = map->GetHeight(PHASEMASK_NORMAL, x, y, spawns.z + 50.0f);
+        z = ground > INVALID_HEIGHT ? ground : spawns.z;
+    };
+
+    std::vector<BenchPlayer> players;
+    for (auto const& group : spawns.players)
+    {
+        for (uint32 i = 0; i < group.count; ++i)
+        {
+            BenchPlayer bench;
+            bench.radius = 5.0f + (group.radius - 5.0f) * unit(rand);
+            bench.angle = unit(rand) * 2 * M_PI_F;
+            bench.angularSpeed = 0.007f / bench.radius;     // run speed, 7 yards per second
+            float centerZ;
+            randomPosition(std::max(0.0f, group.radius - bench.radius), bench.centerX, bench.centerY, centerZ);
+
+            float x = bench.centerX + bench.radius * std::cos(bench.angle);
+            float y = bench.centerY + bench.radius * std::sin(bench.angle);
+            float z = map->GetHeight(PHASEMASK_NORMAL, x, y, spawns.z + 50.0f);
+            bench.player = SpawnPlayer(map, group, uint32(players.size()), x, y, z > INVALID_HEIGHT ? z : spawns.z);
+            if (!bench.player)
+                return 1;
+
+            players.push_back(bench);
+        }
+    }
+
+    uint32 creatureCount = 0;
+    for (auto const& group : spawns.creatures)
+    {
+        for (uint32 i = 0; i < group.count; ++i)
+        {
+            float x, y, z;
+            randomPosition(group.radius, x, y, z);
+            if (SpawnCreature(map, group, x, y, z, unit(rand) * 2 * M_PI_F))
+                ++creatureCount;
+        }
+    }
+
+    printf("MapTickBench: map %u, %u players, %u creatures, %u ticks of %u ms, seed %u, %u map threads\n",
+           spawns.mapId, uint32(players.size()), creatureCount, ticks, diff, spawns.seed, sWorld.getConfig(CONFIG_UINT32_NUM_MAP_THREADS));
+
+    std::vector<uint64> tickTimes, updatedObjects, updateData;
+    tickTimes.reserve(ticks);
+    updatedObjects.reserve(ticks);
+    updateData.reserve(ticks);
+
+    for (uint32 tick = 0; tick < ticks; ++tick)
+    {
+        for (BenchPlayer& bench : players)
+        {
+            bench.angle += bench.angularSpeed * diff;
+            float x = bench.centerX + bench.radius * std::cos(bench.angle);
+            float y = bench.centerY + bench.radius * std::sin(bench.angle);
+            float z = bench.player->GetPositionZ();
+            bench.player->UpdateGroundPositionZ(x, y, z);
+            map->PlayerRelocation(bench.player, x, y, z, bench.angle + M_PI_F / 2);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        map->Update(diff);
+        tickTimes.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        updatedObjects.push_back(map->GetLastUpdatedObjectCount());
+        updateData.push_back(map->GetLastUpdateDataSize());
+    }
+
+    printf("%-20s %12s %12s %12s %12s %12s\n", "", "mean", "p50", "p90", "p99", "max");
+    PrintPercentiles("tick time (us)", tickTimes);
+    PrintPercentiles("updated objects", updatedObjects);
+    PrintPercentiles("update data (bytes)", updateData);
+
+    for (BenchPlayer& bench : players)
+    {
+        WorldSession* session = bench.player->GetSession();
+        map->Remove(bench.player, true);
+        session->SetPlayer(nullptr, 0);
+        delete session;
+    }
+
+    sMapMgr.UnloadAll();
+
+    StopBenchmarkWorld();
+    return 0;
+}
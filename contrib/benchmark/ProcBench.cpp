@@ -0,0 +1,152 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Measures the proc handling of combat events on units carrying many auras, as in a raid where every hit,
+/// spell and periodic tick goes through Unit::ProcDamageAndSpell for both sides. Two creatures of the given
+/// entry are spawned next to each other on a map, the given spells are cast on both so they carry their
+/// auras, and then melee swings, spell hits and periodic ticks between them are processed.
+///
+/// Next to the events per second, it reports how many auras each unit carries, how many of them can proc
+/// at all and so are looked at by an event, and the time the lookup took before the proc index: walking
+/// every aura holder of the unit and reading its proc flags.
+///
+/// The world is loaded as mangosd does from the given configuration file, see MapTickBench.
+///
+/// Usage: ProcBench <mangosd.conf> <mapId> <x> <y> <creature entry> <spell id>[,<spell id>...] [events = 1000000]
+
+#include "Common.h"
+#include "Log/Log.h"
+#include "Maps/Map.h"
+#include "Entities/Creature.h"
+#include "Entities/TemporarySpawn.h"
+#include "Spells/SpellAuras.h"
+#include "Spells/SpellMgr.h"
+#include "BenchmarkGlobals.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+struct CombatEvent
+{
+    char const* name;
+    uint32 procFlagsAttacker;
+    uint32 procFlagsVictim;
+    uint32 procExtra;
+};
+
+static CombatEvent const s_events[] =
+{
+    { "melee swing",   PROC_FLAG_DEAL_MELEE_SWING | PROC_FLAG_MAIN_HAND_WEAPON_SWING, PROC_FLAG_TAKE_MELEE_SWING | PROC_FLAG_TAKE_ANY_DAMAGE,   PROC_EX_NORMAL_HIT },
+    { "spell hit",     PROC_FLAG_DEAL_HARMFUL_SPELL,                                  PROC_FLAG_TAKE_HARMFUL_SPELL | PROC_FLAG_TAKE_ANY_DAMAGE, PROC_EX_NORMAL_HIT },
+    { "periodic tick", PROC_FLAG_DEAL_HARMFUL_PERIODIC,                               PROC_FLAG_TAKE_HARMFUL_PERIODIC | PROC_FLAG_TAKE_ANY_DAMAGE, PROC_EX_NORMAL_HIT },
+};
+
+// the lookup as it was done for every event before the proc index
+static uint32 ScanHolders(Unit const* unit, uint32 procFlags)
+{
+    uint32 found = 0;
+    for (auto const& itr : unit->GetSpellAuraHolderMap())
+    {
+        SpellEntry const* spellProto = itr.second->GetSpellProto();
+        if (SpellMgr::GetSpellProcFlags(spellProto, sSpellMgr.GetSpellProcEvent(spellProto->Id)) & procFlags)
+            ++found;
+    }
+    return found;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 7)
+    {
+        printf("Usage: %s <mangosd.conf> <mapId> <x> <y> <creature entry> <spell id>[,<spell id>...] [events = 1000000]\n", argv[0]);
+        return 1;
+    }
+
+    uint32 const mapId = uint32(atoi(argv[2]));
+    float const x = float(atof(argv[3]));
+    float const y = float(atof(argv[4]));
+    uint32 const entry = uint32(atoi(argv[5]));
+    uint32 const events = argc > 7 ? uint32(atoi(argv[7])) : 1000000;
+    if (!events)
+        return 1;
+
+    std::vector<uint32> spells;
+    for (char* token = strtok(argv[6], ","); token; token = strtok(nullptr, ","))
+        if (uint32 spellId = uint32(atoi(token)))
+            spells.push_back(spellId);
+
+    if (!StartBenchmarkWorld(argv[1]))
+        return 1;
+
+    Map* map = CreateBenchmarkMap(mapId);
+    if (!map)
+        return 1;
+
+    float z = map->GetHeight(PHASEMASK_NORMAL, x, y, MAX_HEIGHT);
+    if (z <= INVALID_HEIGHT)
+        z = 0.0f;
+
+    Creature* units[2];
+    for (uint32 i = 0; i < 2; ++i)
+    {
+        TempSpawnSettings settings(nullptr, entry, x + i * 2.0f, y, z, 0.0f, TEMPSPAWN_MANUAL_DESPAWN, 0);
+        units[i] = WorldObject::SummonCreature(settings, map, PHASEMASK_NORMAL);
+        if (!units[i])
+        {
+            printf("Cannot spawn creature %u on map %u\n", entry, mapId);
+            return 1;
+        }
+    }
+
+    for (Creature* unit : units)
+        for (uint32 spellId : spells)
+            unit->CastSpell(unit, spellId, TRIGGERED_OLD_TRIGGERED);
+
+    printf("ProcBench: map %u, %u spells cast, %u events of each kind\n", mapId, uint32(spells.size()), events);
+    for (Creature* unit : units)
+    {
+        uint32 procHolders = 0;
+        for (auto const& itr : unit->GetSpellAuraHolderMap())
+            if (SpellMgr::GetSpellProcFlags(itr.second->GetSpellProto(), sSpellMgr.GetSpellProcEvent(itr.second->GetId())))
+                ++procHolders;
+        printf("%s: %u auras, %u of them can proc\n", unit->GetGuidStr().c_str(), uint32(unit->GetSpellAuraHolderMap().size()), procHolders);
+    }
+
+    printf("%-16s %16s %16s %16s\n", "", "events/s", "scan events/s", "matches/event");
+    for (CombatEvent const& event : s_events)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < events; ++i)
+            Unit::ProcDamageAndSpell(ProcSystemArguments(units[0], units[1], event.procFlagsAttacker, event.procFlagsVictim, event.procExtra, 0, 0));
+        double procTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        uint64 scanned = 0;
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < events; ++i)
+            scanned += ScanHolders(units[0], event.procFlagsAttacker) + ScanHolders(units[1], event.procFlagsVictim);
+        double scanTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%-16s %16.0f %16.0f %16.2f\n", event.name, events / procTime, events / scanTime, double(scanned) / events);
+    }
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Compares building SMSG_COMPRESSED_UPDATE_OBJECT packets through UpdateData::BuildPacket with the
+/// previous path, which joined header and blocks into a temporary buffer and set up a new zlib stream
+/// for every packet.
+
+#include <zlib.h>
+
+#include "Common.h"
+#include "Entities/UpdateData.h"
+#include "Entities/UpdateFields.h"
+#include "Server/WorldPacket.h"
+#include "World/World.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+// Build a block with the layout of a creature CREATE_OBJECT2: living movement block and ~50 set unit fields
+static ByteBuffer BuildCreatureCreateBlock(std::mt19937& rand, uint32 lowGuid)
+{
+    ByteBuffer block(300);
+    block << uint8(UPDATETYPE_CREATE_OBJECT2);
+    block << ObjectGuid(HIGHGUID_UNIT, uint32(3000 + rand() % 50), lowGuid).WriteAsPacked();
+    block << uint8(3);                                      // TYPEID_UNIT
+
+    // movement block
+    block << uint16(UPDATEFLAG_LIVING | UPDATEFLAG_HAS_POSITION);
+    block << uint32(0) << uint16(0) << uint32(rand());       // movement flags, extra flags, time
+    block << float(-8900.0f + rand() % 500) << float(-100.0f + rand() % 500) << float(80.0f + rand() % 20) << float((rand() % 628) / 100.0f);
+    block << uint32(0);                                     // fall time
+    block << 2.5f << 7.0f << 4.5f << 2.5f << 4.72f << 7.0f << 4.5f << 3.14f << 3.14f;
+
+    // values block, update mask followed by the set fields
+    uint32 const maskBlocks = (UNIT_END + 31) / 32;
+    std::vector<uint32> mask(maskBlocks, 0);
+    std::vector<uint32> values;
+    for (uint32 index = 0; index < UNIT_END; ++index)
+    {
+        if (index >= OBJECT_END + 16 && rand() % 4)
+            continue;
+
+        mask[index / 32] |= 1 << (index % 32);
+        values.push_back(index < 4 ? lowGuid : uint32(rand() % 4 ? rand() % 256 : rand()));
+    }
+
+    block << uint8(maskBlocks);
+    for (uint32 maskBlock : mask)
+        block << maskBlock;
+    for (uint32 value : values)
+        block << value;
+
+    return block;
+}
+
+// Update packet building as it was done before thread local deflate streams
+static WorldPacket BuildPacketLegacy(ByteBuffer const& blocks, uint32 blockCount)
+{
+    ByteBuffer buf(4 + blocks.wpos());
+    buf << blockCount;
+    buf.append(blocks);
+
+    size_t pSize = buf.wpos();
+    uint32 destsize = compressBound(pSize);
+
+    WorldPacket packet(SMSG_COMPRESSED_UPDATE_OBJECT);
+    packet.resize(destsize + sizeof(uint32));
+    packet.put<uint32>(0, pSize);
+
+    z_stream c_stream;
+    c_stream.zalloc = (alloc_func)nullptr;
+    c_stream.zfree = (free_func)nullptr;
+    c_stream.opaque = (voidpf)nullptr;
+
+    deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    c_stream.next_out = const_cast<uint8*>(packet.contents()) + sizeof(uint32);
+    c_stream.avail_out = destsize;
+    c_stream.next_in = (Bytef*)buf.contents();
+    c_stream.avail_in = (uInt)pSize;
+    deflate(&c_stream, Z_NO_FLUSH);
+    deflate(&c_stream, Z_FINISH);
+    deflateEnd(&c_stream);
+
+    packet.resize(c_stream.total_out + sizeof(uint32));
+    return packet;
+}
+
+int main(int argc, char** argv)
+{
+    uint32 const iterations = argc > 1 ? uint32(atoi(argv[1])) : 20000;
+    uint32 const level = argc > 2 ? uint32(atoi(argv[2])) : 1;
+
+    sWorld.setConfig(CONFIG_UINT32_COMPRESSION, level);
+
+    std::mt19937 rand(12345);
+
+    printf("UpdateData compression benchmark, %u packets per run, zlib level %u\n", iterations, level);
+    printf("%-8s %-10s %-16s %-16s %-8s\n", "blocks", "raw bytes", "legacy ns/pkt", "current ns/pkt", "speedup");
+
+    for (uint32 blockCount : { 1, 4, 16, 64 })
+    {
+        UpdateData data;
+        ByteBuffer blocks;
+        for (uint32 i = 0; i < blockCount; ++i)
+        {
+            ByteBuffer block = BuildCreatureCreateBlock(rand, 10000 + i);
+            data.AddUpdateBlock(block);
+            blocks.append(block);
+        }
+
+        size_t checksum = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+            checksum += BuildPacketLegacy(blocks, blockCount).size();
+        auto legacy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+            checksum += data.BuildPacket(0).size();
+        auto current = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        printf("%-8u %-10u %-16.0f %-16.0f %-8.2f (%zu)\n", blockCount, uint32(blocks.wpos() + 4),
+               double(legacy) / iterations, double(current) / iterations, double(legacy) / double(current), checksum);
+    }
+
+    return 0;
+}
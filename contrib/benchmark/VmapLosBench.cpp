@@ -0,0 +1,202 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/// \file
+/// Replays line of sight queries against the vmaps of a data directory and reports the time per query,
+/// as Map::IsInLineOfSight would spend it in the static (vmap) part of the check. Queries are read from a
+/// file with one query per line, "mapId x1 y1 z1 x2 y2 z2" in world coordinates, for instance recorded
+/// from the positions of casters and their targets on a live server. Only the vmap tiles the queries pass
+/// through are loaded, before timing starts.
+///
+/// The number of queries in line of sight is printed too: it must not change between two builds replaying
+/// the same file, whichever way the triangles are tested.
+///
+/// With --generate, writes count queries to stdout instead, between random points of the ground within the
+/// given radius around a position of a map, at a player's eye height. They can be replayed like recorded ones.
+///
+/// Usage: VmapLosBench <DataDir> <queries file> [repeat = 10]
+///        VmapLosBench <DataDir> --generate <mapId> <x> <y> <radius> [count = 100000]
+
+#include "Common.h"
+#include "Maps/GridDefines.h"
+#include "Vmap/VMapFactory.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct LosQuery
+{
+    uint32 mapId;
+    float x1, y1, z1;
+    float x2, y2, z2;
+};
+
+static std::pair<int, int> GetTile(float x, float y)
+{
+    return { int(32 - x / SIZE_OF_GRIDS), int(32 - y / SIZE_OF_GRIDS) };
+}
+
+static bool LoadTile(VMAP::IVMapManager* vmgr, std::string const& vmapPath, uint32 mapId, std::pair<int, int> tile)
+{
+    if (tile.first < 0 || tile.second < 0 || tile.first >= MAX_NUMBER_OF_GRIDS || tile.second >= MAX_NUMBER_OF_GRIDS)
+        return false;
+
+    return vmgr->loadMap(vmapPath.c_str(), mapId, tile.first, tile.second) == VMAP::VMAP_LOAD_RESULT_OK;
+}
+
+// loads every tile a query passes through, sampled every few yards of its segment
+static void LoadTiles(VMAP::IVMapManager* vmgr, std::string const& vmapPath, std::vector<LosQuery> const& queries)
+{
+    std::set<std::pair<uint32, std::pair<int, int>>> tiles;
+    for (LosQuery const& query : queries)
+    {
+        float dx = query.x2 - query.x1;
+        float dy = query.y2 - query.y1;
+        uint32 steps = uint32(sqrt(dx * dx + dy * dy) / 8.0f) + 1;
+        for (uint32 i = 0; i <= steps; ++i)
+            tiles.insert({ query.mapId, GetTile(query.x1 + dx * i / steps, query.y1 + dy * i / steps) });
+    }
+
+    uint32 loaded = 0;
+    for (auto const& tile : tiles)
+        if (LoadTile(vmgr, vmapPath, tile.first, tile.second))
+            ++loaded;
+
+    printf("VmapLosBench: loaded %u of %u vmap tiles crossed by the queries\n", loaded, uint32(tiles.size()));
+}
+
+static int Generate(VMAP::IVMapManager* vmgr, std::string const& vmapPath, int argc, char** argv)
+{
+    if (argc < 7)
+        return 1;
+
+    uint32 mapId = uint32(atoi(argv[3]));
+    float x = float(atof(argv[4]));
+    float y = float(atof(argv[5]));
+    float radius = float(atof(argv[6]));
+    uint32 count = argc > 7 ? uint32(atoi(argv[7])) : 100000;
+
+    for (int dx = -1; dx <= 1; ++dx)
+        for (int dy = -1; dy <= 1; ++dy)
+            LoadTile(vmgr, vmapPath, mapId, GetTile(x + dx * radius, y + dy * radius));
+
+    std::mt19937 random(mapId);
+    std::uniform_real_distribution<float> offset(-radius, radius);
+    auto groundPoint = [&](float& px, float& py, float& pz)
+    {
+        for (uint32 tries = 0; tries < 100; ++tries)
+        {
+            px = x + offset(random);
+            py = y + offset(random);
+            pz = vmgr->getHeight(mapId, px, py, 10000.0f, 20000.0f);
+            if (pz > VMAP_INVALID_HEIGHT)
+            {
+                pz += 2.0f;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (uint32 i = 0; i < count; ++i)
+    {
+        LosQuery query;
+        query.mapId = mapId;
+        if (!groundPoint(query.x1, query.y1, query.z1) || !groundPoint(query.x2, query.y2, query.z2))
+        {
+            fprintf(stderr, "No vmap ground found around %f %f of map %u\n", x, y, mapId);
+            return 1;
+        }
+
+        printf("%u %f %f %f %f %f %f\n", query.mapId, query.x1, query.y1, query.z1, query.x2, query.y2, query.z2);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        printf("Usage: %s <DataDir> <queries file> [repeat = 10]\n", argv[0]);
+        printf("       %s <DataDir> --generate <mapId> <x> <y> <radius> [count = 100000]\n", argv[0]);
+        return 1;
+    }
+
+    std::string vmapPath = argv[1];
+    if (!vmapPath.empty() && vmapPath.back() != '/' && vmapPath.back() != '\\')
+        vmapPath.push_back('/');
+    vmapPath += "vmaps";
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    vmgr->setEnableLineOfSightCalc(true);
+    vmgr->setEnableHeightCalc(true);
+
+    std::vector<uint32> mapIds;
+    for (uint32 mapId = 0; mapId < 1000; ++mapId)
+        mapIds.push_back(mapId);
+    vmgr->InitializeThreadUnsafe(mapIds);
+
+    if (std::string(argv[2]) == "--generate")
+        return Generate(vmgr, vmapPath, argc, argv);
+
+    uint32 repeat = argc > 3 ? uint32(atoi(argv[3])) : 10;
+    if (!repeat)
+        return 1;
+
+    std::ifstream file(argv[2]);
+    if (!file)
+    {
+        printf("Cannot open queries file %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<LosQuery> queries;
+    LosQuery query;
+    while (file >> query.mapId >> query.x1 >> query.y1 >> query.z1 >> query.x2 >> query.y2 >> query.z2)
+        queries.push_back(query);
+
+    if (queries.empty())
+    {
+        printf("No queries in %s\n", argv[2]);
+        return 1;
+    }
+
+    LoadTiles(vmgr, vmapPath, queries);
+
+    uint32 inSight = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32 i = 0; i < repeat; ++i)
+    {
+        inSight = 0;
+        for (LosQuery const& los : queries)
+            if (vmgr->isInLineOfSight(los.mapId, los.x1, los.y1, los.z1, los.x2, los.y2, los.z2, false))
+                ++inSight;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+    printf("VmapLosBench: %u queries replayed %u times, %u in line of sight\n", uint32(queries.size()), repeat, inSight);
+    printf("%.1f ns/query\n", double(elapsed) / (double(queries.size()) * repeat));
+    return 0;
+}
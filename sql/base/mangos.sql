@@ -24,7 +24,7 @@ CREATE TABLE `db_version` (
   `version` varchar(120) DEFAULT NULL,
   `creature_ai_version` varchar(120) DEFAULT NULL,
   `cache_id` int(10) DEFAULT '0',
-  `required_14089_01_mangos_reputation_spillover` bit(1) DEFAULT NULL
+  `required_14090_02_mangos_command` bit(1) DEFAULT NULL
 ) ENGINE=MyISAM DEFAULT CHARSET=utf8 ROW_FORMAT=DYNAMIC COMMENT='Used DB version notes';
 
 --
@@ -880,8 +880,12 @@ INSERT INTO `command` VALUES
 ('server info',0,'Syntax: .server info\r\n\r\nDisplay server version and the number of connected players.'),
 ('server log filter',4,'Syntax: .server log filter [($filtername|all) (on|off)]\r\n\r\nShow or set server log filters. If used \"all\" then all filters will be set to on/off state.'),
 ('server log level',4,'Syntax: .server log level [#level]\r\n\r\nShow or set server log level (0 - errors only, 1 - basic, 2 - detail, 3 - debug).'),
+('server mapthreads',3,'Syntax: .server mapthreads\r\n\r\nShow the busy share of each map update thread over the last 10 seconds and the maps with the highest predicted update cost.'),
 ('server motd',0,'Syntax: .server motd\r\n\r\nShow server Message of the day.'),
 ('server plimit',3,'Syntax: .server plimit [#num|-1|-2|-3|reset|player|moderator|gamemaster|administrator]\r\n\r\nWithout arg show current player amount and security level limitations for login to server, with arg set player linit ($num > 0) or securiti limitation ($num < 0 or security leme name. With `reset` sets player limit to the one in the config file'),
+('server profiler dump',3,'Syntax: .server profiler dump [trace|stacks]\r\n\r\nWrite the zones recorded by the profiler to a file in LogsDir, as Chrome trace json (default) or as collapsed stacks for flamegraph.pl.'),
+('server profiler off',3,'Syntax: .server profiler off\r\n\r\nStop recording profiler zones from the next world tick on.'),
+('server profiler on',3,'Syntax: .server profiler on [#spike_ms]\r\n\r\nStart recording profiler zones from the next world tick on. With #spike_ms, a world tick lasting at least #spike_ms milliseconds writes a trace on its own, at most once a minute.'),
 ('server restart',3,'Syntax: .server restart #delay\r\n\r\nRestart the server after #delay seconds. Use #exist_code or 2 as program exist code.'),
 ('server restart cancel',3,'Syntax: .server restart cancel\r\n\r\nCancel the restart/shutdown timer if any.'),
 ('server set motd',3,'Syntax: .server set motd $MOTD\r\n\r\nSet server Message of the day.'),
@@ -0,0 +1,6 @@
+ALTER TABLE db_version CHANGE COLUMN required_14089_01_mangos_reputation_spillover required_14090_01_mangos_command bit;
+
+DELETE FROM command WHERE name = 'server mapthreads';
+
+INSERT INTO `command` VALUES
+('server mapthreads',3,'Syntax: .server mapthreads\r\n\r\nShow the busy share of each map update thread over the last 10 seconds and the maps with the highest predicted update cost.');
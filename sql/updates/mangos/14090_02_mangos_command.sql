@@ -0,0 +1,8 @@
+ALTER TABLE db_version CHANGE COLUMN required_14090_01_mangos_command required_14090_02_mangos_command bit;
+
+DELETE FROM command WHERE name IN ('server profiler dump','server profiler off','server profiler on');
+
+INSERT INTO `command` VALUES
+('server profiler dump',3,'Syntax: .server profiler dump [trace|stacks]\r\n\r\nWrite the zones recorded by the profiler to a file in LogsDir, as Chrome trace json (default) or as collapsed stacks for flamegraph.pl.'),
+('server profiler off',3,'Syntax: .server profiler off\r\n\r\nStop recording profiler zones from the next world tick on.'),
+('server profiler on',3,'Syntax: .server profiler on [#spike_ms]\r\n\r\nStart recording profiler zones from the next world tick on. With #spike_ms, a world tick lasting at least #spike_ms milliseconds writes a trace on its own, at most once a minute.');
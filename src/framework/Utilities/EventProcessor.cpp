@@ -18,9 +18,38 @@
 
 #include "EventProcessor.h"
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static uint32 LowestBit(uint32 mask)
+{
+#if defined(__GNUC__)
+    return uint32(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return uint32(index);
+#else
+    uint32 index = 0;
+    while (!(mask & 1))
+    {
+        mask >>= 1;
+        ++index;
+    }
+    return index;
+#endif
+}
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_wheelTime = 0;
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+        m_occupied[level] = 0;
+    m_ready = nullptr;
+    m_overflow = nullptr;
+    m_count = 0;
     m_aborting = false;
 }
 
@@ -35,25 +64,46 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    for (;;)
     {
-        // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
-
-        if (!Event->to_Abort)
+        while (BasicEvent* Event = m_ready)
         {
-            if (Event->Execute(m_time, p_time))
+            // get and remove event from queue
+            Unlink(Event);
+
+            if (!Event->to_Abort)
             {
-                // completely destroy event if it is not re-added
+                if (Event->Execute(m_time, p_time))
+                {
+                    // completely destroy event if it is not re-added
+                    delete Event;
+                }
+            }
+            else
+            {
+                Event->Abort(m_time);
                 delete Event;
             }
         }
-        else
+
+        // move the wheel to the next slot due, events added meanwhile are found there too
+        uint64 next = GetNextWheelTime();
+        if (!next || next > m_time)
         {
-            Event->Abort(m_time);
-            delete Event;
+            m_wheelTime = m_time;
+            break;
+        }
+
+        // spread the slot reached over the levels below, its events due now become ready
+        m_wheelTime = next;
+        if (next % WHEEL_RANGE == 0 && m_overflow)
+            Cascade(m_overflow);
+
+        for (uint32 level = WHEEL_LEVELS; level-- > 0;)
+        {
+            uint32 slot = uint32(next >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1);
+            if (m_occupied[level] & (1u << slot))
+                Cascade(m_wheel[level][slot]);
         }
     }
 }
@@ -63,39 +113,30 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
+    std::vector<BasicEvent*> events;
+    GetEvents(events);
+
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    for (BasicEvent* event : events)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
+        event->to_Abort = true;
+        event->Abort(m_time);
+        if (force || event->IsDeletable())
         {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
+            if (event->m_processor == this)
+                Unlink(event);
+            delete event;
         }
     }
-
-    // fast clear event list (in force case)
-    if (force)
-        m_events.clear();
 }
 
 void EventProcessor::KillEvent(BasicEvent* event)
 {
-    for (EventList::iterator iter = m_events.begin(); iter != m_events.end();)
-    {
-        if (iter->second == event)
-        {
-            delete iter->second;
-            iter = m_events.erase(iter);
-        }
-        else ++iter;
-    }
+    if (event->m_processor != this)
+        return;
+
+    Unlink(event);
+    delete event;
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -104,24 +145,181 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    Link(Event);
 }
 
 void EventProcessor::ModifyEventTime(BasicEvent* Event, uint64 msTime)
 {
-    for (auto itr = m_events.begin(); itr != m_events.end(); ++itr)
-    {
-        if (itr->second != Event)
-            continue;
+    if (Event->m_processor != this)
+        return;
 
-        Event->m_execTime = msTime;
-        m_events.erase(itr);
-        m_events.insert(std::pair<uint64, BasicEvent*>(msTime, Event));
-        break;
-    }
+    Unlink(Event);
+    Event->m_execTime = msTime;
+    Link(Event);
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+void EventProcessor::GetEvents(std::vector<BasicEvent*>& events) const
+{
+    events.reserve(events.size() + m_count);
+
+    auto addQueue = [&events](BasicEvent* queue)
+    {
+        if (BasicEvent* event = queue)
+        {
+            do
+            {
+                events.push_back(event);
+                event = event->m_next;
+            }
+            while (event != queue);
+        }
+    };
+
+    addQueue(m_ready);
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+        for (uint32 occupied = m_occupied[level]; occupied; occupied &= occupied - 1)
+            addQueue(m_wheel[level][LowestBit(occupied)]);
+    addQueue(m_overflow);
+}
+
+void EventProcessor::Link(BasicEvent* event)
+{
+    uint64 e_time = event->m_execTime;
+    uint64 distance = e_time ^ m_wheelTime;
+
+    if (e_time <= m_wheelTime)
+        event->m_level = LEVEL_READY;
+    else if (distance >= WHEEL_RANGE)
+        event->m_level = LEVEL_OVERFLOW;
+    else
+    {
+        // the level of the highest bits the execution time differs in from the wheel time
+        uint8 level = 0;
+        while (distance >> ((level + 1) * WHEEL_BITS))
+            ++level;
+
+        if (!m_wheel[level])
+            m_wheel[level].reset(new BasicEvent*[WHEEL_SLOTS]());
+
+        event->m_level = level;
+        event->m_slot = uint8((e_time >> (level * WHEEL_BITS)) & (WHEEL_SLOTS - 1));
+        m_occupied[level] |= 1u << event->m_slot;
+    }
+
+    BasicEvent*& queue = GetQueue(event->m_level, event->m_slot);
+    if (!queue)
+    {
+        event->m_prev = event;
+        event->m_next = event;
+        queue = event;
+    }
+    else
+    {
+        // queues are circular, the last event precedes the first one
+        BasicEvent* prev = queue->m_prev;
+        bool first = false;
+
+        // ready events may be added due before others already waiting, they stay sorted
+        if (event->m_level == LEVEL_READY)
+        {
+            while (prev->m_execTime > e_time)
+            {
+                if (prev == queue)
+                {
+                    prev = queue->m_prev;
+                    first = true;
+                    break;
+                }
+                prev = prev->m_prev;
+            }
+        }
+
+        event->m_prev = prev;
+        event->m_next = prev->m_next;
+        prev->m_next->m_prev = event;
+        prev->m_next = event;
+        if (first)
+            queue = event;
+    }
+
+    event->m_processor = this;
+    ++m_count;
+}
+
+void EventProcessor::Unlink(BasicEvent* event)
+{
+    BasicEvent*& queue = GetQueue(event->m_level, event->m_slot);
+    if (event->m_next == event)
+    {
+        queue = nullptr;
+        if (event->m_level < WHEEL_LEVELS)
+            m_occupied[event->m_level] &= ~(1u << event->m_slot);
+    }
+    else
+    {
+        event->m_prev->m_next = event->m_next;
+        event->m_next->m_prev = event->m_prev;
+        if (queue == event)
+            queue = event->m_next;
+    }
+
+    event->m_prev = nullptr;
+    event->m_next = nullptr;
+    event->m_processor = nullptr;
+    --m_count;
+}
+
+BasicEvent*& EventProcessor::GetQueue(uint8 level, uint8 slot)
+{
+    switch (level)
+    {
+        case LEVEL_READY:    return m_ready;
+        case LEVEL_OVERFLOW: return m_overflow;
+        default:             return m_wheel[level][slot];
+    }
+}
+
+uint64 EventProcessor::GetNextWheelTime() const
+{
+    // slots after the current one of a level are all due before any later slot of the levels above
+    for (uint32 level = 0; level < WHEEL_LEVELS; ++level)
+    {
+        uint32 shift = level * WHEEL_BITS;
+        uint32 current = uint32(m_wheelTime >> shift) & (WHEEL_SLOTS - 1);
+        uint32 later = m_occupied[level] & ~((2u << current) - 1);
+        if (later)
+        {
+            uint64 block = uint64(WHEEL_SLOTS) << shift;
+            return (m_wheelTime & ~(block - 1)) | (uint64(LowestBit(later)) << shift);
+        }
+    }
+
+    if (m_overflow)
+        return (m_wheelTime | (WHEEL_RANGE - 1)) + 1;
+
+    return 0;
+}
+
+void EventProcessor::Cascade(BasicEvent*& queue)
+{
+    // detach the whole queue first, events of the overflow may be linked back to it
+    BasicEvent* event = queue;
+    event->m_prev->m_next = nullptr;
+    if (event->m_level < WHEEL_LEVELS)
+        m_occupied[event->m_level] &= ~(1u << event->m_slot);
+    queue = nullptr;
+
+    // in the order they were added, lower levels and the ready queue keep it
+    while (event)
+    {
+        BasicEvent* next = event->m_next;
+        --m_count;
+        Link(event);
+        event = next;
+    }
+}
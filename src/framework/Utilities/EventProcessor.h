@@ -21,16 +21,21 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <memory>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
+class EventProcessor;
+
 class BasicEvent
 {
+        friend class EventProcessor;
+
     public:
 
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_addTime(0), m_execTime(0), m_prev(nullptr), m_next(nullptr), m_processor(nullptr), m_level(0), m_slot(0)
         {
         }
 
@@ -53,10 +58,22 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
-};
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+    private:
 
+        // links of the queue the event waits in, filled by event handler
+        BasicEvent* m_prev;
+        BasicEvent* m_next;
+        EventProcessor* m_processor;                        // null while not queued
+        uint8 m_level;
+        uint8 m_slot;
+};
+
+// Events are kept in a hierarchical timer wheel: each level has WHEEL_SLOTS slots, a slot of level n holding the
+// events due within one block of WHEEL_SLOTS^n milliseconds. When the time reaches a block, its slot is spread
+// over the levels below, so adding, killing or moving an event only links or unlinks it, and an update walks the
+// occupied slots only. Queues are intrusive lists through the events themselves, no node is allocated.
+// Events run in the order of their execution time, then in the order they were added.
 class EventProcessor
 {
     public:
@@ -70,13 +87,31 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         void ModifyEventTime(BasicEvent* event, uint64 msTime);
         uint64 CalculateTime(uint64 t_offset) const;
-        EventList& GetEvents() { return m_events; }
-        bool IsEmpty() const { return m_events.empty(); }
+        void GetEvents(std::vector<BasicEvent*>& events) const; // queued events, in no particular order
+        bool IsEmpty() const { return m_count == 0; }
 
     protected:
 
+        static uint32 const WHEEL_BITS = 5;
+        static uint32 const WHEEL_SLOTS = 1 << WHEEL_BITS;
+        static uint32 const WHEEL_LEVELS = 6;
+        static uint64 const WHEEL_RANGE = uint64(1) << (WHEEL_BITS * WHEEL_LEVELS); // about 12 days, later events wait in an overflow queue
+        static uint8 const LEVEL_READY = WHEEL_LEVELS;
+        static uint8 const LEVEL_OVERFLOW = WHEEL_LEVELS + 1;
+
+        void Link(BasicEvent* event);
+        void Unlink(BasicEvent* event);
+        BasicEvent*& GetQueue(uint8 level, uint8 slot);
+        uint64 GetNextWheelTime() const;
+        void Cascade(BasicEvent*& queue);
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_wheelTime;                                 // events due until this time have left the wheel for the ready queue
+        std::unique_ptr<BasicEvent*[]> m_wheel[WHEEL_LEVELS]; // slots of each level, allocated at first use
+        uint32 m_occupied[WHEEL_LEVELS];                    // bit per non empty slot
+        BasicEvent* m_ready;                                // due events, by execution time
+        BasicEvent* m_overflow;
+        uint32 m_count;
         bool m_aborting;
 };
 
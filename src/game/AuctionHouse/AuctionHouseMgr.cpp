@@ -557,6 +557,23 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
     return sAuctionHouseStore.LookupEntry(houseid);
 }
 
+AuctionHouseMgr::ItemName const& AuctionHouseMgr::GetItemName(ItemPrototype const* proto, int32 locIdx)
+{
+    uint64 key = (uint64(proto->ItemId) << 8) | uint8(locIdx + 1);
+    std::unordered_map<uint64, ItemName>::const_iterator itr = mItemNames.find(key);
+    if (itr != mItemNames.end())
+        return itr->second;
+
+    ItemName& itemName = mItemNames[key];
+    std::string name = proto->Name1;
+    sObjectMgr.GetItemLocaleStrings(proto->ItemId, locIdx, &name);
+
+    itemName.valid = Utf8toWStr(name, itemName.name);
+    itemName.lowerName = itemName.name;
+    wstrToLower(itemName.lowerName);
+    return itemName;
+}
+
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
@@ -571,6 +588,7 @@ void AuctionHouseObject::Update()
 
                 itr->second->DeleteFromDB();
                 MANGOS_ASSERT(!itr->second->itemGuidLow);   // already removed or send in mail at won
+                RemoveFromSearchIndex(itr->second);
                 delete itr->second;
                 AuctionsMap.erase(itr++);
                 continue;
@@ -589,6 +607,7 @@ void AuctionHouseObject::Update()
                     sAuctionMgr.SendAuctionExpiredMail(itr->second);
 
                     itr->second->DeleteFromDB();
+                    RemoveFromSearchIndex(itr->second);
                     delete itr->second;
                     AuctionsMap.erase(itr++);
                     continue;
@@ -709,15 +728,8 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
 
             int32 loc_idx = viewPlayer->GetSession()->GetSessionDbLocaleIndex();
 
-            std::string name1 = itemProto1->Name1;
-            sObjectMgr.GetItemLocaleStrings(itemProto1->ItemId, loc_idx, &name1);
-
-            std::string name2 = itemProto2->Name1;
-            sObjectMgr.GetItemLocaleStrings(itemProto2->ItemId, loc_idx, &name2);
-
-            std::wstring wname1, wname2;
-            Utf8toWStr(name1, wname1);
-            Utf8toWStr(name2, wname2);
+            std::wstring const& wname1 = sAuctionMgr.GetItemName(itemProto1, loc_idx).name;
+            std::wstring const& wname2 = sAuctionMgr.GetItemName(itemProto2, loc_idx).name;
             return wname1.compare(wname2);
         }
         case 6:                                             // minbidbuyout = 6
@@ -781,13 +793,10 @@ int AuctionEntry::CompareAuctionEntry(uint32 column, const AuctionEntry* auc, Pl
 
 bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc2) const
 {
-    if (m_sort[0] == MAX_AUCTION_SORT)                      // not sorted
-        return false;
-
     for (uint32 i = 0; i < MAX_AUCTION_SORT; ++i)
     {
         if (m_sort[i] == MAX_AUCTION_SORT)                  // end of sort
-            return false;
+            break;
 
         int res = auc1->CompareAuctionEntry(m_sort[i] & ~AUCTION_SORT_REVERSED, auc2, m_viewPlayer);
         // "equal" by used column
@@ -797,86 +806,174 @@ bool AuctionSorter::operator()(const AuctionEntry* auc1, const AuctionEntry* auc
         return (res < 0) == ((m_sort[i] & AUCTION_SORT_REVERSED) == 0);
     }
 
-    return false;                                           // "equal" by all sorts
+    return auc1->Id < auc2->Id;                             // "equal" by all sorts
 }
 
-void WorldSession::BuildListAuctionItems(std::vector<AuctionEntry*> const& auctions, WorldPacket& data, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin,
-        uint32 levelmax, uint32 usable, uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint32& count, uint32& totalcount, bool isFull) const
+void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player, std::wstring const& wsearchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
+        uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint8* sort, uint32& count, uint32& totalcount, bool isFull) const
 {
-    int loc_idx = _player->GetSession()->GetSessionDbLocaleIndex();
+    int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
 
-    for (auto Aentry : auctions)
-    {
-        if (Aentry->moneyDeliveryTime)
-            continue;
-        Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (!item)
-            continue;
+    std::vector<AuctionEntry*> auctions;
 
-        if (isFull)
+    if (isFull)
+    {
+        auctions.reserve(AuctionsMap.size());
+        for (auto const& itr : AuctionsMap)
+            if (!itr.second->moneyDeliveryTime && sAuctionMgr.GetAItem(itr.second->itemGuidLow))
+                auctions.push_back(itr.second);
+    }
+    else
+    {
+        // the class, and the subclass within it, are leading parts of the key
+        uint64 first = 0;
+        uint64 last = UINT64_MAX;
+        // no item has such a class, the index is not walked
+        bool const anyClass = (itemClass == 0xffffffff || itemClass <= 0xffff) && (itemSubClass == 0xffffffff || itemSubClass <= 0xffff);
+        if (itemClass != 0xffffffff)
         {
-            ++count;
-            Aentry->BuildAuctionInfo(data);
+            first = uint64(itemClass) << 48;
+            last = first | ((uint64(1) << 48) - 1);
+            if (itemSubClass != 0xffffffff)
+            {
+                first |= uint64(itemSubClass) << 32;
+                last = first | ((uint64(1) << 32) - 1);
+            }
         }
-        else
+
+        for (SearchIndex::const_iterator bucket = m_searchIndex.lower_bound(first); anyClass && bucket != m_searchIndex.end() && bucket->first <= last; ++bucket)
         {
-            ItemPrototype const* proto = item->GetProto();
+            uint32 bucketSubClass = uint32(bucket->first >> 32) & 0xffff;
+            uint32 bucketInventoryType = uint32(bucket->first >> 16) & 0xffff;
+            uint32 bucketQuality = uint32(bucket->first) & 0xffff;
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
+            if (itemSubClass != 0xffffffff && bucketSubClass != itemSubClass)
                 continue;
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+            // if inventory type is chest, we want to return robes too
+            // i.e. cloth chests are in most cases robes by definition
+            if (inventoryType != 0xffffffff && bucketInventoryType != inventoryType && (inventoryType != INVTYPE_CHEST || bucketInventoryType != INVTYPE_ROBE))
                 continue;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-            {
-                if (inventoryType != INVTYPE_CHEST || proto->InventoryType != INVTYPE_ROBE)
-                {
-                    // if inventory type is chest, we want to return robes too
-                    // i.e. cloth chests are in most cases robes by definition
-
-                    continue;
-                }
-            }
-
-            if (quality != 0xffffffff && proto->Quality < quality)
+            if (quality != 0xffffffff && bucketQuality < quality)
                 continue;
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+            SearchIndexBucket::const_iterator itr = bucket->second.begin();
+            SearchIndexBucket::const_iterator end = bucket->second.end();
+            if (levelmin != 0x00)
+            {
+                itr = std::lower_bound(itr, end, levelmin, [](SearchIndexEntry const& entry, uint32 level) { return entry.requiredLevel < level; });
+                if (levelmax != 0x00)
+                    end = std::upper_bound(itr, end, levelmax, [](uint32 level, SearchIndexEntry const& entry) { return level < entry.requiredLevel; });
+            }
 
-            if (usable != 0x00)
+            for (; itr != end; ++itr)
             {
-                if (_player->CanUseItem(item) != EQUIP_ERR_OK)
+                AuctionEntry* Aentry = itr->auction;
+                if (Aentry->moneyDeliveryTime)
+                    continue;
+                Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
+                if (!item)
                     continue;
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
+                ItemPrototype const* proto = item->GetProto();
+
+                if (usable != 0x00)
                 {
-                    if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
+                    if (player->CanUseItem(item) != EQUIP_ERR_OK)
+                        continue;
+
+                    if (proto->Class == ITEM_CLASS_RECIPE)
                     {
-                        if (_player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                            continue;
+                        if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
+                        {
+                            if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                                continue;
+                        }
                     }
                 }
-            }
-
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+                if (!wsearchedname.empty())
+                {
+                    AuctionHouseMgr::ItemName const& name = sAuctionMgr.GetItemName(proto, loc_idx);
+                    if (!name.valid || name.lowerName.find(wsearchedname) == std::wstring::npos)
+                        continue;
+                }
 
-            if (count < MAX_AUCTION_ITEMS_CLIENT_UI_PAGE && totalcount >= listfrom)
-            {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
+                auctions.push_back(Aentry);
             }
         }
+    }
+
+    // a full list sends every auction, its total is their count just like the one of a page is the count of all matches
+    totalcount = auctions.size();
+
+    // only the page sent needs to be in order
+    AuctionSorter sorter(sort, player);
+    if (isFull)
+    {
+        std::sort(auctions.begin(), auctions.end(), sorter);
+        for (AuctionEntry* Aentry : auctions)
+            Aentry->BuildAuctionInfo(data);
+        count = totalcount;
+        return;
+    }
 
-        ++totalcount;
+    if (listfrom >= auctions.size())
+        return;
+
+    std::vector<AuctionEntry*>::iterator pageBegin = auctions.begin() + listfrom;
+    std::vector<AuctionEntry*>::iterator pageEnd = auctions.begin() + std::min<size_t>(auctions.size(), listfrom + MAX_AUCTION_ITEMS_CLIENT_UI_PAGE);
+    if (listfrom)
+        std::nth_element(auctions.begin(), pageBegin, auctions.end(), sorter);
+    std::partial_sort(pageBegin, pageEnd, auctions.end(), sorter);
+
+    for (std::vector<AuctionEntry*>::iterator itr = pageBegin; itr != pageEnd; ++itr)
+    {
+        ++count;
+        (*itr)->BuildAuctionInfo(data);
     }
 }
 
+// class, subclass, inventory type and quality, 16 bits each from the highest ones
+static uint64 GetSearchIndexKey(ItemPrototype const* proto)
+{
+    return (uint64(proto->Class & 0xffff) << 48) | (uint64(proto->SubClass & 0xffff) << 32) | (uint64(proto->InventoryType & 0xffff) << 16) | uint64(proto->Quality & 0xffff);
+}
+
+void AuctionHouseObject::AddToSearchIndex(AuctionEntry* auction)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return;
+
+    uint64 key = GetSearchIndexKey(proto);
+    SearchIndexEntry entry = { proto->RequiredLevel, auction->Id, auction };
+
+    SearchIndexBucket& bucket = m_searchIndex[key];
+    bucket.insert(std::upper_bound(bucket.begin(), bucket.end(), entry), entry);
+}
+
+void AuctionHouseObject::RemoveFromSearchIndex(AuctionEntry* auction)
+{
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return;
+
+    uint64 key = GetSearchIndexKey(proto);
+    SearchIndex::iterator bucket = m_searchIndex.find(key);
+    if (bucket == m_searchIndex.end())
+        return;
+
+    SearchIndexEntry const entry = { proto->RequiredLevel, auction->Id, auction };
+    SearchIndexBucket::iterator itr = std::lower_bound(bucket->second.begin(), bucket->second.end(), entry);
+    if (itr != bucket->second.end() && itr->auction == auction)
+        bucket->second.erase(itr);
+
+    if (bucket->second.empty())
+        m_searchIndex.erase(bucket);
+}
+
 void AuctionHouseObject::BuildListPendingSales(WorldPacket& data, Player* player, uint32& count)
 {
     for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
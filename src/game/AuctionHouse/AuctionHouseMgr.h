@@ -24,6 +24,7 @@
 
 class Item;
 class Player;
+struct ItemPrototype;
 class Unit;
 class WorldPacket;
 
@@ -110,6 +111,7 @@ class AuctionHouseObject
         {
             MANGOS_ASSERT(ah);
             AuctionsMap[ah->Id] = ah;
+            AddToSearchIndex(ah);
         }
 
         AuctionEntry* GetAuction(uint32 id) const
@@ -120,20 +122,49 @@ class AuctionHouseObject
 
         bool RemoveAuction(uint32 id)
         {
-            return AuctionsMap.erase(id) > 0;
+            AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+            if (itr == AuctionsMap.end())
+                return false;
+
+            RemoveFromSearchIndex(itr->second);
+            AuctionsMap.erase(itr);
+            return true;
         }
 
         void Update();
 
+        void BuildListAuctionItems(WorldPacket& data, Player* player, std::wstring const& searchedname, uint32 listfrom, uint32 levelmin, uint32 levelmax, uint32 usable,
+                                   uint32 inventoryType, uint32 itemClass, uint32 itemSubClass, uint32 quality, uint8* sort, uint32& count, uint32& totalcount, bool isFull) const;
         void BuildListBidderItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
         void BuildListOwnerItems(WorldPacket& data, Player* player, uint32 listfrom, uint32& count, uint32& totalcount);
         void BuildListPendingSales(WorldPacket& data, Player* player, uint32& count);
 
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
     private:
+        // auctions by the search filters of the client on their item template, so a search only walks the
+        // auctions of the categories asked for; pending and bid state is read from the auction itself
+        struct SearchIndexEntry
+        {
+            uint32 requiredLevel;
+            uint32 id;
+            AuctionEntry* auction;
+
+            bool operator<(SearchIndexEntry const& other) const
+            {
+                return requiredLevel != other.requiredLevel ? requiredLevel < other.requiredLevel : id < other.id;
+            }
+        };
+        typedef std::vector<SearchIndexEntry> SearchIndexBucket;           // by required level, then auction id
+        typedef std::map<uint64, SearchIndexBucket> SearchIndex;            // by class, subclass, inventory type, quality
+
+        void AddToSearchIndex(AuctionEntry* auction);
+        void RemoveFromSearchIndex(AuctionEntry* auction);
+
         AuctionEntryMap AuctionsMap;
+        SearchIndex m_searchIndex;
 };
 
+// orders auctions by the columns the client asked for, then by id, so every page of a search is cut from the same order
 class AuctionSorter
 {
     public:
@@ -163,6 +194,14 @@ class AuctionHouseMgr
 
         typedef std::unordered_map<uint32, Item*> ItemMap;
 
+        // name of an item template as shown to the players of a locale
+        struct ItemName
+        {
+            std::wstring name;                              // for sorting
+            std::wstring lowerName;                         // for searching, empty if the name is not valid UTF-8
+            bool valid;
+        };
+
         AuctionHouseObject* GetAuctionsMap(AuctionHouseType houseType) { return &mAuctions[houseType]; }
         AuctionHouseObject* GetAuctionsMap(AuctionHouseEntry const* house);
 
@@ -185,6 +224,10 @@ class AuctionHouseMgr
         static uint32 GetAuctionHouseTeam(AuctionHouseEntry const* house);
         static AuctionHouseEntry const* GetAuctionHouseEntry(Unit* unit);
 
+        // converted once per item template and locale, until the item locales are reloaded
+        ItemName const& GetItemName(ItemPrototype const* proto, int32 locIdx);
+        void ClearItemNames() { mItemNames.clear(); }
+
     public:
         // load first auction items, because of check if item exists, when loading
         void LoadAuctionItems();
@@ -199,6 +242,8 @@ class AuctionHouseMgr
         AuctionHouseObject  mAuctions[MAX_AUCTION_HOUSE_TYPE];
 
         ItemMap             mAitems;
+
+        std::unordered_map<uint64, ItemName> mItemNames;    // by item template and locale index + 1
 };
 
 #define sAuctionMgr MaNGOS::Singleton<AuctionHouseMgr>::Instance()
@@ -818,6 +818,14 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,          0,                  false, nullptr,                                        "", nullptr }
     };
 
+    static ChatCommand serverProfilerCommandTable[] =
+    {
+        { "dump",           SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerProfilerDumpCommand,  "", nullptr },
+        { "off",            SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerProfilerOffCommand,   "", nullptr },
+        { "on",             SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerProfilerOnCommand,    "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                        "", nullptr }
+    };
+
     static ChatCommand serverRestartCommandTable[] =
     {
         { "cancel",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerShutDownCancelCommand, "", nullptr },
@@ -853,8 +861,10 @@ ChatCommand* ChatHandler::getCommandTable()
         { "idleshutdown",   SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverIdleShutdownCommandTable },
         { "info",           SEC_PLAYER,         true,  &ChatHandler::HandleServerInfoCommand,          "", nullptr },
         { "log",            SEC_CONSOLE,        true,  nullptr,                                           "", serverLogCommandTable },
+        { "mapthreads",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerMapThreadsCommand,    "", nullptr },
         { "motd",           SEC_PLAYER,         true,  &ChatHandler::HandleServerMotdCommand,          "", nullptr },
         { "plimit",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerPLimitCommand,        "", nullptr },
+        { "profiler",       SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverProfilerCommandTable },
         { "resetallraid",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleServerResetAllRaidCommand,  "", nullptr },
         { "restart",        SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverRestartCommandTable },
         { "shutdown",       SEC_ADMINISTRATOR,  true,  nullptr,                                           "", serverShutdownCommandTable },
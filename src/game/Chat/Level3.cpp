@@ -47,6 +47,7 @@
 #include "Config/Config.h"
 #include "Mails/Mail.h"
 #include "Util/Util.h"
+#include "Util/CodeBench.h"
 #include "Entities/ItemEnchantmentMgr.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include "Maps/MapPersistentStateMgr.h"
@@ -1035,6 +1036,7 @@ bool ChatHandler::HandleReloadLocalesItemCommand(char* /*args*/)
 {
     sLog.outString("Re-Loading Locales Item ... ");
     sObjectMgr.LoadItemLocales();
+    sAuctionMgr.ClearItemNames();
     SendGlobalSysMessage("DB table `locales_item` reloaded.");
     return true;
 }
@@ -5001,6 +5003,7 @@ static bool HandleResetStatsOrLevelHelper(Player* player)
 
     player->SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, DEFAULT_WORLD_OBJECT_SIZE);
     player->SetFloatValue(UNIT_FIELD_COMBATREACH, 1.5f);
+    player->UpdateCellIndex();
 
     player->setFactionForRace(player->getRace());
 
@@ -6456,6 +6459,81 @@ bool ChatHandler::HandleServerPLimitCommand(char* args)
     return true;
 }
 
+bool ChatHandler::HandleServerMapThreadsCommand(char* /*args*/)
+{
+    MapUpdater& updater = sMapMgr.GetMapUpdater();
+    if (!updater.activated())
+    {
+        SendSysMessage("Maps are updated in the world thread (MapUpdate.Threads = 0).");
+        return true;
+    }
+
+    std::vector<float> utilisation = updater.thread_utilisation();
+    for (size_t i = 0; i < utilisation.size(); ++i)
+        PSendSysMessage("Map update thread %u: %.1f%% busy", uint32(i), utilisation[i]);
+
+    std::vector<Map*> maps;
+    for (auto& map : sMapMgr.Maps())
+        maps.push_back(map.second.get());
+
+    std::sort(maps.begin(), maps.end(), [](Map const* left, Map const* right)
+    {
+        return left->GetPredictedUpdateCost() > right->GetPredictedUpdateCost();
+    });
+
+    for (size_t i = 0; i < maps.size() && i < 5; ++i)
+        PSendSysMessage("Map %u (%s) instance %u: predicted update %u us", maps[i]->GetId(), maps[i]->GetMapName(), maps[i]->GetInstanceId(), maps[i]->GetPredictedUpdateCost());
+
+    return true;
+}
+
+bool ChatHandler::HandleServerProfilerOnCommand(char* args)
+{
+    uint32 spikeThreshold = 0;
+    if (*args && !ExtractUInt32(&args, spikeThreshold))
+        return false;
+
+    Profiler::Instance().Enable(spikeThreshold);
+
+    if (spikeThreshold)
+        PSendSysMessage("Profiler enabled from the next world tick, world ticks of %u ms or more are dumped automatically.", spikeThreshold);
+    else
+        SendSysMessage("Profiler enabled from the next world tick.");
+    return true;
+}
+
+bool ChatHandler::HandleServerProfilerOffCommand(char* /*args*/)
+{
+    Profiler::Instance().Disable();
+    SendSysMessage("Profiler disabled from the next world tick.");
+    return true;
+}
+
+bool ChatHandler::HandleServerProfilerDumpCommand(char* args)
+{
+    ProfilerDumpFormat format = PROFILER_DUMP_TRACE;
+    if (*args)
+    {
+        if (ExtractLiteralArg(&args, "trace"))
+            format = PROFILER_DUMP_TRACE;
+        else if (ExtractLiteralArg(&args, "stacks"))
+            format = PROFILER_DUMP_STACKS;
+        else
+            return false;
+    }
+
+    std::string fileName = Profiler::Instance().Dump(format);
+    if (fileName.empty())
+    {
+        SendSysMessage("Profiler dump failed, the file could not be created in LogsDir.");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Profiler data written to %s", fileName.c_str());
+    return true;
+}
+
 bool ChatHandler::HandleCastCommand(char* args)
 {
     if (!*args)
@@ -172,7 +172,7 @@ void Creature::AddToWorld()
     if (!IsInWorld())
     {
         if (GetObjectGuid().IsCreatureOrVehicle())
-            GetMap()->GetObjectsStore().insert<Creature>(GetObjectGuid(), (Creature*)this);
+            GetMap()->InsertInObjectsStore<Creature>(this);
         if (GetDbGuid())
             GetMap()->AddDbGuidObject(this);
     }
@@ -211,7 +211,7 @@ void Creature::RemoveFromWorld()
     if (IsInWorld())
     {
         if (GetObjectGuid().IsCreatureOrVehicle())
-            GetMap()->GetObjectsStore().erase<Creature>(GetObjectGuid(), (Creature*)nullptr);
+            GetMap()->EraseFromObjectsStore<Creature>(this);
         if (GetDbGuid())
             GetMap()->RemoveDbGuidObject(this);
 
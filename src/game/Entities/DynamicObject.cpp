@@ -40,7 +40,7 @@ void DynamicObject::AddToWorld()
 {
     ///- Register the dynamicObject for guid lookup
     if (!IsInWorld())
-        GetMap()->GetObjectsStore().insert<DynamicObject>(GetObjectGuid(), (DynamicObject*)this);
+        GetMap()->InsertInObjectsStore<DynamicObject>(this);
 
     WorldObject::AddToWorld();
 }
@@ -51,7 +51,7 @@ void DynamicObject::RemoveFromWorld()
     if (IsInWorld())
     {
         GetViewPoint().Event_RemovedFromWorld();
-        GetMap()->GetObjectsStore().erase<DynamicObject>(GetObjectGuid(), (DynamicObject*)nullptr);
+        GetMap()->EraseFromObjectsStore<DynamicObject>(this);
     }
 
     WorldObject::RemoveFromWorld();
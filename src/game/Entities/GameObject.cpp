@@ -123,7 +123,7 @@ void GameObject::AddToWorld()
     ///- Register the gameobject for guid lookup
     if (!IsInWorld())
     {
-        GetMap()->GetObjectsStore().insert<GameObject>(GetObjectGuid(), (GameObject*)this);
+        GetMap()->InsertInObjectsStore<GameObject>(this);
         if (GetDbGuid())
             GetMap()->AddDbGuidObject(this);
     }
@@ -171,7 +171,7 @@ void GameObject::RemoveFromWorld()
         if (m_model && GetMap()->ContainsGameObjectModel(*m_model))
             GetMap()->RemoveGameObjectModel(*m_model);
 
-        GetMap()->GetObjectsStore().erase<GameObject>(GetObjectGuid(), (GameObject*)nullptr);
+        GetMap()->EraseFromObjectsStore<GameObject>(this);
         if (GetDbGuid())
             GetMap()->RemoveDbGuidObject(this);
 
@@ -616,7 +616,7 @@ void GameObject::Update(const uint32 diff)
             switch (GetGoType())
             {
                 case GAMEOBJECT_TYPE_TRAP:
-                    if (m_events.GetEvents().size() > 0)
+                    if (!m_events.IsEmpty())
                     {
                         preventDespawn = true;
                         break;
@@ -2196,6 +2196,7 @@ void GameObject::UpdateCollisionState() const
         return;
 
     m_model->enable(IsCollisionEnabled() ? GetPhaseMask() : 0);
+    GetMap()->InvalidateGeometryQueries(*m_model);
 }
 
 void GameObject::UpdateModel()
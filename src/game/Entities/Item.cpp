@@ -1208,7 +1208,7 @@ void Item::RemoveFromClientUpdateList()
         pl->GetMap()->RemoveUpdateObject(this);
 }
 
-void Item::BuildUpdateData(UpdateDataMapType& update_players)
+void Item::BuildUpdateData(UpdateDataMapType& update_players, UpdateBlockCache& /*cache*/)
 {
     if (Player* pl = GetOwner())
         BuildUpdateDataForPlayer(pl, update_players);
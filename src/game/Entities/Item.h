@@ -384,7 +384,7 @@ class Item : public Object
 
         void AddToClientUpdateList() override;
         void RemoveFromClientUpdateList() override;
-        void BuildUpdateData(UpdateDataMapType& update_players) override;
+        void BuildUpdateData(UpdateDataMapType& update_players, UpdateBlockCache& cache) override;
         void UpdateVisibility(UpdateDataMapType& update_players) override;
 
         bool IsUsedInSpell() const { return m_usedInSpell; }
@@ -37,6 +37,7 @@
 #include "Grids/GridNotifiers.h"
 #include "Grids/GridNotifiersImpl.h"
 #include "Maps/GridDefines.h"
+#include "Maps/CellObjectIndex.h"
 #include "Maps/MapManager.h"
 #include "Maps/ObjectPosSelector.h"
 #include "Entities/TemporarySpawn.h"
@@ -139,8 +140,9 @@ void Object::SendForcedObjectUpdate()
         return;
 
     UpdateDataMapType update_players;
+    UpdateBlockCache cache;
 
-    BuildUpdateData(update_players);
+    BuildUpdateData(update_players, cache);
     RemoveFromClientUpdateList();
 
     // here we allocate a std::vector with a size of 0x10000
@@ -167,6 +169,34 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData& data, Player* target) c
     if (!target)
         return;
 
+    ByteBuffer buf(500);
+    BuildCreateUpdateBlock(buf, target, nullptr);
+    data.AddUpdateBlock(buf);
+}
+
+void Object::BuildCreateUpdateBlockForPlayer(UpdateData& data, Player* target, UpdateBlockCache& cache) const
+{
+    // self create carries private fields (and items for players), never shared
+    if (target == this || isType(TYPEMASK_ITEM))
+    {
+        BuildCreateUpdateBlockForPlayer(data, target);
+        return;
+    }
+
+    uint16 const* flags = nullptr;
+    uint32 key = (uint32(UPDATETYPE_CREATE_OBJECT) << 16) | GetUpdateFieldFlagsForTarget(target, flags);
+    UpdateBlockCache::Block* block = cache.Find(key);
+    if (!block)
+    {
+        block = &cache.Insert(key);
+        BuildCreateUpdateBlock(block->data, target, &block->targetFields);
+    }
+
+    AddCachedUpdateBlock(data, *block, target, cache);
+}
+
+void Object::BuildCreateUpdateBlock(ByteBuffer& buf, Player* target, UpdateBlockCache::TargetFields* targetFields) const
+{
     uint8  updatetype   = UPDATETYPE_CREATE_OBJECT;
     uint16 updateFlags  = m_updateFlag;
 
@@ -200,7 +230,6 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData& data, Player* target) c
 
     // DEBUG_LOG("BuildCreateUpdate: update-type: %u, object-type: %u got updateFlags: %X", updatetype, m_objectTypeId, updateFlags);
 
-    ByteBuffer buf(500);
     buf << uint8(updatetype);
     buf << GetPackGUID();
     buf << uint8(m_objectTypeId);
@@ -210,8 +239,7 @@ void Object::BuildCreateUpdateBlockForPlayer(UpdateData& data, Player* target) c
     UpdateMask updateMask;
     updateMask.SetCount(m_valuesCount);
     _SetCreateBits(updateMask, target);
-    BuildValuesUpdate(updatetype, &buf, &updateMask, target);
-    data.AddUpdateBlock(buf);
+    BuildValuesUpdate(updatetype, &buf, &updateMask, target, targetFields);
 }
 
 void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) const
@@ -224,6 +252,51 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) c
         BuildValuesUpdateBlockForPlayer(data, updateMask, target);
 }
 
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target, UpdateBlockCache& cache) const
+{
+    uint16 const* flags = nullptr;
+    uint32 key = (uint32(UPDATETYPE_VALUES) << 16) | GetUpdateFieldFlagsForTarget(target, flags);
+    UpdateBlockCache::Block* block = cache.Find(key);
+    if (!block)
+    {
+        block = &cache.Insert(key);
+
+        UpdateMask updateMask;
+        updateMask.SetCount(m_valuesCount);
+
+        _SetUpdateBits(updateMask, target);
+        if (updateMask.HasData())                           // empty block is cached too, nothing to send for this field set
+        {
+            block->data << uint8(UPDATETYPE_VALUES);
+            block->data << GetPackGUID();
+
+            BuildValuesUpdate(UPDATETYPE_VALUES, &block->data, &updateMask, target, &block->targetFields);
+        }
+    }
+
+    AddCachedUpdateBlock(data, *block, target, cache);
+}
+
+void Object::AddCachedUpdateBlock(UpdateData& data, UpdateBlockCache::Block const& block, Player* target, UpdateBlockCache& cache) const
+{
+    if (block.data.empty())
+        return;
+
+    if (block.targetFields.empty())
+    {
+        data.AddUpdateBlock(block.data);
+        return;
+    }
+
+    ByteBuffer& buf = cache.GetScratchBuffer();
+    buf.clear();
+    buf.append(block.data);
+    for (auto const& field : block.targetFields)
+        buf.put<uint32>(field.first, GetUpdateFieldValueForTarget(field.second, target));
+
+    data.AddUpdateBlock(buf);
+}
+
 void Object::BuildValuesUpdateBlockForPlayerWithFlags(UpdateData& data, Player* target, UpdateFieldFlags flags) const
 {
     UpdateMask updateMask;
@@ -480,50 +553,21 @@ void Object::BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const
     }
 }
 
-void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const
+void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target, UpdateBlockCache::TargetFields* targetFields /*= nullptr*/) const
 {
     if (!target)
         return;
 
-    bool IsActivateToQuest = false;
-    bool IsPerCasterAuraState = false;
-
-    if (updatetype == UPDATETYPE_CREATE_OBJECT || updatetype == UPDATETYPE_CREATE_OBJECT2)
+    if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsDynTransport())
     {
-        if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsDynTransport())
-        {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->IsGameMaster())
-                IsActivateToQuest = true;
-
-            updateMask->SetBit(GAMEOBJECT_DYNAMIC);
-        }
-        else if (isType(TYPEMASK_UNIT))
-        {
-            if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
-            {
-                IsPerCasterAuraState = true;
-                updateMask->SetBit(UNIT_FIELD_AURASTATE);
-            }
-        }
+        updateMask->SetBit(GAMEOBJECT_DYNAMIC);
+        if (updatetype == UPDATETYPE_VALUES)
+            updateMask->SetBit(GAMEOBJECT_BYTES_1);         // why do we need this here?
     }
-    else                                                    // case UPDATETYPE_VALUES
+    else if (isType(TYPEMASK_UNIT))
     {
-        if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsDynTransport())
-        {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->IsGameMaster())
-                IsActivateToQuest = true;
-
-            updateMask->SetBit(GAMEOBJECT_DYNAMIC);
-            updateMask->SetBit(GAMEOBJECT_BYTES_1);         // why do we need this here?
-        }
-        else if (isType(TYPEMASK_UNIT))
-        {
-            if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
-            {
-                IsPerCasterAuraState = true;
-                updateMask->SetBit(UNIT_FIELD_AURASTATE);
-            }
-        }
+        if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE))
+            updateMask->SetBit(UNIT_FIELD_AURASTATE);
     }
 
     MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
@@ -538,67 +582,12 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
         {
             if (updateMask->GetBit(index))
             {
-                if (index == UNIT_NPC_FLAGS)
+                if (IsTargetDependentUpdateField(index))
                 {
-                    uint32 appendValue = m_uint32Values[index];
-
-                    if (GetTypeId() == TYPEID_UNIT)
-                    {
-                        if (!target->canSeeSpellClickOn((Creature*)this))
-                            appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
-
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
-                        {
-                            QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-                            {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanSeeStartQuest(pQuest))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
-                            }
-
-                            bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-                            {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanRewardQuest(pQuest, false))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
-                            }
-                        }
-                    }
+                    if (targetFields)
+                        targetFields->emplace_back(uint32(data->wpos()), index);
 
-                    *data << uint32(appendValue);
-                }
-                else if (index == UNIT_FIELD_AURASTATE)
-                {
-                    if (IsPerCasterAuraState)
-                    {
-                        // IsPerCasterAuraState set if related pet caster aura state set already
-                        if (((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
-                            *data << m_uint32Values[index];
-                        else
-                            *data << (m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1)));
-                    }
-                    else
-                        *data << m_uint32Values[index];
+                    *data << GetUpdateFieldValueForTarget(index, target);
                 }
                 // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
                 else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
@@ -615,283 +604,362 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
                 {
                     *data << uint32(m_floatValues[index]);
                 }
-                else if (index == UNIT_FIELD_HEALTH || index == UNIT_FIELD_MAXHEALTH)
+                else                                        // Unhandled index, just send
                 {
-                    uint32 value = m_uint32Values[index];
-
-                    // Fog of War: replace absolute health values with percentages for non-allied units according to settings
-                    if (!static_cast<const Unit*>(this)->IsFogOfWarVisibleHealth(target) &&
-                        !target->CanSeeSpecialInfoOf(static_cast<const Unit*>(this)))
-                    {
-                        switch (index)
-                        {
-                            case UNIT_FIELD_HEALTH:     value = uint32(ceil((100.0 * value) / m_uint32Values[UNIT_FIELD_MAXHEALTH]));   break;
-                            case UNIT_FIELD_MAXHEALTH:  value = 100;                                                                    break;
-                        }
-                    }
+                    // send in current format (float as float, uint32 as uint32)
+                    *data << m_uint32Values[index];
+                }
+            }
+        }
+    }
+    else                                                    // other objects case, corpse and gameobject have one observer dependent field each
+    {
+        for (uint16 index = 0; index < m_valuesCount; ++index)
+        {
+            if (updateMask->GetBit(index))
+            {
+                if (IsTargetDependentUpdateField(index))
+                {
+                    if (targetFields)
+                        targetFields->emplace_back(uint32(data->wpos()), index);
 
-                    *data << value;
+                    *data << GetUpdateFieldValueForTarget(index, target);
                 }
-                else if (index == UNIT_FIELD_FLAGS)
+                else
                 {
-                    uint32 value = m_uint32Values[index];
+                    // send in current format (float as float, uint32 as uint32)
+                    *data << m_uint32Values[index];
+                }
+            }
+        }
+    }
+}
 
-                    // For gamemasters in GM mode:
-                    if (target->IsGameMaster())
-                    {
-                        // Gamemasters should be always able to select units - remove not selectable flag:
-                        value &= ~UNIT_FLAG_UNINTERACTIBLE;
-                    }
+bool Object::IsTargetDependentUpdateField(uint16 index) const
+{
+    if (isType(TYPEMASK_UNIT))
+    {
+        switch (index)
+        {
+            case UNIT_NPC_FLAGS:
+            case UNIT_FIELD_AURASTATE:
+            case UNIT_FIELD_HEALTH:
+            case UNIT_FIELD_MAXHEALTH:
+            case UNIT_FIELD_FLAGS:
+            case UNIT_DYNAMIC_FLAGS:
+            case UNIT_FIELD_FACTIONTEMPLATE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    if (isType(TYPEMASK_CORPSE))
+        return index == CORPSE_FIELD_BYTES_1;
+
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return index == GAMEOBJECT_DYNAMIC;
+
+    return false;
+}
+
+uint32 Object::GetUpdateFieldValueForTarget(uint16 index, Player* target) const
+{
+    if (isType(TYPEMASK_UNIT))
+    {
+        switch (index)
+        {
+            case UNIT_NPC_FLAGS:
+            {
+                uint32 appendValue = m_uint32Values[index];
 
-                    // Client bug workaround: Fix for missing chat channels when resuming taxi flight on login
-                    // Client does not send any chat joining attempts by itself when taxi flag is on
-                    if (target == this && (value & UNIT_FLAG_TAXI_FLIGHT))
+                if (GetTypeId() == TYPEID_UNIT)
+                {
+                    if (!target->canSeeSpellClickOn((Creature*)this))
+                        appendValue &= ~UNIT_NPC_FLAG_SPELLCLICK;
+
+                    if (appendValue & UNIT_NPC_FLAG_TRAINER)
                     {
-                        if (sWorld.getConfig(CONFIG_BOOL_TAXI_FLIGHT_CHAT_FIX))
-                            if (WorldSession* session = static_cast<Player const*>(this)->GetSession())
-                                if (!session->IsInitialZoneUpdated())
-                                    value &= ~UNIT_FLAG_TAXI_FLIGHT;
+                        if (!((Creature*)this)->IsTrainerOf(target, false))
+                            appendValue &= ~(UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_TRAINER_CLASS | UNIT_NPC_FLAG_TRAINER_PROFESSION);
                     }
 
-                    // On login/reconnect: delay combat state application at client UI to not interfere with secure frames init
-                    if (target == this && (value & UNIT_FLAG_IN_COMBAT))
+                    if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
                     {
-                        if (static_cast<Player const*>(this)->GetSession()->PlayerLoading())
-                            value &= ~UNIT_FLAG_IN_COMBAT;
+                        if (target->getClass() != CLASS_HUNTER)
+                            appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
                     }
 
-                    *data << value;
-                }
-                // Hide special-info for non empathy-casters,
-                // Hide lootable animation for unallowed players
-                // Handle tapped flag
-                else if (index == UNIT_DYNAMIC_FLAGS)
-                {
-                    Creature const* creature = static_cast<Creature const*>(this);
-                    uint32 dynflagsValue = m_uint32Values[index];
-                    bool setTapFlags = false;
-
-                    if (creature->IsAlive())
+                    if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
                     {
-                        // Checking SPELL_AURA_EMPATHY and caster
-                        if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
+                        QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
+                        for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
                         {
-                            bool bIsEmpathy = false;
-                            bool bIsCaster = false;
-                            Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
-                            for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
+                            Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                            if (target->CanSeeStartQuest(pQuest))
                             {
-                                bIsEmpathy = true;              // Empathy by aura set
-                                if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
-                                    bIsCaster = true;           // target is the caster of an empathy aura
+                                appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                                break;
                             }
-                            if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
-                                dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
                         }
 
-                        // creature is alive so, not lootable
-                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                        if (creature->IsInCombat())
-                        {
-                            // as creature is in combat we have to manage tap flags
-                            setTapFlags = true;
-                        }
-                        else
+                        bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
+                        for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
                         {
-                            // creature is not in combat so its not tapped
-                            dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
-                            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                            Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                            if (target->CanRewardQuest(pQuest, false))
+                            {
+                                appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                                break;
+                            }
                         }
                     }
-                    else
-                    {
-                        // check loot flag
-                        if (creature->m_loot && creature->m_loot->CanLoot(target))
-                        {
-                            // creature is dead and this player can loot it
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
-                        else
-                        {
-                            // creature is dead but this player cannot loot it
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is not lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
+                }
 
-                        // as creature is died we have to manage tap flags
-                        setTapFlags = true;
+                return appendValue;
+            }
+            case UNIT_FIELD_AURASTATE:
+            {
+                // per caster aura state is only visible to the related caster
+                if (((Unit*)this)->HasAuraState(AURA_STATE_CONFLAGRATE) && !((Unit*)this)->HasAuraStateForCaster(AURA_STATE_CONFLAGRATE, target->GetObjectGuid()))
+                    return m_uint32Values[index] & ~(1 << (AURA_STATE_CONFLAGRATE - 1));
+
+                return m_uint32Values[index];
+            }
+            case UNIT_FIELD_HEALTH:
+            case UNIT_FIELD_MAXHEALTH:
+            {
+                uint32 value = m_uint32Values[index];
+
+                // Fog of War: replace absolute health values with percentages for non-allied units according to settings
+                if (!static_cast<const Unit*>(this)->IsFogOfWarVisibleHealth(target) &&
+                    !target->CanSeeSpecialInfoOf(static_cast<const Unit*>(this)))
+                {
+                    switch (index)
+                    {
+                        case UNIT_FIELD_HEALTH:     value = uint32(ceil((100.0 * value) / m_uint32Values[UNIT_FIELD_MAXHEALTH]));   break;
+                        case UNIT_FIELD_MAXHEALTH:  value = 100;                                                                    break;
                     }
+                }
+
+                return value;
+            }
+            case UNIT_FIELD_FLAGS:
+            {
+                uint32 value = m_uint32Values[index];
+
+                // For gamemasters in GM mode:
+                if (target->IsGameMaster())
+                {
+                    // Gamemasters should be always able to select units - remove not selectable flag:
+                    value &= ~UNIT_FLAG_UNINTERACTIBLE;
+                }
+
+                // Client bug workaround: Fix for missing chat channels when resuming taxi flight on login
+                // Client does not send any chat joining attempts by itself when taxi flag is on
+                if (target == this && (value & UNIT_FLAG_TAXI_FLIGHT))
+                {
+                    if (sWorld.getConfig(CONFIG_BOOL_TAXI_FLIGHT_CHAT_FIX))
+                        if (WorldSession* session = static_cast<Player const*>(this)->GetSession())
+                            if (!session->IsInitialZoneUpdated())
+                                value &= ~UNIT_FLAG_TAXI_FLIGHT;
+                }
+
+                // On login/reconnect: delay combat state application at client UI to not interfere with secure frames init
+                if (target == this && (value & UNIT_FLAG_IN_COMBAT))
+                {
+                    if (static_cast<Player const*>(this)->GetSession()->PlayerLoading())
+                        value &= ~UNIT_FLAG_IN_COMBAT;
+                }
 
-                    // check tap flags
-                    if (setTapFlags)
+                return value;
+            }
+            // Hide special-info for non empathy-casters,
+            // Hide lootable animation for unallowed players
+            // Handle tapped flag
+            case UNIT_DYNAMIC_FLAGS:
+            {
+                Creature const* creature = static_cast<Creature const*>(this);
+                uint32 dynflagsValue = m_uint32Values[index];
+                bool setTapFlags = false;
+
+                if (creature->IsAlive())
+                {
+                    // Checking SPELL_AURA_EMPATHY and caster
+                    if (dynflagsValue & UNIT_DYNFLAG_SPECIALINFO)
                     {
-                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
-                        if (creature->IsTappedBy(target))
+                        bool bIsEmpathy = false;
+                        bool bIsCaster = false;
+                        Unit::AuraList const& mAuraEmpathy = creature->GetAurasByType(SPELL_AURA_EMPATHY);
+                        for (Unit::AuraList::const_iterator itr = mAuraEmpathy.begin(); !bIsCaster && itr != mAuraEmpathy.end(); ++itr)
                         {
-                            // creature is in combat or died and tapped by this player
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
-                        }
-                        else
-                        {
-                            // creature is in combat or died but not tapped by this player
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
-                            //sLog.outString(">> %s is not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                            bIsEmpathy = true;              // Empathy by aura set
+                            if ((*itr)->GetCasterGuid() == target->GetObjectGuid())
+                                bIsCaster = true;           // target is the caster of an empathy aura
                         }
+                        if (bIsEmpathy && !bIsCaster)       // Empathy by aura, but target is not the caster
+                            dynflagsValue &= ~UNIT_DYNFLAG_SPECIALINFO;
                     }
 
-                    if (GetTypeId() == TYPEID_UNIT || GetTypeId() == TYPEID_PLAYER)
+                    // creature is alive so, not lootable
+                    dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                    if (creature->IsInCombat())
                     {
-                        Unit const* unit = static_cast<const Unit*>(this); // hunters mark effects should only be visible to owners and not all players
-                        if (!unit->HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetObjectGuid()))
-                            dynflagsValue &= ~UNIT_DYNFLAG_TRACK_UNIT;
+                        // as creature is in combat we have to manage tap flags
+                        setTapFlags = true;
+                    }
+                    else
+                    {
+                        // creature is not in combat so its not tapped
+                        dynflagsValue = dynflagsValue & ~(UNIT_DYNFLAG_TAPPED | UNIT_DYNFLAG_TAPPED_BY_PLAYER);
+                        //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
-
-                    *data << dynflagsValue;
                 }
-                else if (index == UNIT_FIELD_FACTIONTEMPLATE)
+                else
                 {
-                    uint32 value = m_uint32Values[index];
-
-                    // [XFACTION]: Alter faction if detected crossfaction group interaction when updating faction field:
-                    if (this != target && GetTypeId() == TYPEID_PLAYER)
+                    // check loot flag
+                    if (creature->m_loot && creature->m_loot->CanLoot(target))
+                    {
+                        // creature is dead and this player can loot it
+                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
+                        //sLog.outString(">> %s is lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                    }
+                    else
                     {
-                        Player const* thisPlayer = static_cast<Player const*>(this);
+                        // creature is dead but this player cannot loot it
+                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+                        //sLog.outString(">> %s is not lootable for %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                    }
 
-                        if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && target->IsInGroup(thisPlayer))
-                        {
-                            const uint32 targetTeam = target->GetTeam();
+                    // as creature is died we have to manage tap flags
+                    setTapFlags = true;
+                }
 
-                            if (thisPlayer->GetTeam() != targetTeam && value == Player::getFactionForRace(thisPlayer->getRace()))
-                            {
-                                switch (targetTeam)
-                                {
-                                    case ALLIANCE:  value = 1054;   break;  // "Alliance Generic"
-                                    case HORDE:     value = 1495;   break;  // "Horde Generic"
-                                }
-                            }
-                        }
+                // check tap flags
+                if (setTapFlags)
+                {
+                    dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
+                    if (creature->IsTappedBy(target))
+                    {
+                        // creature is in combat or died and tapped by this player
+                        dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                        //sLog.outString(">> %s is tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
+                    }
+                    else
+                    {
+                        // creature is in combat or died but not tapped by this player
+                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED_BY_PLAYER;
+                        //sLog.outString(">> %s is not tapped by %s", this->GetGuidStr().c_str(), target->GetGuidStr().c_str());
                     }
-
-                    *data << value;
                 }
-                else                                        // Unhandled index, just send
+
+                if (GetTypeId() == TYPEID_UNIT || GetTypeId() == TYPEID_PLAYER)
                 {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
+                    Unit const* unit = static_cast<const Unit*>(this); // hunters mark effects should only be visible to owners and not all players
+                    if (!unit->HasAuraTypeWithCaster(SPELL_AURA_MOD_STALKED, target->GetObjectGuid()))
+                        dynflagsValue &= ~UNIT_DYNFLAG_TRACK_UNIT;
                 }
+
+                return dynflagsValue;
             }
-        }
-    }
-    else if (isType(TYPEMASK_CORPSE))                       // corpse case
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
-        {
-            if (updateMask->GetBit(index))
+            case UNIT_FIELD_FACTIONTEMPLATE:
             {
-                if (index == CORPSE_FIELD_BYTES_1)
+                uint32 value = m_uint32Values[index];
+
+                // [XFACTION]: Alter faction if detected crossfaction group interaction when updating faction field:
+                if (this != target && GetTypeId() == TYPEID_PLAYER)
                 {
-                    uint32 value = m_uint32Values[index];
+                    Player const* thisPlayer = static_cast<Player const*>(this);
 
-                    // [XFACTION]: Alter race field if detected crossfaction group interaction:
-                    if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP))
+                    if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP) && target->IsInGroup(thisPlayer))
                     {
-                        Corpse const* thisCorpse = static_cast<Corpse const*>(this);
-                        ObjectGuid const& ownerGuid = thisCorpse->GetOwnerGuid();
-                        Group const* targetGroup = target->GetGroup();
+                        const uint32 targetTeam = target->GetTeam();
 
-                        if (ownerGuid != target->GetObjectGuid() && targetGroup && targetGroup->IsMember(ownerGuid))
+                        if (thisPlayer->GetTeam() != targetTeam && value == Player::getFactionForRace(thisPlayer->getRace()))
                         {
-                            const uint8 targetRace = target->getRace();
-
-                            if (Player::TeamForRace(thisCorpse->getRace()) != Player::TeamForRace(targetRace))
-                                value = ((value &~ uint32(0xFF << 8)) | (uint32(targetRace) << 8));
+                            switch (targetTeam)
+                            {
+                                case ALLIANCE:  value = 1054;   break;  // "Alliance Generic"
+                                case HORDE:     value = 1495;   break;  // "Horde Generic"
+                            }
                         }
                     }
-
-                    *data << value;
                 }
-                else
-                    *data << m_uint32Values[index];         // other cases
+
+                return value;
             }
+            default:
+                break;
         }
     }
-    else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
+    else if (isType(TYPEMASK_CORPSE))
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        if (index == CORPSE_FIELD_BYTES_1)
         {
-            if (updateMask->GetBit(index))
+            uint32 value = m_uint32Values[index];
+
+            // [XFACTION]: Alter race field if detected crossfaction group interaction:
+            if (sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_GROUP))
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYNAMIC)
+                Corpse const* thisCorpse = static_cast<Corpse const*>(this);
+                ObjectGuid const& ownerGuid = thisCorpse->GetOwnerGuid();
+                Group const* targetGroup = target->GetGroup();
+
+                if (ownerGuid != target->GetObjectGuid() && targetGroup && targetGroup->IsMember(ownerGuid))
                 {
-                    // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
-                    //      most likely related to "can enter map" and then should be 0 if can not enter
+                    const uint8 targetRace = target->getRace();
 
-                    if (IsActivateToQuest)
-                    {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                                // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_CHEST:
-                                if (gameObject->GetLootState() == GO_READY || gameObject->GetLootState() == GO_ACTIVATED)
-                                    *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                else
-                                    *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                *data << uint16(-1);
-                                break;
-                            default:
-                                // unknown, not happen.
-                                *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                        }
-                    }
-                    else
-                    {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_TRANSPORT:
-                            case GAMEOBJECT_TYPE_MO_TRANSPORT:
-                                *data << m_uint32Values[index];
-                                break;
-                            default:
-                                // disable quest object
-                                *data << uint16(0);
-                                *data << uint16(-1);
-                                break;
-                        }
-                    }
+                    if (Player::TeamForRace(thisCorpse->getRace()) != Player::TeamForRace(targetRace))
+                        value = ((value &~ uint32(0xFF << 8)) | (uint32(targetRace) << 8));
                 }
-                else
-                    *data << m_uint32Values[index];         // other cases
             }
+
+            return value;
         }
     }
-    else                                                    // other objects case (no special index checks)
+    else if (isType(TYPEMASK_GAMEOBJECT))
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        // GAMEOBJECT_TYPE_DUNGEON_DIFFICULTY can have lo flag = 2
+        //      most likely related to "can enter map" and then should be 0 if can not enter
+        if (index == GAMEOBJECT_DYNAMIC)
         {
-            if (updateMask->GetBit(index))
+            GameObject const* gameObject = static_cast<GameObject const*>(this);
+
+            // hi flag is always -1, lo flag as below
+            if (!gameObject->IsDynTransport() && (gameObject->ActivateToQuest(target) || target->IsGameMaster()))
+            {
+                switch (gameObject->GetGoType())
+                {
+                    case GAMEOBJECT_TYPE_QUESTGIVER:
+                        // GO also seen with GO_DYNFLAG_LO_SPARKLE explicit, relation/reason unclear (192861)
+                        return GO_DYNFLAG_LO_ACTIVATE | 0xFFFF0000;
+                    case GAMEOBJECT_TYPE_CHEST:
+                        if (gameObject->GetLootState() == GO_READY || gameObject->GetLootState() == GO_ACTIVATED)
+                            return GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE | 0xFFFF0000;
+                        return 0xFFFF0000;
+                    case GAMEOBJECT_TYPE_GENERIC:
+                    case GAMEOBJECT_TYPE_SPELL_FOCUS:
+                    case GAMEOBJECT_TYPE_GOOBER:
+                        return GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE | 0xFFFF0000;
+                    default:
+                        // unknown, not happen.
+                        return 0xFFFF0000;
+                }
+            }
+
+            switch (gameObject->GetGoType())
             {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
+                case GAMEOBJECT_TYPE_TRANSPORT:
+                case GAMEOBJECT_TYPE_MO_TRANSPORT:
+                    return m_uint32Values[index];
+                default:
+                    // disable quest object
+                    return 0xFFFF0000;
             }
         }
     }
+
+    return m_uint32Values[index];
 }
 
 void Object::ClearUpdateMask(bool remove)
@@ -1249,7 +1317,7 @@ bool Object::PrintEntryError(char const* descr) const
     return false;
 }
 
-void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, UpdateBlockCache* cache) const
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1260,10 +1328,13 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildValuesUpdateBlockForPlayer(iter->second, iter->first);
+    if (cache)
+        BuildValuesUpdateBlockForPlayer(iter->second, iter->first, *cache);
+    else
+        BuildValuesUpdateBlockForPlayer(iter->second, iter->first);
 }
 
-void Object::BuildCreateDataForPlayer(Player* pl, UpdateDataMapType& update_players, bool auras) const
+void Object::BuildCreateDataForPlayer(Player* pl, UpdateDataMapType& update_players, bool auras, UpdateBlockCache* cache) const
 {
     UpdateDataMapType::iterator iter = update_players.find(pl);
 
@@ -1274,7 +1345,10 @@ void Object::BuildCreateDataForPlayer(Player* pl, UpdateDataMapType& update_play
         iter = p.first;
     }
 
-    BuildCreateUpdateBlockForPlayer(iter->second, iter->first);
+    if (cache)
+        BuildCreateUpdateBlockForPlayer(iter->second, iter->first, *cache);
+    else
+        BuildCreateUpdateBlockForPlayer(iter->second, iter->first);
 
     if (auras && IsUnit())
         iter->second.AddAfterCreatePacket(Player::BuildAurasForTarget(static_cast<Unit const*>(this)));
@@ -1383,7 +1457,7 @@ bool WorldObject::HasStringId(uint32 stringId) const
 WorldObject::WorldObject() :
     m_transport(nullptr), m_transportInfo(nullptr), m_isOnEventNotified(false),
     m_visibilityData(this), m_nextUpdateTime(0), m_accumulatedUpdateDiff(0), m_currMap(nullptr),
-    m_mapId(0), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL),
+    m_mapId(0), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_cellIndex(nullptr), m_cellIndexSlot(0),
     m_isActiveObject(false), m_debugFlags(0), m_destLocCounter(0), m_castCounter(0), m_inRemoveList(false)
 {
 }
@@ -1397,6 +1471,9 @@ void WorldObject::CleanupsBeforeDelete()
 WorldObject::~WorldObject()
 {
     MANGOS_ASSERT(!m_inRemoveList);
+
+    if (m_cellIndex)
+        m_cellIndex->Remove(this);
 }
 
 void WorldObject::Update(const uint32 diff)
@@ -1424,6 +1501,8 @@ void WorldObject::Relocate(float x, float y, float z, float orientation)
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, orientation);
+
+    UpdateCellIndex();
 }
 
 void WorldObject::Relocate(float x, float y, float z)
@@ -1434,6 +1513,14 @@ void WorldObject::Relocate(float x, float y, float z)
 
     if (isType(TYPEMASK_UNIT))
         m_movementInfo.ChangePosition(x, y, z, GetOrientation());
+
+    UpdateCellIndex();
+}
+
+void WorldObject::UpdateCellIndex()
+{
+    if (m_cellIndex)
+        m_cellIndex->Update(this);
 }
 
 void WorldObject::SetOrientation(float orientation)
@@ -2627,6 +2714,7 @@ void WorldObject::GetNearPointAt(const float posX, const float posY, const float
 void WorldObject::SetPhaseMask(uint32 newPhaseMask, bool update)
 {
     m_phaseMask = newPhaseMask;
+    UpdateCellIndex();
 
     if (update && IsInWorld())
         UpdateVisibilityAndView();
@@ -2741,7 +2829,7 @@ struct WorldObjectCreateAccumulator
     template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
 };
 
-void WorldObject::BuildUpdateData(UpdateDataMapType& update_players)
+void WorldObject::BuildUpdateData(UpdateDataMapType& update_players, UpdateBlockCache& cache)
 {
     if (ItsNewObject())
         GetMap()->AddCameraToWorld(this);
@@ -2749,11 +2837,13 @@ void WorldObject::BuildUpdateData(UpdateDataMapType& update_players)
     if (IsPlayer())
         BuildUpdateDataForPlayer((Player*)this, update_players);
 
+    // observers seeing the same field set share one values block, built once for this tick
+    UpdateBlockCache* sharedCache = m_clientGUIDsIAmAt.size() > 1 ? &cache : nullptr;
     for (auto& iter : m_clientGUIDsIAmAt)
     {
         if (Player* player = GetMap()->GetPlayer(iter))
             if (player != this && player->HasAtClient(this))
-                BuildUpdateDataForPlayer(player, update_players);
+                BuildUpdateDataForPlayer(player, update_players, sharedCache);
     }
 
     ClearUpdateMask(false);
@@ -3362,9 +3452,9 @@ int32 WorldObject::CalculateSpellEffectValue(Unit const* target, SpellEntry cons
 
 uint32 WorldObject::ShouldPerformObjectUpdate(uint32 const diff)
 {
-    // For objects that don't have next update time return diff immediately
+    // For objects that don't have next update time return diff immediately, with the time of ticks they were left out of
     if (!m_nextUpdateTime)
-        return diff;
+        return diff + m_accumulatedUpdateDiff;
 
     m_accumulatedUpdateDiff += diff;
 
@@ -120,6 +120,7 @@ class ChatHandler;
 struct SpellEntry;
 class Spell;
 class GenericTransport;
+class CellObjectIndex;
 
 // Spell cooldown flags sent in SMSG_SPELL_COOLDOWN
 enum SpellCooldownFlags
@@ -382,6 +383,24 @@ class WorldUpdateCounter
         uint32 m_tmStart;
 };
 
+// per map lists of objects waiting for a client update, see DirtyObjectList
+enum DirtyListType
+{
+    DIRTY_LIST_VALUES   = 0,                                // values changed
+    DIRTY_LIST_CREATE   = 1,                                // visibility update needed right away
+    DIRTY_LIST_MOVEMENT = 2,                                // visibility update needed after moving
+    MAX_DIRTY_LISTS
+};
+
+// position of an object in a dirty list, only meaningful while generation matches the one of the list
+struct DirtyListSlot
+{
+    DirtyListSlot() : generation(0), index(0) {}
+
+    uint32 generation;
+    uint32 index;
+};
+
 class Object
 {
     public:
@@ -414,16 +433,19 @@ class Object
         bool isType(TypeMask mask) const { return (mask & m_objectType) != 0; }
 
         virtual void BuildCreateUpdateBlockForPlayer(UpdateData& data, Player* target) const;
+        void BuildCreateUpdateBlockForPlayer(UpdateData& data, Player* target, UpdateBlockCache& cache) const;
 
         // must be overwrite in appropriate subclasses (WorldObject, Item currently), or will crash
         virtual void AddToClientUpdateList();
         virtual void RemoveFromClientUpdateList();
         virtual void UpdateVisibility(UpdateDataMapType& update_players) = 0;
-        virtual void BuildUpdateData(UpdateDataMapType& update_players) = 0;
+        // cache holds the blocks shared by the observers of this object, the caller clears it between objects
+        virtual void BuildUpdateData(UpdateDataMapType& update_players, UpdateBlockCache& cache) = 0;
         void MarkForClientUpdate();
         void SendForcedObjectUpdate();
 
         void BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData& data, Player* target, UpdateBlockCache& cache) const;
         void BuildValuesUpdateBlockForPlayerWithFlags(UpdateData& data, Player* target, UpdateFieldFlags flags) const;
         void BuildValuesUpdateBlockForPlayer(UpdateData& data, UpdateMask& updateMask, Player* target) const;
         void BuildForcedValuesUpdateBlockForPlayer(UpdateData& data, Player* target) const;
@@ -631,7 +653,7 @@ class Object
         MaNGOS::unique_weak_ptr<Object> GetWeakPtr() const { return m_scriptRef; }
 
         static void BuildOutOfRangeDataForPlayer(Player* pl, UpdateDataMapType& update_players, ObjectGuid oorObject);
-        void BuildCreateDataForPlayer(Player* pl, UpdateDataMapType& update_players, bool auras = true) const;
+        void BuildCreateDataForPlayer(Player* pl, UpdateDataMapType& update_players, bool auras = true, UpdateBlockCache* cache = nullptr) const;
 
     protected:
         Object();
@@ -644,8 +666,14 @@ class Object
         void _SetCreateBits(UpdateMask& updateMask, Player* target) const;
 
         void BuildMovementUpdate(ByteBuffer* data, uint16 updateFlags) const;
-        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
-        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        void BuildCreateUpdateBlock(ByteBuffer& buf, Player* target, UpdateBlockCache::TargetFields* targetFields) const;
+        void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target, UpdateBlockCache::TargetFields* targetFields = nullptr) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, UpdateBlockCache* cache = nullptr) const;
+        void AddCachedUpdateBlock(UpdateData& data, UpdateBlockCache::Block const& block, Player* target, UpdateBlockCache& cache) const;
+
+        // fields sent with a per observer value, see GetUpdateFieldValueForTarget
+        bool IsTargetDependentUpdateField(uint16 index) const;
+        uint32 GetUpdateFieldValueForTarget(uint16 index, Player* target) const;
 
         uint16 m_objectType;
 
@@ -666,9 +694,13 @@ class Object
         bool m_objectUpdated;
 
     private:
+        friend class DirtyObjectList;
+
         bool m_inWorld;
         bool m_itsNewObject;
 
+        DirtyListSlot m_dirtyListSlots[MAX_DIRTY_LISTS];
+
         PackedGuid m_PackGUID;
 
         Object(const Object&);                              // prevent generation copy constructor
@@ -1172,7 +1204,7 @@ class WorldObject : public Object
 
         void AddToClientUpdateList() override;
         void RemoveFromClientUpdateList() override;
-        void BuildUpdateData(UpdateDataMapType&) override;
+        void BuildUpdateData(UpdateDataMapType&, UpdateBlockCache& cache) override;
         void UpdateVisibility(UpdateDataMapType& update_players) override;
         
         static Creature* SummonCreature(TempSpawnSettings settings, Map* map, uint32 phaseMask);
@@ -1229,6 +1261,7 @@ class WorldObject : public Object
         virtual void UpdateNextUpdateTime() {}
         uint32 GetAccumulatedUpdateDiff() { return m_accumulatedUpdateDiff; }
         void ResetAccumulatedUpdateDiff() { m_accumulatedUpdateDiff = 0; }
+        void AddAccumulatedUpdateDiff(uint32 diff) { m_accumulatedUpdateDiff += diff; }
 
         virtual uint32 ShouldPerformObjectUpdate(uint32 const diff);
 
@@ -1240,6 +1273,12 @@ class WorldObject : public Object
         Cell const& GetCurrentCell() const { return m_currentCell; }
         void SetCurrentCell(Cell const& cell) { m_currentCell = cell; }
 
+        // entry of the object in the position index of its cell, kept by Map while the object is in a grid
+        CellObjectIndex* GetCellIndex() const { return m_cellIndex; }
+        uint32 GetCellIndexSlot() const { return m_cellIndexSlot; }
+        void SetCellIndex(CellObjectIndex* index, uint32 slot) { m_cellIndex = index; m_cellIndexSlot = slot; }
+        void UpdateCellIndex();                             // position, phase or size changed
+
         // Transports
         GenericTransport* GetTransport() const { return m_transport; }
         void SetTransport(GenericTransport* t) { m_transport = t; }
@@ -1329,6 +1368,8 @@ class WorldObject : public Object
         uint32 m_phaseMask;                                 // in area phase state
 
         Position m_position;
+        CellObjectIndex* m_cellIndex;
+        uint32 m_cellIndexSlot;
         ViewPoint m_viewPoint;
         bool m_isActiveObject;
         uint64 m_debugFlags;
@@ -46,6 +46,7 @@
 #include "Guilds/GuildMgr.h"
 #include "Entities/Pet.h"
 #include "Util/Util.h"
+#include "Util/CodeBench.h"
 #include "Entities/Transports.h"
 #include "Weather/Weather.h"
 #include "BattleGround/BattleGround.h"
@@ -690,6 +691,8 @@ Player::Player(WorldSession* session): Unit(), m_taxiTracker(*this), m_mover(thi
 
     m_grantableLevels = 0;
 
+    m_saveFailed = std::make_shared<std::atomic<bool>>(false);
+
     m_consumedMods = nullptr;
     m_modsSpell = nullptr;
 
@@ -1502,6 +1505,8 @@ void Player::Update(const uint32 diff)
     if (!IsInWorld())
         return;
 
+    PROFILE_ZONE("Player::Update");
+
     // Remove failed timed Achievements
     GetAchievementMgr().DoFailedTimedAchievementCriterias();
 
@@ -4178,14 +4183,8 @@ void Player::_LoadSpellCooldowns(std::unique_ptr<QueryResult> queryResult)
 
 void Player::_SaveSpellCooldowns()
 {
-    static SqlStatementID deleteSpellCooldown;
-
-    // delete all old cooldown
-    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
-
-    static SqlStatementID insertSpellCooldown;
-
+    // guid is left out, each row is SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId
+    SqlStmtParameters rows;
     for (auto& cdItr : m_cooldownMap)
     {
         auto& cdData = cdItr.second;
@@ -4195,19 +4194,39 @@ void Player::_SaveSpellCooldowns()
             TimePoint cTime = TimePoint::min();
             cdData->GetSpellCDExpireTime(sTime);
             cdData->GetCatCDExpireTime(cTime);
-            uint64 spellExpireTime = uint64(Clock::to_time_t(sTime));
-            uint64 catExpireTime = uint64(Clock::to_time_t(cTime));
 
-            stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId) VALUES( ?, ?, ?, ?, ?, ?)");
-            stmt.addUInt32(GetGUIDLow());
-            stmt.addUInt32(cdData->GetSpellId());
-            stmt.addUInt64(spellExpireTime);
-            stmt.addUInt32(cdData->GetCategory());
-            stmt.addUInt64(catExpireTime);
-            stmt.addUInt32(cdData->GetItemId());
-            stmt.Execute();
+            rows.addParam(SqlStmtFieldData(cdData->GetSpellId()));
+            rows.addParam(SqlStmtFieldData(uint64(Clock::to_time_t(sTime))));
+            rows.addParam(SqlStmtFieldData(cdData->GetCategory()));
+            rows.addParam(SqlStmtFieldData(uint64(Clock::to_time_t(cTime))));
+            rows.addParam(SqlStmtFieldData(cdData->GetItemId()));
         }
     }
+
+    // same cooldowns as saved last time
+    if (!m_savedSpellCooldowns.Update(rows))
+        return;
+
+    static SqlStatementID deleteSpellCooldown;
+
+    // delete all old cooldown
+    SqlStatement stmt = CharacterDatabase.CreateStatement(deleteSpellCooldown, "DELETE FROM character_spell_cooldown WHERE guid = ?");
+    stmt.PExecute(GetGUIDLow());
+
+    static SqlStatementID insertSpellCooldown;
+
+    SqlStmtParameters::ParameterContainer const& values = rows.params();
+    for (size_t i = 0; i < values.size(); i += 5)
+    {
+        stmt = CharacterDatabase.CreateStatement(insertSpellCooldown, "INSERT INTO character_spell_cooldown (guid, SpellId, SpellExpireTime, Category, CategoryExpireTime, ItemId) VALUES( ?, ?, ?, ?, ?, ?)");
+        stmt.addUInt32(GetGUIDLow());
+        stmt.addUInt32(values[i].toUint32());
+        stmt.addUInt64(values[i + 1].toUint64());
+        stmt.addUInt32(values[i + 2].toUint32());
+        stmt.addUInt64(values[i + 3].toUint64());
+        stmt.addUInt32(values[i + 4].toUint32());
+        stmt.Execute();
+    }
 }
 
 uint32 Player::resetTalentsCost() const
@@ -18255,189 +18274,226 @@ bool Player::_LoadHomeBind(std::unique_ptr<QueryResult> queryResult)
 /***                   SAVE SYSTEM                     ***/
 /*********************************************************/
 
-void Player::SaveToDB()
+void Player::_FillCharacterColumns(SqlStmtParameters (&columns)[MAX_CHARACTER_COLUMN_GROUPS])
 {
-    // we should assure this: ASSERT((m_nextSave != sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE)));
-    // delay auto save at any saves (manual, in code, or autosave)
-    m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
-
-    // lets allow only players in world to be saved
-    if (IsBeingTeleportedFar())
+    std::ostringstream ss;
+    auto addString = [&ss](SqlStmtParameters& group)
     {
-        ScheduleDelayedOperation(DELAYED_SAVE_PLAYER);
-        return;
-    }
+        group.addParam(SqlStmtFieldData(ss.str().c_str()));
+        ss.str(std::string());
+    };
 
-    // first save/honor gain after midnight will also update the player's honor fields
-    UpdateHonorFields();
+    SqlStmtParameters& profile = columns[CHARACTER_COLUMNS_PROFILE];
+    profile.addParam(SqlStmtFieldData(GetSession()->GetAccountId()));
+    profile.addParam(SqlStmtFieldData(m_name.c_str()));
+    profile.addParam(SqlStmtFieldData(getRace()));
+    profile.addParam(SqlStmtFieldData(getClass()));
+    profile.addParam(SqlStmtFieldData(getGender()));
+    profile.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_BYTES)));
+    profile.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_BYTES_2)));
+    profile.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_FLAGS)));
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
-    outDebugStatsValues();
+    ss << m_taxi;                                   // string with TaxiMaskSize numbers
+    addString(profile);
 
-    CharacterDatabase.BeginTransaction();
+    profile.addParam(SqlStmtFieldData(uint32(m_cinematic)));
+    profile.addParam(SqlStmtFieldData(uint32(m_resetTalentsCost)));
+    profile.addParam(SqlStmtFieldData(uint64(m_resetTalentsTime)));
+    profile.addParam(SqlStmtFieldData(uint32(m_ExtraFlags)));
+    profile.addParam(SqlStmtFieldData(uint32(m_stableSlots)));         // to prevent save uint8 as char
+    profile.addParam(SqlStmtFieldData(uint32(m_atLoginFlags)));
+    profile.addParam(SqlStmtFieldData(uint64(m_deathExpireTime)));
 
-    static SqlStatementID delChar ;
-    static SqlStatementID insChar ;
+    ss << m_taxiTracker.Save();
+    addString(profile);
 
-    SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
-    stmt.PExecute(GetGUIDLow());
+    profile.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_CHOSEN_TITLE)));
+    profile.addParam(SqlStmtFieldData(GetUInt64Value(PLAYER_FIELD_KNOWN_CURRENCIES)));
+    // FIXME: at this moment send to DB as unsigned, including unit32(-1)
+    profile.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX)));
+    profile.addParam(SqlStmtFieldData(uint32(m_specsCount)));
+    profile.addParam(SqlStmtFieldData(uint32(m_activeSpec)));
 
-    SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid,account,name,race,class,gender,level,xp,money,playerBytes,playerBytes2,playerFlags,"
-                              "map, dungeon_difficulty, position_x, position_y, position_z, orientation, "
-                              "taximask, online, cinematic, "
-                              "totaltime, leveltime, rest_bonus, logout_time, is_logout_resting, resettalents_cost, resettalents_time, "
-                              "trans_x, trans_y, trans_z, trans_o, transguid, extra_flags, stable_slots, at_login, zone, "
-                              "death_expire_time, taxi_path, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
-                              "todayKills, yesterdayKills, chosenTitle, knownCurrencies, watchedFaction, drunk, health, power1, power2, power3, "
-                              "power4, power5, power6, power7, specCount, activeSpec, exploredZones, equipmentCache, ammoId, knownTitles, actionBars, grantableLevels, fishingSteps) "
-                              "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
-                              "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?) ");
-
-    uberInsert.addUInt32(GetGUIDLow());
-    uberInsert.addUInt32(GetSession()->GetAccountId());
-    uberInsert.addString(m_name);
-    uberInsert.addUInt8(getRace());
-    uberInsert.addUInt8(getClass());
-    uberInsert.addUInt8(getGender());
-    uberInsert.addUInt32(GetLevel());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_XP));
-    uberInsert.addUInt32(GetMoney());
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_BYTES_2));
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FLAGS));
+    for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
+        ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
+    addString(profile);
 
+    for (uint32 i = 0; i < EQUIPMENT_SLOT_END * 2; ++i)     // string
+        ss << GetUInt32Value(PLAYER_VISIBLE_ITEM_1_ENTRYID + i) << " ";
+    // 1 in tbc - 4 in wotlk
+    for (uint32 i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_START + 1; ++i) // string: item id, ench (perm/temp)
+    {
+        ss << (m_items[i] ? m_items[i]->GetEntry() : 0) << " ";
+        ss << uint32(MAKE_PAIR32(0, 0)) << " ";
+    }
+    addString(profile);
+
+    profile.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_AMMO_ID)));
+
+    for (uint32 i = 0; i < KNOWN_TITLES_SIZE * 2; ++i)      // string
+        ss << GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i) << " ";
+    addString(profile);
+
+    profile.addParam(SqlStmtFieldData(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2))));
+    profile.addParam(SqlStmtFieldData(uint32(m_grantableLevels)));
+    profile.addParam(SqlStmtFieldData(uint8(m_fishingSteps)));
+
+    SqlStmtParameters& progress = columns[CHARACTER_COLUMNS_PROGRESS];
+    progress.addParam(SqlStmtFieldData(uint32(GetLevel())));
+    progress.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_XP)));
+    progress.addParam(SqlStmtFieldData(uint32(GetMoney())));
+    progress.addParam(SqlStmtFieldData(uint32(GetArenaPoints())));
+    progress.addParam(SqlStmtFieldData(uint32(GetHonorPoints())));
+    progress.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION)));
+    progress.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION)));
+    progress.addParam(SqlStmtFieldData(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORABLE_KILLS)));
+    progress.addParam(SqlStmtFieldData(GetUInt16Value(PLAYER_FIELD_KILLS, 0)));
+    progress.addParam(SqlStmtFieldData(GetUInt16Value(PLAYER_FIELD_KILLS, 1)));
+    progress.addParam(SqlStmtFieldData(uint8(GetDrunkValue())));
+
+    SqlStmtParameters& state = columns[CHARACTER_COLUMNS_STATE];
     if (!IsBeingTeleported())
     {
-        uberInsert.addUInt32(GetMapId());
-        uberInsert.addUInt32(uint32(GetDungeonDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetPositionX()));
-        uberInsert.addFloat(finiteAlways(GetPositionY()));
-        uberInsert.addFloat(finiteAlways(GetPositionZ()));
-        uberInsert.addFloat(finiteAlways(GetOrientation()));
+        state.addParam(SqlStmtFieldData(GetMapId()));
+        state.addParam(SqlStmtFieldData(uint32(GetDungeonDifficulty())));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetPositionX())));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetPositionY())));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetPositionZ())));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetOrientation())));
     }
     else
     {
-        uberInsert.addUInt32(GetTeleportDest().mapid);
-        uberInsert.addUInt32(uint32(GetDungeonDifficulty()));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_x));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_y));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().coord_z));
-        uberInsert.addFloat(finiteAlways(GetTeleportDest().orientation));
+        state.addParam(SqlStmtFieldData(GetTeleportDest().mapid));
+        state.addParam(SqlStmtFieldData(uint32(GetDungeonDifficulty())));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetTeleportDest().coord_x)));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetTeleportDest().coord_y)));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetTeleportDest().coord_z)));
+        state.addParam(SqlStmtFieldData(finiteAlways(GetTeleportDest().orientation)));
     }
 
-    std::ostringstream ss;
-    ss << m_taxi;                                   // string with TaxiMaskSize numbers
-    uberInsert.addString(ss);
-
-    uberInsert.addUInt32(IsInWorld() ? 1 : 0);
-
-    uberInsert.addUInt32(m_cinematic);
-
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_TOTAL]);
-    uberInsert.addUInt32(m_Played_time[PLAYED_TIME_LEVEL]);
-
-    uberInsert.addFloat(finiteAlways(m_rest_bonus));
-    uberInsert.addUInt64(uint64(time(nullptr)));
-    uberInsert.addUInt32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0);
+    state.addParam(SqlStmtFieldData(uint32(IsInWorld() ? 1 : 0)));
+    state.addParam(SqlStmtFieldData(uint32(m_Played_time[PLAYED_TIME_TOTAL])));
+    state.addParam(SqlStmtFieldData(uint32(m_Played_time[PLAYED_TIME_LEVEL])));
+    state.addParam(SqlStmtFieldData(finiteAlways(m_rest_bonus)));
+    state.addParam(SqlStmtFieldData(uint64(time(nullptr))));
     // save, far from tavern/city
     // save, but in tavern/city
-    uberInsert.addUInt32(m_resetTalentsCost);
-    uberInsert.addUInt64(uint64(m_resetTalentsTime));
+    state.addParam(SqlStmtFieldData(uint32(HasFlag(PLAYER_FLAGS, PLAYER_FLAGS_RESTING) ? 1 : 0)));
 
     Position const& transportPosition = m_movementInfo.GetTransportPos();
-    uberInsert.addFloat(finiteAlways(transportPosition.x));
-    uberInsert.addFloat(finiteAlways(transportPosition.y));
-    uberInsert.addFloat(finiteAlways(transportPosition.z));
-    uberInsert.addFloat(finiteAlways(transportPosition.o));
-
-    if (m_transport)
-        uberInsert.addUInt32(m_transport->GetGUIDLow());
-    else
-        uberInsert.addUInt32(0);
-
-    uberInsert.addUInt32(m_ExtraFlags);
-
-    uberInsert.addUInt32(uint32(m_stableSlots));            // to prevent save uint8 as char
-
-    uberInsert.addUInt32(uint32(m_atLoginFlags));
-
-    uberInsert.addUInt32(IsInWorld() ? GetZoneId() : GetCachedZoneId());
-
-    uberInsert.addUInt64(uint64(m_deathExpireTime));
-
-    ss << m_taxiTracker.Save();
-    uberInsert.addString(ss);
-
-    uberInsert.addUInt32(GetArenaPoints());
-
-    uberInsert.addUInt32(GetHonorPoints());
-
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_TODAY_CONTRIBUTION));
-
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_YESTERDAY_CONTRIBUTION));
-
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_LIFETIME_HONORABLE_KILLS));
-
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 0));
-
-    uberInsert.addUInt16(GetUInt16Value(PLAYER_FIELD_KILLS, 1));
-
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_CHOSEN_TITLE));
-
-    uberInsert.addUInt64(GetUInt64Value(PLAYER_FIELD_KNOWN_CURRENCIES));
-
-    // FIXME: at this moment send to DB as unsigned, including unit32(-1)
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_FIELD_WATCHED_FACTION_INDEX));
-
-    uberInsert.addUInt8(GetDrunkValue());
-
-    uberInsert.addUInt32(GetHealth());
-
+    state.addParam(SqlStmtFieldData(finiteAlways(transportPosition.x)));
+    state.addParam(SqlStmtFieldData(finiteAlways(transportPosition.y)));
+    state.addParam(SqlStmtFieldData(finiteAlways(transportPosition.z)));
+    state.addParam(SqlStmtFieldData(finiteAlways(transportPosition.o)));
+    state.addParam(SqlStmtFieldData(uint32(m_transport ? m_transport->GetGUIDLow() : 0)));
+    state.addParam(SqlStmtFieldData(uint32(IsInWorld() ? GetZoneId() : GetCachedZoneId())));
+    state.addParam(SqlStmtFieldData(uint32(GetHealth())));
     for (uint32 i = 0; i < MAX_POWERS; ++i)
-        uberInsert.addUInt32(GetPower(Powers(i)));
+        state.addParam(SqlStmtFieldData(uint32(GetPower(Powers(i)))));
+}
 
-    uberInsert.addUInt32(uint32(m_specsCount));
-    uberInsert.addUInt32(uint32(m_activeSpec));
+void Player::SaveToDB()
+{
+    // we should assure this: ASSERT((m_nextSave != sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE)));
+    // delay auto save at any saves (manual, in code, or autosave)
+    m_nextSave = sWorld.getConfig(CONFIG_UINT32_INTERVAL_SAVE);
 
-    for (uint32 i = 0; i < PLAYER_EXPLORED_ZONES_SIZE; ++i) // string
+    // lets allow only players in world to be saved
+    if (IsBeingTeleportedFar())
     {
-        ss << GetUInt32Value(PLAYER_EXPLORED_ZONES_1 + i) << " ";
+        ScheduleDelayedOperation(DELAYED_SAVE_PLAYER);
+        return;
     }
-    uberInsert.addString(ss);
 
-    for (uint32 i = 0; i < EQUIPMENT_SLOT_END * 2; ++i)     // string
-    {
-        ss << GetUInt32Value(PLAYER_VISIBLE_ITEM_1_ENTRYID + i) << " ";
-    }
-    // 1 in tbc - 4 in wotlk
-    for (uint32 i = INVENTORY_SLOT_BAG_START; i < INVENTORY_SLOT_BAG_START + 1; ++i) // string: item id, ench (perm/temp)
-    {
-        ss << (m_items[i] ? m_items[i]->GetEntry() : 0) << " ";
-        ss << uint32(MAKE_PAIR32(0, 0)) << " ";
-    }
-    uberInsert.addString(ss);
+    // first save/honor gain after midnight will also update the player's honor fields
+    UpdateHonorFields();
 
-    uberInsert.addUInt32(GetUInt32Value(PLAYER_AMMO_ID));
+    DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_STATS, "The value of player %s at save: ", m_name.c_str());
+    outDebugStatsValues();
 
-    for (uint32 i = 0; i < KNOWN_TITLES_SIZE * 2; ++i)      // string
+    // the saved values of a rolled back save were never written
+    if (m_saveFailed->exchange(false))
     {
-        ss << GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i) << " ";
+        for (SqlSavedValues& saved : m_savedCharacterColumns)
+            saved.Reset();
+        m_savedSpellCooldowns.Reset();
+        m_savedEnteredInstances.Reset();
     }
-    uberInsert.addString(ss);
 
-    uberInsert.addUInt32(uint32(GetByteValue(PLAYER_FIELD_BYTES, 2)));
+    CharacterDatabase.BeginTransaction();
 
-    uberInsert.addUInt32(uint32(m_grantableLevels));
+    SqlStmtParameters columns[MAX_CHARACTER_COLUMN_GROUPS];
+    _FillCharacterColumns(columns);
+
+    if (!m_savedCharacterColumns[CHARACTER_COLUMNS_STATE].IsSaved())
+    {
+        // first save of this player object, the row may not exist yet
+        static SqlStatementID delChar;
+        static SqlStatementID insChar;
+
+        SqlStatement stmt = CharacterDatabase.CreateStatement(delChar, "DELETE FROM characters WHERE guid = ?");
+        stmt.PExecute(GetGUIDLow());
+
+        SqlStatement uberInsert = CharacterDatabase.CreateStatement(insChar, "INSERT INTO characters (guid, "
+                                  "account, name, race, class, gender, playerBytes, playerBytes2, playerFlags, taximask, cinematic, "
+                                  "resettalents_cost, resettalents_time, extra_flags, stable_slots, at_login, death_expire_time, taxi_path, "
+                                  "chosenTitle, knownCurrencies, watchedFaction, specCount, activeSpec, exploredZones, equipmentCache, ammoId, "
+                                  "knownTitles, actionBars, grantableLevels, fishingSteps, "
+                                  "level, xp, money, arenaPoints, totalHonorPoints, todayHonorPoints, yesterdayHonorPoints, totalKills, "
+                                  "todayKills, yesterdayKills, drunk, "
+                                  "map, dungeon_difficulty, position_x, position_y, position_z, orientation, online, totaltime, leveltime, "
+                                  "rest_bonus, logout_time, is_logout_resting, trans_x, trans_y, trans_z, trans_o, transguid, zone, "
+                                  "health, power1, power2, power3, power4, power5, power6, power7) "
+                                  "VALUES (?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?, ?, "
+                                  "?, ?, ?, ?, ?, ?, ?, ?) ");
+
+        uberInsert.addUInt32(GetGUIDLow());
+        for (uint32 i = 0; i < MAX_CHARACTER_COLUMN_GROUPS; ++i)
+        {
+            uberInsert.addParams(columns[i]);
+            m_savedCharacterColumns[i].Update(columns[i]);
+        }
+        uberInsert.Execute();
+    }
+    else
+    {
+        static SqlStatementID updProfile;
+        static SqlStatementID updProgress;
+        static SqlStatementID updState;
+
+        static char const* const updates[MAX_CHARACTER_COLUMN_GROUPS] =
+        {
+            "UPDATE characters SET account = ?, name = ?, race = ?, class = ?, gender = ?, playerBytes = ?, playerBytes2 = ?, playerFlags = ?, "
+            "taximask = ?, cinematic = ?, resettalents_cost = ?, resettalents_time = ?, extra_flags = ?, stable_slots = ?, at_login = ?, "
+            "death_expire_time = ?, taxi_path = ?, chosenTitle = ?, knownCurrencies = ?, watchedFaction = ?, specCount = ?, activeSpec = ?, "
+            "exploredZones = ?, equipmentCache = ?, ammoId = ?, knownTitles = ?, actionBars = ?, grantableLevels = ?, fishingSteps = ? WHERE guid = ?",
+            "UPDATE characters SET level = ?, xp = ?, money = ?, arenaPoints = ?, totalHonorPoints = ?, todayHonorPoints = ?, "
+            "yesterdayHonorPoints = ?, totalKills = ?, todayKills = ?, yesterdayKills = ?, drunk = ? WHERE guid = ?",
+            "UPDATE characters SET map = ?, dungeon_difficulty = ?, position_x = ?, position_y = ?, position_z = ?, orientation = ?, online = ?, "
+            "totaltime = ?, leveltime = ?, rest_bonus = ?, logout_time = ?, is_logout_resting = ?, trans_x = ?, trans_y = ?, trans_z = ?, trans_o = ?, "
+            "transguid = ?, zone = ?, health = ?, power1 = ?, power2 = ?, power3 = ?, power4 = ?, power5 = ?, power6 = ?, power7 = ? WHERE guid = ?",
+        };
+        SqlStatementID* const updateIds[MAX_CHARACTER_COLUMN_GROUPS] = { &updProfile, &updProgress, &updState };
 
-    uberInsert.addUInt8(m_fishingSteps);
+        for (uint32 i = 0; i < MAX_CHARACTER_COLUMN_GROUPS; ++i)
+        {
+            if (!m_savedCharacterColumns[i].Update(columns[i]))
+                continue;
 
-    uberInsert.Execute();
+            SqlStatement stmt = CharacterDatabase.CreateStatement(*updateIds[i], updates[i]);
+            stmt.addParams(columns[i]);
+            stmt.addUInt32(GetGUIDLow());
+            stmt.Execute();
+        }
+    }
 
     if (m_mailsUpdated)                                     // save mails only when needed
         _SaveMail();
@@ -18461,7 +18517,7 @@ void Player::SaveToDB()
     _SaveGlyphs();
     _SaveTalents();
 
-    CharacterDatabase.CommitTransaction();
+    CharacterDatabase.CommitTransaction(m_saveFailed);
 
     // check if stats should only be saved on logout
     // save stats can be out of transaction
@@ -18480,12 +18536,15 @@ void Player::SaveInventoryAndGoldToDB()
     SaveGoldToDB();
 }
 
-void Player::SaveGoldToDB() const
+void Player::SaveGoldToDB()
 {
     static SqlStatementID updateGold ;
 
     SqlStatement stmt = CharacterDatabase.CreateStatement(updateGold, "UPDATE characters SET money = ? WHERE guid = ?");
     stmt.PExecute(GetMoney(), GetGUIDLow());
+
+    // the saved money is no longer the one in the row, money spent back to it must still be written
+    m_savedCharacterColumns[CHARACTER_COLUMNS_PROGRESS].Reset();
 }
 
 void Player::_SaveActions()
@@ -23045,6 +23104,9 @@ void Player::SaveTitles()
     for (uint32 i = 0; i < KNOWN_TITLES_SIZE * 2; ++i)
         playerTitles += std::to_string(GetUInt32Value(PLAYER__FIELD_KNOWN_TITLES + i)) + " ";
     CharacterDatabase.PExecute("UPDATE characters SET KnownTitles='%s' WHERE guid = '%u'", playerTitles.data(), GetGUIDLow());
+
+    // as for SaveGoldToDB, titles lost again until the next save must still be written
+    m_savedCharacterColumns[CHARACTER_COLUMNS_PROFILE].Reset();
 }
 
 void Player::SetQueuedSpell(Spell* spell)
@@ -25613,20 +25675,33 @@ void Player::_LoadCreatedInstanceTimers()
 
 void Player::_SaveNewInstanceIdTimer()
 {
-    CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
+    // sorted by instance id, so the same timers always give the same rows
+    std::vector<std::pair<uint32, TimePoint>> timers(m_enteredInstances.begin(), m_enteredInstances.end());
+    std::sort(timers.begin(), timers.end(), [](auto const& left, auto const& right) { return left.first < right.first; });
+
+    SqlStmtParameters rows;
+    for (auto const& timer : timers)
+    {
+        rows.addParam(SqlStmtFieldData(uint64(Clock::to_time_t(timer.second))));
+        rows.addParam(SqlStmtFieldData(timer.first));
+    }
 
-    if (m_enteredInstances.empty())
+    // same timers as saved last time
+    if (!m_savedEnteredInstances.Update(rows))
         return;
 
+    CharacterDatabase.PExecute("DELETE FROM account_instances_entered WHERE AccountId = '%u'", m_session->GetAccountId());
+
     static SqlStatementID insertInsertTimer;
-    for (auto enterInstItr : m_enteredInstances)
+    SqlStmtParameters::ParameterContainer const& values = rows.params();
+    for (size_t i = 0; i < values.size(); i += 2)
     {
         SqlStatement stmt = CharacterDatabase.CreateStatement(insertInsertTimer,
                             "INSERT INTO account_instances_entered (AccountId, ExpireTime, InstanceId) VALUES( ?, ?, ?)");
 
         stmt.addUInt32(m_session->GetAccountId());
-        stmt.addUInt64(Clock::to_time_t(enterInstItr.second));
-        stmt.addUInt32(enterInstItr.first);
+        stmt.addUInt64(values[i].toUint64());
+        stmt.addUInt32(values[i + 1].toUint32());
         stmt.Execute();
     }
 }
@@ -875,6 +875,15 @@ enum PlayerDelayedOperations
     DELAYED_END
 };
 
+// Columns of the characters row saved together, once the row is written a group is only updated when one of its values changed
+enum CharacterColumnGroup
+{
+    CHARACTER_COLUMNS_PROFILE   = 0,                        ///< account, name, appearance, titles and other rarely changed columns
+    CHARACTER_COLUMNS_PROGRESS  = 1,                        ///< level, experience, money and pvp points
+    CHARACTER_COLUMNS_STATE     = 2,                        ///< position, played time, health and power, updated by every save
+    MAX_CHARACTER_COLUMN_GROUPS
+};
+
 enum ReputationSource
 {
     REPUTATION_SOURCE_KILL,
@@ -1604,7 +1613,7 @@ class Player : public Unit
 
         void SaveToDB();
         void SaveInventoryAndGoldToDB();                    // fast save function for item/money cheating preventing
-        void SaveGoldToDB() const;
+        void SaveGoldToDB();
         static void SetUInt32ValueInArray(Tokens& tokens, uint16 index, uint32 value);
         static void Customize(ObjectGuid guid, uint8 gender, uint8 skin, uint8 face, uint8 hairStyle, uint8 hairColor, uint8 facialHair);
         static void SavePositionInDB(ObjectGuid guid, uint32 mapid, float x, float y, float z, float o, uint32 zone);
@@ -2686,6 +2695,7 @@ class Player : public Unit
         /***                   SAVE SYSTEM                     ***/
         /*********************************************************/
 
+        void _FillCharacterColumns(SqlStmtParameters (&columns)[MAX_CHARACTER_COLUMN_GROUPS]);
         void _SaveActions();
         void _SaveAuras();
         void _SaveInventory();
@@ -2975,6 +2985,12 @@ class Player : public Unit
         std::unordered_map<uint32, TimePoint> m_enteredInstances;
         uint32 m_createdInstanceClearTimer;
 
+        // values written by the last save, rows saved again with the same values are skipped
+        SqlSavedValues m_savedCharacterColumns[MAX_CHARACTER_COLUMN_GROUPS];
+        SqlSavedValues m_savedSpellCooldowns;
+        SqlSavedValues m_savedEnteredInstances;
+        SqlTransactionFailure m_saveFailed;                 // a queued save was rolled back, the next one writes everything
+
         uint32 m_pendingBindMapId;
         uint32 m_pendingBindId;
         uint32 m_pendingBindTimer;
@@ -35,6 +35,7 @@
 #include "Entities/TemporarySpawn.h"
 #include "Entities/Pet.h"
 #include "Util/Util.h"
+#include "Util/CodeBench.h"
 #include "Entities/Totem.h"
 #include "Entities/Vehicle.h"
 #include "BattleGround/BattleGround.h"
@@ -54,6 +55,7 @@
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Metric/Instrument.h"
 #endif
 
 #include <math.h>
@@ -411,14 +413,11 @@ void Unit::Update(const uint32 diff)
 {
     if (!IsInWorld())
         return;
+
+    PROFILE_ZONE("Unit::Update");
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::histogram const updateMetric("unit.update");
+    auto meas = metric::make_timer<std::chrono::microseconds>(updateMetric, 1000, [this](metric::measurement& slow) { AddMetricTags(slow); });
 #endif
 
     /*if(p_time > m_AurasCheck)
@@ -480,13 +479,8 @@ void Unit::Update(const uint32 diff)
     if (AI() && IsAlive())
     {
 #ifdef BUILD_METRICS
-        metric::duration<std::chrono::microseconds> meas_ai("unit.update.ai", {
-            { "entry", std::to_string(GetEntry()) },
-            { "guid", std::to_string(GetGUIDLow()) },
-            { "unit_type", std::to_string(GetGUIDHigh()) },
-            { "map_id", std::to_string(GetMapId()) },
-            { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
+        static metric::histogram const updateAIMetric("unit.update.ai");
+        auto meas_ai = metric::make_timer<std::chrono::microseconds>(updateAIMetric, 1000, [this](metric::measurement& slow) { AddMetricTags(slow); });
 #endif
 
         AI()->UpdateAI(diff);   // AI not react good at real update delays (while freeze in non-active part of map)
@@ -504,6 +498,17 @@ void Unit::Update(const uint32 diff)
     WorldObject::Update(diff);
 }
 
+#ifdef BUILD_METRICS
+void Unit::AddMetricTags(metric::measurement& meas) const
+{
+    meas.add_tag("entry", std::to_string(GetEntry()));
+    meas.add_tag("guid", std::to_string(GetGUIDLow()));
+    meas.add_tag("unit_type", std::to_string(GetGUIDHigh()));
+    meas.add_tag("map_id", std::to_string(GetMapId()));
+    meas.add_tag("instance_id", std::to_string(GetInstanceId()));
+}
+#endif
+
 void Unit::Heartbeat()
 {
     WorldObject::Heartbeat();
@@ -4664,15 +4669,16 @@ uint32 Unit::GetWeaponSkillValue(WeaponAttackType attType, Unit const* target) c
 void Unit::_UpdateSpells(uint32 time)
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.update.spells", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-        }, 1000);
-
-    std::vector<uint32> updatedSpellIds;
+    static metric::histogram const updateSpellsMetric("unit.update.spells");
+    auto meas = metric::make_timer<std::chrono::microseconds>(updateSpellsMetric, 1000, [this](metric::measurement& slow)
+    {
+        AddMetricTags(slow);
+
+        std::string logging;
+        for (auto const& holder : m_spellAuraHolders)
+            logging += std::to_string(holder.second->GetId()) + ",";
+        slow.add_field("spells", "\"" + logging + "\"");
+    });
 #endif
 
     if (m_currentSpells[CURRENT_AUTOREPEAT_SPELL])
@@ -4695,9 +4701,6 @@ void Unit::_UpdateSpells(uint32 time)
         SpellAuraHolder* i_holder = m_spellAuraHoldersUpdateIterator->second;
         ++m_spellAuraHoldersUpdateIterator;                 // need shift to next for allow update if need into aura update
         i_holder->UpdateHolder(time);
-#ifdef BUILD_METRICS
-        updatedSpellIds.push_back(i_holder->GetId());
-#endif
     }
 
     // remove expired auras
@@ -4713,12 +4716,6 @@ void Unit::_UpdateSpells(uint32 time)
         else
             ++iter;
     }
-#ifdef BUILD_METRICS
-    std::string logging;
-    for (uint32 spellId : updatedSpellIds)
-        logging += std::to_string(spellId) + ",";
-    meas.add_field("spells", "\"" + logging + "\"");
-#endif
 }
 
 void Unit::_UpdateAutoRepeatSpell()
@@ -5502,6 +5499,7 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
     holder->_AddSpellAuraHolder();
     holder->SetCreationDelayFlag();
     m_spellAuraHolders.insert(SpellAuraHolderMap::value_type(holder->GetId(), holder));
+    m_procAuraHolders.Add(holder);
 
     for (int32 i = 0; i < MAX_EFFECT_INDEX; ++i)
         if (Aura* aur = holder->GetAuraByEffectIndex(SpellEffectIndex(i)))
@@ -6150,6 +6148,7 @@ void Unit::RemoveSpellAuraHolder(SpellAuraHolder* holder, AuraRemoveMode mode)
         if (itr->second == holder)
         {
             m_spellAuraHolders.erase(itr);
+            m_procAuraHolders.Remove(holder);
             m_hasPeriodicAura = HasPeriodicAura();
             if (!m_hasPeriodicAura)
                 SetNextUpdateTime(0);
@@ -11548,6 +11547,7 @@ void Unit::UpdateModelData()
         SetFloatValue(UNIT_FIELD_BOUNDINGRADIUS, GetObjectScale() * modelInfo->bounding_radius);
 
         SetFloatValue(UNIT_FIELD_COMBATREACH, GetObjectScale() * modelInfo->combat_reach);
+        UpdateCellIndex();
 
         SetBaseWalkSpeed(modelInfo->SpeedWalk);
         SetModelRunSpeed(modelInfo->SpeedRun);
@@ -12537,13 +12537,8 @@ void Unit::UpdateSplineMovement(uint32 t_diff)
     if (movespline->Finalized())
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("unit.updatesplinemovement", {
-        { "entry", std::to_string(GetEntry()) },
-        { "guid", std::to_string(GetGUIDLow()) },
-        { "unit_type", std::to_string(GetGUIDHigh()) },
-        { "map_id", std::to_string(GetMapId()) },
-        { "instance_id", std::to_string(GetInstanceId()) }
-    }, 1000);
+    static metric::histogram const splineMetric("unit.updatesplinemovement");
+    auto meas = metric::make_timer<std::chrono::microseconds>(splineMetric, 1000, [this](metric::measurement& slow) { AddMetricTags(slow); });
 #endif
     movespline->updateState(t_diff);
     bool arrived = movespline->Finalized();
@@ -13360,8 +13355,10 @@ void Unit::InterruptSpellsCastedOnMe(bool killDelayed)
         if (!killDelayed)
             continue;
         // 2/ Interrupt spells that are not referenced but that still have an event (like delayed spell)
-        for (auto i_events = target->m_events.GetEvents().begin(); i_events != target->m_events.GetEvents().end(); ++i_events)
-            if (SpellEvent* event = dynamic_cast<SpellEvent*>(i_events->second))
+        std::vector<BasicEvent*> events;
+        target->m_events.GetEvents(events);
+        for (BasicEvent* basicEvent : events)
+            if (SpellEvent* event = dynamic_cast<SpellEvent*>(basicEvent))
                 if (event && event->GetSpell()->m_targets.getUnitTargetGuid() == GetObjectGuid())
                     if (event->GetSpell()->getState() != SPELL_STATE_FINISHED)
                         event->GetSpell()->cancel();
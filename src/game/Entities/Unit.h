@@ -30,6 +30,7 @@
 #include "Entities/Object.h"
 #include "Server/Opcodes.h"
 #include "Spells/SpellAuraDefines.h"
+#include "Spells/SpellAuraProcIndex.h"
 #include "Entities/UpdateFields.h"
 #include "Globals/SharedDefines.h"
 #include "Combat/ThreatManager.h"
@@ -242,6 +243,9 @@ class Totem;
 class SpellCastTargets;
 class VehicleInfo;
 class SpellCastArgs;
+#ifdef BUILD_METRICS
+namespace metric { class measurement; }
+#endif
 
 struct SpellImmune
 {
@@ -1218,6 +1222,9 @@ class Unit : public WorldObject
 
         void Update(const uint32 diff) override;
         void Heartbeat() override;
+#ifdef BUILD_METRICS
+        void AddMetricTags(metric::measurement& meas) const; // identifies the unit in reports of slow updates
+#endif
 
         /**
          * Updates the attack time for the given WeaponAttackType
@@ -1994,6 +2001,8 @@ class Unit : public WorldObject
         virtual void DeleteCharmInfo() { delete m_charmInfo; m_charmInfo = nullptr; }
 
         ObjectGuid const& GetTotemGuid(TotemSlot slot) const { return m_TotemSlot[slot]; }
+        bool HasGuardians() const { return !m_guardianPets.empty(); }
+        bool HasMiniPet() const { return !GetCritterGuid().IsEmpty(); }
         Totem* GetTotem(TotemSlot slot) const;
         bool IsAllTotemSlotsUsed() const;
 
@@ -2701,6 +2710,7 @@ class Unit : public WorldObject
 
         SpellAuraHolderMap m_spellAuraHolders;
         SpellAuraHolderMap::iterator m_spellAuraHoldersUpdateIterator; // != end() in Unit::m_spellAuraHolders update and point to next element
+        SpellAuraProcIndex m_procAuraHolders;               // holders of m_spellAuraHolders able to proc, by proc flags
         AuraList m_deletedAuras;                            // auras removed while in ApplyModifier and waiting deleted
         SpellAuraHolderList m_deletedHolders;
         std::map<uint32, Aura*> m_classScripts;
@@ -27,6 +27,7 @@
 #include "World/World.h"
 #include "Entities/ObjectGuid.h"
 #include "Server/WorldSession.h"
+#include "Util/TSS.h"
 
 UpdateData::UpdateData() : m_data(1, {ByteBuffer(0), 0}), m_currentIndex(0)
 {
@@ -65,60 +66,99 @@ void UpdateData::AddAfterCreatePacket(const WorldPacket& data)
     m_afterCreatePacket.emplace_back(data);
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+// Deflate state of one thread. Allocating and initialising zlib state is expensive compared to compressing
+// a single update packet, so every thread keeps its stream and only resets it between packets.
+class UpdateDataDeflateStream
+{
+    public:
+        UpdateDataDeflateStream() : m_level(-1)
+        {
+            m_stream.zalloc = (alloc_func)nullptr;
+            m_stream.zfree = (free_func)nullptr;
+            m_stream.opaque = (voidpf)nullptr;
+        }
+
+        ~UpdateDataDeflateStream()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+        }
+
+        z_stream* Acquire(int level)
+        {
+            if (m_level == level)
+            {
+                int z_res = deflateReset(&m_stream);
+                if (z_res == Z_OK)
+                    return &m_stream;
+
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            }
+
+            // first use on this thread or compression level changed by config reload
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+
+            m_level = -1;
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return nullptr;
+            }
+
+            m_level = level;
+            return &m_stream;
+        }
+
+    private:
+        z_stream m_stream;
+        int m_level;
+};
+
+static MaNGOS::thread_local_ptr<UpdateDataDeflateStream> deflateStream;
+
+uint32 UpdateData::Compress(uint8* dst, uint32 dst_size, ByteBuffer const& header, ByteBuffer const& body)
 {
-    z_stream c_stream;
-
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
-
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
+    z_stream* c_stream = deflateStream->Acquire(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
+        return 0;
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = dst_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
+    // header and blocks are fed separately, so they never have to be joined into one buffer
+    for (ByteBuffer const* src : { &header, &body })
     {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        if (!src->wpos())
+            continue;
+
+        c_stream->next_in = (Bytef*)src->contents();
+        c_stream->avail_in = (uInt)src->wpos();
+
+        int z_res = deflate(c_stream, Z_NO_FLUSH);
+        if (z_res != Z_OK)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+            return 0;
+        }
+
+        if (c_stream->avail_in != 0)
+        {
+            sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
+            return 0;
+        }
     }
 
-    if (c_stream.avail_in != 0)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflate(&c_stream, Z_FINISH);
+    int z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        return 0;
     }
 
-    *dst_size = c_stream.total_out;
+    return c_stream->total_out;
 }
 
 WorldPacket UpdateData::BuildPacket(size_t index)
@@ -126,22 +166,22 @@ WorldPacket UpdateData::BuildPacket(size_t index)
     WorldPacket packet;
     MANGOS_ASSERT(packet.empty());                         // shouldn't happen
 
-    ByteBuffer buf(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()) + m_data[index].m_buffer.wpos());
+    ByteBuffer header(4 + (m_outOfRangeGUIDs.empty() ? 0 : 1 + 4 + 9 * m_outOfRangeGUIDs.size()));
 
-    buf << (uint32)(!m_outOfRangeGUIDs.empty() ? m_data[index].m_blockCount + 1 : m_data[index].m_blockCount);
+    header << (uint32)(!m_outOfRangeGUIDs.empty() ? m_data[index].m_blockCount + 1 : m_data[index].m_blockCount);
 
     if (!m_outOfRangeGUIDs.empty())
     {
-        buf << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
-        buf << (uint32) m_outOfRangeGUIDs.size();
+        header << (uint8) UPDATETYPE_OUT_OF_RANGE_OBJECTS;
+        header << (uint32) m_outOfRangeGUIDs.size();
 
         for (auto m_outOfRangeGUID : m_outOfRangeGUIDs)
-            buf << m_outOfRangeGUID.WriteAsPacked();
+            header << m_outOfRangeGUID.WriteAsPacked();
     }
 
-    buf.append(m_data[index].m_buffer);
+    ByteBuffer const& body = m_data[index].m_buffer;
 
-    size_t pSize = buf.wpos();                              // use real used data size
+    size_t pSize = header.wpos() + body.wpos();             // use real used data size
 
     if (pSize > 100)                                        // compress large packets
     {
@@ -149,7 +189,7 @@ WorldPacket UpdateData::BuildPacket(size_t index)
         packet.resize(destsize + sizeof(uint32));
 
         packet.put<uint32>(0, pSize);
-        Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), &destsize, (void*)buf.contents(), pSize);
+        destsize = Compress(const_cast<uint8*>(packet.contents()) + sizeof(uint32), destsize, header, body);
         if (destsize == 0)
             return packet;
 
@@ -158,7 +198,9 @@ WorldPacket UpdateData::BuildPacket(size_t index)
     }
     else                                                    // send small packets without compression
     {
-        packet.append(buf);
+        packet.reserve(pSize);
+        packet.append(header);
+        packet.append(body);
         packet.SetOpcode(SMSG_UPDATE_OBJECT);
     }
 
@@ -185,3 +227,25 @@ void UpdateData::SendData(WorldSession& session)
     for (auto& packet : m_afterCreatePacket)
         session.SendPacket(packet);
 }
+
+void UpdateData::BuildPackets(std::vector<WorldPacket>& packets)
+{
+    if (!HasData())
+        return;
+
+    packets.reserve(GetPacketCount());
+    for (size_t i = 0; i < GetPacketCount(); ++i)
+        packets.push_back(BuildPacket(i));
+}
+
+void UpdateData::SendPackets(WorldSession& session, std::vector<WorldPacket> const& packets) const
+{
+    if (!HasData())
+        return;
+
+    for (auto& packet : packets)
+        session.SendPacket(packet);
+
+    for (auto& packet : m_afterCreatePacket)
+        session.SendPacket(packet);
+}
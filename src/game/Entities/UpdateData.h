@@ -68,12 +68,23 @@ class UpdateData
         WorldPacket BuildPacket(size_t index); // Copy Elision is a thing
         bool HasData() const { return m_data[0].m_buffer.size() > 0 || !m_outOfRangeGUIDs.empty(); }
         size_t GetPacketCount() const { return m_data.size(); }
+        size_t GetBlockDataSize() const
+        {
+            size_t size = 0;
+            for (auto const& data : m_data)
+                size += data.m_buffer.wpos();
+            return size;
+        }
         void Clear();
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
         void SendData(WorldSession& session);
 
+        // SendData in two steps, so the packets can be built and compressed on another thread than the one sending them
+        void BuildPackets(std::vector<WorldPacket>& packets);
+        void SendPackets(WorldSession& session, std::vector<WorldPacket> const& packets) const;
+
     protected:
         GuidSet m_outOfRangeGUIDs;
         std::vector<BufferPair> m_data;
@@ -81,6 +92,55 @@ class UpdateData
 
         std::vector<WorldPacket> m_afterCreatePacket;
 
-        static void Compress(void* dst, uint32* dst_size, void* src, int src_size);
+        // deflates header followed by body into dst, returns the compressed size or 0 on failure
+        static uint32 Compress(uint8* dst, uint32 dst_size, ByteBuffer const& header, ByteBuffer const& body);
+};
+
+// Update blocks of one object, built once and shared by all observers that see the same set of fields.
+// Fields whose value depends on the observer are recorded by offset and rewritten per observer on copy.
+class UpdateBlockCache
+{
+    public:
+        typedef std::vector<std::pair<uint32, uint16>> TargetFields;   // byte offset in block, update field index
+
+        struct Block
+        {
+            uint32 key;
+            ByteBuffer data;
+            TargetFields targetFields;
+        };
+
+        UpdateBlockCache() : m_used(0) {}
+
+        Block* Find(uint32 key)
+        {
+            for (size_t i = 0; i < m_used; ++i)
+                if (m_blocks[i].key == key)
+                    return &m_blocks[i];
+            return nullptr;
+        }
+
+        // returned reference is valid until the next Insert
+        Block& Insert(uint32 key)
+        {
+            if (m_used == m_blocks.size())
+                m_blocks.emplace_back();
+
+            Block& block = m_blocks[m_used++];
+            block.key = key;
+            block.data.clear();
+            block.targetFields.clear();
+            return block;
+        }
+
+        // forget cached blocks but keep their storage for the next object
+        void Clear() { m_used = 0; }
+
+        ByteBuffer& GetScratchBuffer() { return m_scratch; }
+
+    private:
+        std::vector<Block> m_blocks;
+        size_t m_used;
+        ByteBuffer m_scratch;
 };
 #endif
@@ -24,6 +24,7 @@
 
 class Map;
 class WorldObject;
+struct CellIndexQuery;
 
 struct CellArea
 {
@@ -107,6 +108,10 @@ struct Cell
         template<class T, class CONTAINER> void Visit(const CellPair& cellPair, TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, float x, float y, float radius) const;
         template<class T, class CONTAINER> void Visit(const CellPair& cellPair, TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, const WorldObject& obj, float radius) const;
 
+        // visits the objects of the cell area through the position indexes of the cells instead of their lists,
+        // when the visitor can tell which objects it wants; grids are never loaded. Returns false otherwise.
+        template<class T> bool VisitIndexed(const CellPair& cellPair, T& visitor, Map& m, float x, float y, float radius, uint32 containerMask) const;
+
         static CellArea CalculateCellArea(float x, float y, float radius);
 
         template<class T> static void VisitGridObjects(const WorldObject* obj, T& visitor, float radius, bool dont_load = true);
@@ -118,7 +123,9 @@ struct Cell
         template<class T> static void VisitAllObjects(float x, float y, Map* map, T& visitor, float radius, bool dont_load = true);
 
     private:
-        template<class T, class CONTAINER> void VisitCircle(TypeContainerVisitor<T, CONTAINER>&, Map&, const CellPair&, const CellPair&) const;
+        // calls visit for every cell of the area around x, y, standing cell first
+        template<class F> void VisitCells(const CellPair& standing_cell, float x, float y, float radius, F const& visit) const;
+        template<class F> void VisitCircle(F const& visit, const CellPair&, const CellPair&) const;
 };
 
 #endif
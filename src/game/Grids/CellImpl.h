@@ -23,6 +23,7 @@
 #include "Grids/Cell.h"
 #include "Maps/Map.h"
 #include <cmath>
+#include <type_traits>
 
 inline Cell::Cell(CellPair const& p)
 {
@@ -60,6 +61,56 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
 template<class T, class CONTAINER>
 inline void
 Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, float x, float y, float radius) const
+{
+    VisitCells(standing_cell, x, y, radius, [&](Cell const& cell)
+    {
+        m.Visit(cell, visitor);
+    });
+}
+
+namespace MaNGOS
+{
+    // visitors able to tell which objects they want from the position indexes of cells
+    template<class T, class = void>
+    struct HasIndexedVisit : std::false_type {};
+
+    template<class T>
+    struct HasIndexedVisit<T, std::void_t<decltype(&T::VisitIndexed)>> : std::true_type {};
+}
+
+template<class T>
+inline bool
+Cell::VisitIndexed(const CellPair& standing_cell, T& visitor, Map& m, float x, float y, float radius, uint32 containerMask) const
+{
+    if constexpr (MaNGOS::HasIndexedVisit<T>::value)
+    {
+        CellIndexQuery query;
+        if (!visitor.GetIndexedQuery(query))
+            return false;
+
+        query.containerMask = containerMask;
+        VisitCells(standing_cell, x, y, radius, [&](Cell const& cell)
+        {
+            m.VisitCellIndex(cell, query, visitor);
+        });
+        return true;
+    }
+    else
+    {
+        (void)standing_cell;
+        (void)visitor;
+        (void)m;
+        (void)x;
+        (void)y;
+        (void)radius;
+        (void)containerMask;
+        return false;
+    }
+}
+
+template<class F>
+inline void
+Cell::VisitCells(const CellPair& standing_cell, float x, float y, float radius, F const& visit) const
 {
     if (standing_cell.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || standing_cell.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
         return;
@@ -69,7 +120,7 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
     // maybe it is better to just return when radius <= 0.0f?
     if (radius <= 0.0f)
     {
-        m.Visit(*this, visitor);
+        visit(*this);
         return;
     }
     // lets limit the upper value for search radius
@@ -81,7 +132,7 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
     // if radius fits inside standing cell
     if (!area)
     {
-        m.Visit(*this, visitor);
+        visit(*this);
         return;
     }
 
@@ -93,13 +144,13 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
     // there are nothing to optimize because SIZE_OF_GRID_CELL is too big...
     if (((end_cell.x_coord - begin_cell.x_coord) > 4) && ((end_cell.y_coord - begin_cell.y_coord) > 4))
     {
-        VisitCircle(visitor, m, begin_cell, end_cell);
+        VisitCircle(visit, begin_cell, end_cell);
         return;
     }
 
     // ALWAYS visit standing cell first!!! Since we deal with small radiuses
     // it is very essential to call visitor for standing cell firstly...
-    m.Visit(*this, visitor);
+    visit(*this);
 
     // loop the cell range
     for (uint32 i = begin_cell.x_coord; i <= end_cell.x_coord; ++i)
@@ -112,15 +163,15 @@ Cell::Visit(const CellPair& standing_cell, TypeContainerVisitor<T, CONTAINER>& v
             {
                 Cell r_zone(cell_pair);
                 r_zone.data.Part.nocreate = data.Part.nocreate;
-                m.Visit(r_zone, visitor);
+                visit(r_zone);
             }
         }
     }
 }
 
-template<class T, class CONTAINER>
+template<class F>
 inline void
-Cell::VisitCircle(TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, const CellPair& begin_cell, const CellPair& end_cell) const
+Cell::VisitCircle(F const& visit, const CellPair& begin_cell, const CellPair& end_cell) const
 {
     // here is an algorithm for 'filling' circum-squared octagon
     uint32 x_shift = (uint32)ceilf((end_cell.x_coord - begin_cell.x_coord) * 0.3f - 0.5f);
@@ -136,7 +187,7 @@ Cell::VisitCircle(TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, const Cel
             CellPair cell_pair(x, y);
             Cell r_zone(cell_pair);
             r_zone.data.Part.nocreate = data.Part.nocreate;
-            m.Visit(r_zone, visitor);
+            visit(r_zone);
         }
     }
 
@@ -160,13 +211,13 @@ Cell::VisitCircle(TypeContainerVisitor<T, CONTAINER>& visitor, Map& m, const Cel
             CellPair cell_pair_left(x_start - step, y);
             Cell r_zone_left(cell_pair_left);
             r_zone_left.data.Part.nocreate = data.Part.nocreate;
-            m.Visit(r_zone_left, visitor);
+            visit(r_zone_left);
 
             // right trapezoid cell visit
             CellPair cell_pair_right(x_end + step, y);
             Cell r_zone_right(cell_pair_right);
             r_zone_right.data.Part.nocreate = data.Part.nocreate;
-            m.Visit(r_zone_right, visitor);
+            visit(r_zone_right);
         }
     }
 }
@@ -177,7 +228,11 @@ inline void Cell::VisitGridObjects(const WorldObject* center_obj, T& visitor, fl
     CellPair p(MaNGOS::ComputeCellPair(center_obj->GetPositionX(), center_obj->GetPositionY()));
     Cell cell(p);
     if (dont_load)
+    {
         cell.SetNoCreate();
+        if (cell.VisitIndexed(p, visitor, *center_obj->GetMap(), center_obj->GetPositionX(), center_obj->GetPositionY(), radius + center_obj->GetObjectBoundingRadius(), CELL_INDEX_GRID_OBJECTS))
+            return;
+    }
     TypeContainerVisitor<T, GridTypeMapContainer > gnotifier(visitor);
     cell.Visit(p, gnotifier, *center_obj->GetMap(), *center_obj, radius);
 }
@@ -188,7 +243,11 @@ inline void Cell::VisitWorldObjects(const WorldObject* center_obj, T& visitor, f
     CellPair p(MaNGOS::ComputeCellPair(center_obj->GetPositionX(), center_obj->GetPositionY()));
     Cell cell(p);
     if (dont_load)
+    {
         cell.SetNoCreate();
+        if (cell.VisitIndexed(p, visitor, *center_obj->GetMap(), center_obj->GetPositionX(), center_obj->GetPositionY(), radius + center_obj->GetObjectBoundingRadius(), CELL_INDEX_WORLD_OBJECTS))
+            return;
+    }
     TypeContainerVisitor<T, WorldTypeMapContainer > gnotifier(visitor);
     cell.Visit(p, gnotifier, *center_obj->GetMap(), *center_obj, radius);
 }
@@ -202,7 +261,11 @@ inline void Cell::VisitAllObjects(const WorldObject* center_obj, T& visitor, flo
     CellPair p(MaNGOS::ComputeCellPair(center_obj->GetPositionX(), center_obj->GetPositionY()));
     Cell cell(p);
     if (dont_load)
+    {
         cell.SetNoCreate();
+        if (cell.VisitIndexed(p, visitor, *center_obj->GetMap(), center_obj->GetPositionX(), center_obj->GetPositionY(), radius + center_obj->GetObjectBoundingRadius(), CELL_INDEX_ALL_OBJECTS))
+            return;
+    }
     TypeContainerVisitor<T, GridTypeMapContainer > gnotifier(visitor);
     TypeContainerVisitor<T, WorldTypeMapContainer > wnotifier(visitor);
     cell.Visit(p, gnotifier, *center_obj->GetMap(), *center_obj, radius);
@@ -215,7 +278,11 @@ inline void Cell::VisitGridObjects(float x, float y, Map* map, T& visitor, float
     CellPair p(MaNGOS::ComputeCellPair(x, y));
     Cell cell(p);
     if (dont_load)
+    {
         cell.SetNoCreate();
+        if (cell.VisitIndexed(p, visitor, *map, x, y, radius, CELL_INDEX_GRID_OBJECTS))
+            return;
+    }
     TypeContainerVisitor<T, GridTypeMapContainer > gnotifier(visitor);
     cell.Visit(p, gnotifier, *map, x, y, radius);
 }
@@ -226,7 +293,11 @@ inline void Cell::VisitWorldObjects(float x, float y, Map* map, T& visitor, floa
     CellPair p(MaNGOS::ComputeCellPair(x, y));
     Cell cell(p);
     if (dont_load)
+    {
         cell.SetNoCreate();
+        if (cell.VisitIndexed(p, visitor, *map, x, y, radius, CELL_INDEX_WORLD_OBJECTS))
+            return;
+    }
     TypeContainerVisitor<T, WorldTypeMapContainer > gnotifier(visitor);
     cell.Visit(p, gnotifier, *map, x, y, radius);
 }
@@ -237,7 +308,11 @@ inline void Cell::VisitAllObjects(float x, float y, Map* map, T& visitor, float
     CellPair p(MaNGOS::ComputeCellPair(x, y));
     Cell cell(p);
     if (dont_load)
+    {
         cell.SetNoCreate();
+        if (cell.VisitIndexed(p, visitor, *map, x, y, radius, CELL_INDEX_ALL_OBJECTS))
+            return;
+    }
     TypeContainerVisitor<T, GridTypeMapContainer > gnotifier(visitor);
     TypeContainerVisitor<T, WorldTypeMapContainer > wnotifier(visitor);
     cell.Visit(p, gnotifier, *map, x, y, radius);
@@ -27,9 +27,11 @@
 #include "Entities/GameObject.h"
 #include "Entities/Player.h"
 #include "Entities/Unit.h"
+#include "Maps/CellObjectIndex.h"
 
 #include <functional>
 #include <memory>
+#include <type_traits>
 
 namespace MaNGOS
 {
@@ -351,6 +353,49 @@ namespace MaNGOS
 
     // Unit searchers
 
+    // checks which can bound the objects they accept by a range around their focus object, so unit searchers
+    // may take the candidates from the position indexes of cells
+    template<class Check, class = void>
+    struct HasIndexedRange : std::false_type {};
+
+    template<class Check>
+    struct HasIndexedRange<Check, std::void_t<decltype(&Check::GetIndexedRange)>> : std::true_type {};
+
+    template<class Check>
+    inline bool GetUnitIndexedQuery(Check const& check, uint32 phaseMask, CellIndexQuery& query)
+    {
+        if constexpr (HasIndexedRange<Check>::value)
+        {
+            if (!check.GetIndexedRange(query.range))
+                return false;
+
+            WorldObject const& focus = check.GetFocusObject();
+            query.x = focus.GetPositionX();
+            query.y = focus.GetPositionY();
+            query.typeMask = TYPEMASK_UNIT;
+            query.phaseMask = phaseMask;
+            return true;
+        }
+        else
+        {
+            (void)check;
+            (void)phaseMask;
+            (void)query;
+            return false;
+        }
+    }
+
+    // range around obj within which WorldObject::IsWithinDistInMap(target, range) may hold, without the reach of
+    // the target that the cell indexes add themselves; game objects measure from their model bounds instead
+    inline bool GetWithinDistIndexedRange(WorldObject const* obj, float range, float& indexedRange)
+    {
+        if (obj->GetTypeId() == TYPEID_GAMEOBJECT)
+            return false;
+
+        indexedRange = range + obj->GetCombatReach();
+        return true;
+    }
+
     // First accepted by Check Unit if any
     template<class Check>
     struct UnitSearcher
@@ -365,6 +410,9 @@ namespace MaNGOS
         void Visit(CreatureMapType& m);
         void Visit(PlayerMapType& m);
 
+        bool GetIndexedQuery(CellIndexQuery& query) const { return GetUnitIndexedQuery(i_check, i_phaseMask, query); }
+        void VisitIndexed(WorldObject* object);
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
@@ -382,6 +430,9 @@ namespace MaNGOS
         void Visit(CreatureMapType& m);
         void Visit(PlayerMapType& m);
 
+        bool GetIndexedQuery(CellIndexQuery& query) const { return GetUnitIndexedQuery(i_check, i_phaseMask, query); }
+        void VisitIndexed(WorldObject* object);
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
@@ -399,6 +450,9 @@ namespace MaNGOS
         void Visit(PlayerMapType& m);
         void Visit(CreatureMapType& m);
 
+        bool GetIndexedQuery(CellIndexQuery& query) const { return GetUnitIndexedQuery(i_check, i_phaseMask, query); }
+        void VisitIndexed(WorldObject* object);
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) {}
     };
 
@@ -1111,6 +1165,7 @@ namespace MaNGOS
                 i_controlledByPlayer = obj->IsControlledByPlayer();
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetIndexedRange(float& range) const { return GetWithinDistIndexedRange(i_obj, i_range, range); }
             bool operator()(Unit* u) const
             {
                 // ignore totems
@@ -1131,6 +1186,7 @@ namespace MaNGOS
             AnyUnfriendlyVisibleUnitInObjectRangeCheck(WorldObject const* obj, Unit const* funit, float range)
                 : i_obj(obj), i_funit(funit), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetIndexedRange(float& range) const { return GetWithinDistIndexedRange(i_obj, i_range, range); }
             bool operator()(Unit* u)
             {
                 return u->IsAlive()
@@ -1150,6 +1206,7 @@ namespace MaNGOS
             AnySpellAssistableUnitInObjectRangeCheck(WorldObject const* obj, SpellEntry const* spellInfo, float range, bool ignorePhase = false)
                 : i_obj(obj), i_spellInfo(spellInfo), i_range(range), i_ignorePhase(ignorePhase) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetIndexedRange(float& range) const { return GetWithinDistIndexedRange(i_obj, i_range, range); }
             bool operator()(Unit* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range, true, i_ignorePhase) && i_obj->CanAssistSpell(u, i_spellInfo);
@@ -1167,6 +1224,7 @@ namespace MaNGOS
             AnyFriendlyUnitInObjectRangeCheck(WorldObject const* obj, float range, bool ignorePhase = false)
                 : i_obj(obj), i_range(range), i_ignorePhase(ignorePhase) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetIndexedRange(float& range) const { return GetWithinDistIndexedRange(i_obj, i_range, range); }
             bool operator()(Unit* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range, true, i_ignorePhase) && i_obj->CanAssistSpell(u);
@@ -1244,6 +1302,7 @@ namespace MaNGOS
         public:
             AnyUnitInObjectRangeCheck(WorldObject const* obj, float range) : i_obj(obj), i_range(range) {}
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetIndexedRange(float& range) const { return GetWithinDistIndexedRange(i_obj, i_range, range); }
             bool operator()(Unit* u)
             {
                 return u->IsAlive() && i_obj->IsWithinDistInMap(u, i_range);
@@ -1308,6 +1367,7 @@ namespace MaNGOS
                 i_targetForPlayer = i_obj->IsControlledByPlayer();
             }
             WorldObject const& GetFocusObject() const { return *i_obj; }
+            bool GetIndexedRange(float& range) const { return GetWithinDistIndexedRange(i_obj, i_range, range); }
             bool operator()(Unit* u)
             {
                 // Check contains checks for: live, non-selectable, non-attackable flags, flight check and GM check, ignore totems
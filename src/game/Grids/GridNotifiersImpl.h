@@ -607,6 +607,31 @@ void MaNGOS::UnitListSearcher<Check>::Visit(CreatureMapType& m)
                 i_objects.push_back(itr->getSource());
 }
 
+template<class Check>
+void MaNGOS::UnitSearcher<Check>::VisitIndexed(WorldObject* object)
+{
+    // already found
+    if (i_object)
+        return;
+
+    if (i_check(static_cast<Unit*>(object)))
+        i_object = static_cast<Unit*>(object);
+}
+
+template<class Check>
+void MaNGOS::UnitLastSearcher<Check>::VisitIndexed(WorldObject* object)
+{
+    if (i_check(static_cast<Unit*>(object)))
+        i_object = static_cast<Unit*>(object);
+}
+
+template<class Check>
+void MaNGOS::UnitListSearcher<Check>::VisitIndexed(WorldObject* object)
+{
+    if (i_check(static_cast<Unit*>(object)))
+        i_objects.push_back(static_cast<Unit*>(object));
+}
+
 // Creature searchers
 
 template<class Check>
@@ -0,0 +1,150 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "Maps/CellObjectIndex.h"
+#include "Entities/Object.h"
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define CELL_INDEX_SSE
+#endif
+
+static uint32 const CONTAINER_SHIFT = 16;
+
+CellObjectIndex::~CellObjectIndex()
+{
+    for (WorldObject* object : m_objects)
+        object->SetCellIndex(nullptr, 0);
+}
+
+void CellObjectIndex::Add(WorldObject* object, uint32 container)
+{
+    MANGOS_ASSERT(!object->GetCellIndex());
+
+    uint32 slot = GetCount();
+    m_objects.push_back(object);
+
+    uint32 size = slot + 1 + PADDING;
+    m_x.resize(size, 0.0f);
+    m_y.resize(size, 0.0f);
+    m_reach.resize(size, 0.0f);
+    m_kind.resize(size, 0);
+    m_phaseMask.resize(size, 0);
+
+    m_kind[slot] = object->GetTypeMask() | (container << CONTAINER_SHIFT);
+    Write(slot, object);
+    object->SetCellIndex(this, slot);
+}
+
+void CellObjectIndex::Remove(WorldObject* object)
+{
+    MANGOS_ASSERT(object->GetCellIndex() == this);
+
+    uint32 slot = object->GetCellIndexSlot();
+    uint32 last = GetCount() - 1;
+    if (slot != last)
+    {
+        m_x[slot] = m_x[last];
+        m_y[slot] = m_y[last];
+        m_reach[slot] = m_reach[last];
+        m_kind[slot] = m_kind[last];
+        m_phaseMask[slot] = m_phaseMask[last];
+        m_objects[slot] = m_objects[last];
+        m_objects[slot]->SetCellIndex(this, slot);
+    }
+
+    // the freed entry becomes padding, which no query accepts
+    m_kind[last] = 0;
+    m_objects.pop_back();
+
+    uint32 size = last + PADDING;
+    m_x.resize(size);
+    m_y.resize(size);
+    m_reach.resize(size);
+    m_kind.resize(size);
+    m_phaseMask.resize(size);
+
+    object->SetCellIndex(nullptr, 0);
+}
+
+void CellObjectIndex::Update(WorldObject const* object)
+{
+    Write(object->GetCellIndexSlot(), object);
+}
+
+void CellObjectIndex::Write(uint32 slot, WorldObject const* object)
+{
+    m_x[slot] = object->GetPositionX();
+    m_y[slot] = object->GetPositionY();
+    m_reach[slot] = std::max(object->GetObjectBoundingRadius(), object->GetCombatReach());
+    m_phaseMask[slot] = object->GetPhaseMask();
+}
+
+uint32 CellObjectIndex::Filter(CellIndexQuery const& query, uint32 first, uint32* slots) const
+{
+    uint32 end = std::min(first + QUERY_BATCH, GetCount());
+    uint32 found = 0;
+
+#ifdef CELL_INDEX_SSE
+    __m128 const x = _mm_set1_ps(query.x);
+    __m128 const y = _mm_set1_ps(query.y);
+    __m128 const range = _mm_set1_ps(query.range);
+    __m128i const typeMask = _mm_set1_epi32(int32(query.typeMask));
+    __m128i const containerMask = _mm_set1_epi32(int32(query.containerMask << CONTAINER_SHIFT));
+    __m128i const phaseMask = _mm_set1_epi32(int32(query.phaseMask));
+    __m128i const zero = _mm_setzero_si128();
+
+    // the padding lets the last group read past the last object, its lanes are masked out below
+    for (uint32 i = first; i < end; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&m_x[i]), x);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&m_y[i]), y);
+        __m128 reach = _mm_add_ps(_mm_loadu_ps(&m_reach[i]), range);
+        __m128 inRange = _mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(reach, reach));
+
+        __m128i kinds = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&m_kind[i]));
+        __m128i phases = _mm_loadu_si128(reinterpret_cast<__m128i const*>(&m_phaseMask[i]));
+        // lanes where any of the masks shares no bit
+        __m128i rejected = _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(kinds, typeMask), zero),
+                                        _mm_or_si128(_mm_cmpeq_epi32(_mm_and_si128(kinds, containerMask), zero),
+                                                     _mm_cmpeq_epi32(_mm_and_si128(phases, phaseMask), zero)));
+
+        int accepted = _mm_movemask_ps(_mm_andnot_ps(_mm_castsi128_ps(rejected), inRange));
+        for (uint32 lane = 0; accepted; ++lane, accepted >>= 1)
+            if ((accepted & 1) && i + lane < end)
+                slots[found++] = i + lane;
+    }
+#else
+    uint32 const containerMask = query.containerMask << CONTAINER_SHIFT;
+    for (uint32 i = first; i < end; ++i)
+    {
+        if (!(m_kind[i] & query.typeMask) || !(m_kind[i] & containerMask) || !(m_phaseMask[i] & query.phaseMask))
+            continue;
+
+        float dx = m_x[i] - query.x;
+        float dy = m_y[i] - query.y;
+        float reach = m_reach[i] + query.range;
+        if (dx * dx + dy * dy <= reach * reach)
+            slots[found++] = i;
+    }
+#endif
+
+    return found;
+}
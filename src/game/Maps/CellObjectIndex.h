@@ -0,0 +1,97 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _CELL_OBJECT_INDEX_H_INCLUDED
+#define _CELL_OBJECT_INDEX_H_INCLUDED
+
+#include "Common.h"
+
+#include <vector>
+
+class WorldObject;
+
+// container of the grid an object is listed in
+enum CellIndexContainer
+{
+    CELL_INDEX_GRID_OBJECTS     = 0x01,                     // GridTypeMapContainer: creatures, game objects, dynamic objects, bones
+    CELL_INDEX_WORLD_OBJECTS    = 0x02,                     // WorldTypeMapContainer: players, pets, corpses
+    CELL_INDEX_ALL_OBJECTS      = CELL_INDEX_GRID_OBJECTS | CELL_INDEX_WORLD_OBJECTS
+};
+
+// Objects wanted from the indexes of a cell area: of a type in typeMask, listed in a container of
+// containerMask, sharing a phase with phaseMask and at most range yards plus their own reach away from x, y
+// in 2D. It only prefilters, the searcher still checks every object it is given.
+struct CellIndexQuery
+{
+    float x, y;
+    float range;
+    uint32 typeMask;
+    uint32 containerMask;
+    uint32 phaseMask;
+};
+
+// Positions of the objects of one cell, kept as arrays of coordinates next to the cell's object lists so a
+// range search can reject most of a crowded cell without touching the objects themselves. Entries are
+// updated whenever an object is relocated or changes phase or size, and removal moves the last entry into
+// the freed slot, so the order is not the one of the cell's lists.
+class CellObjectIndex
+{
+    public:
+        CellObjectIndex() {}
+        CellObjectIndex(CellObjectIndex const&) = delete;
+        CellObjectIndex& operator=(CellObjectIndex const&) = delete;
+        // objects still listed, if their grid is dropped without removing them, forget their entry
+        ~CellObjectIndex();
+
+        void Add(WorldObject* object, uint32 container);
+        void Remove(WorldObject* object);
+        void Update(WorldObject const* object);
+
+        uint32 GetCount() const { return uint32(m_objects.size()); }
+
+        // calls visit for every object passing the query; objects must not be added to or removed from the
+        // cell meanwhile
+        template<class F> void Query(CellIndexQuery const& query, F&& visit) const
+        {
+            uint32 slots[QUERY_BATCH];
+            for (uint32 first = 0; first < GetCount(); first += QUERY_BATCH)
+            {
+                uint32 found = Filter(query, first, slots);
+                for (uint32 i = 0; i < found; ++i)
+                    visit(m_objects[slots[i]]);
+            }
+        }
+
+    private:
+        static uint32 const QUERY_BATCH = 64;
+        // entries past the last object, so the last group of four is read without checks
+        static uint32 const PADDING = 3;
+
+        // writes the slots passing the query among the QUERY_BATCH ones starting at first, returns their count
+        uint32 Filter(CellIndexQuery const& query, uint32 first, uint32* slots) const;
+        void Write(uint32 slot, WorldObject const* object);
+
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_reach;                         // largest of bounding radius and combat reach
+        std::vector<uint32> m_kind;                         // TYPEMASK_* of the object, its container shifted by 16
+        std::vector<uint32> m_phaseMask;
+        std::vector<WorldObject*> m_objects;
+};
+
+#endif
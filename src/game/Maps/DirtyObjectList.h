@@ -0,0 +1,102 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _DIRTY_OBJECT_LIST_H_INCLUDED
+#define _DIRTY_OBJECT_LIST_H_INCLUDED
+
+#include "Common.h"
+#include "Entities/Object.h"
+
+#include <atomic>
+#include <vector>
+
+// Set of objects waiting for a client update, stored as a plain vector. Each object remembers in its
+// DirtyListSlot the generation of the list it was added to and its index there, so adding, finding and
+// removing an object never hashes nor allocates a node. Generations are unique over all lists and are
+// renewed whenever the content is taken out, which unlists all taken objects at once. Removed objects
+// leave a null entry behind.
+class DirtyObjectList
+{
+    public:
+        explicit DirtyObjectList(DirtyListType type) : m_type(type), m_generation(NewGeneration()) {}
+
+        void Add(Object* obj)
+        {
+            DirtyListSlot& slot = obj->m_dirtyListSlots[m_type];
+            if (slot.generation == m_generation)
+                return;
+
+            slot.generation = m_generation;
+            slot.index = uint32(m_objects.size());
+            m_objects.push_back(obj);
+        }
+
+        void Remove(Object* obj)
+        {
+            DirtyListSlot& slot = obj->m_dirtyListSlots[m_type];
+            if (slot.generation != m_generation)
+                return;
+
+            slot.generation = 0;
+            m_objects[slot.index] = nullptr;
+        }
+
+        bool Contains(Object const* obj) const { return obj->m_dirtyListSlots[m_type].generation == m_generation; }
+        bool IsEmpty() const { return m_objects.empty(); }
+
+        // visits the listed objects in insertion order, objects added meanwhile included. An object is
+        // unlisted right before its visit, so it may be added again by it.
+        template <class Visitor>
+        void Drain(Visitor&& visitor)
+        {
+            for (size_t i = 0; i < m_objects.size(); ++i)
+            {
+                Object* obj = m_objects[i];
+                if (!obj)
+                    continue;
+
+                obj->m_dirtyListSlots[m_type].generation = 0;
+                m_objects[i] = nullptr;
+                visitor(obj);
+            }
+
+            m_objects.clear();
+        }
+
+        // moves the listed objects out, may contain null entries. Objects added afterwards go to a new generation.
+        void Take(std::vector<Object*>& objects)
+        {
+            objects.clear();
+            std::swap(objects, m_objects);
+            m_generation = NewGeneration();
+        }
+
+    private:
+        static uint32 NewGeneration()
+        {
+            static std::atomic<uint32> generation(0);
+            uint32 value = ++generation;
+            return value ? value : ++generation;            // 0 is never listed
+        }
+
+        DirtyListType m_type;
+        uint32 m_generation;
+        std::vector<Object*> m_objects;
+};
+
+#endif
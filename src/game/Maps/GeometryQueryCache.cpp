@@ -0,0 +1,230 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "Maps/GeometryQueryCache.h"
+#include "World/World.h"
+
+#include <G3D/AABox.h>
+
+#ifdef BUILD_METRICS
+ #include "Metric/Instrument.h"
+#endif
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <string>
+
+static uint32 const GEOMETRY_QUERY_CACHE_SIZE = 1024;       // entries per thread, power of 2
+
+static int32 QuantizeCoord(float coord)
+{
+    return int32(std::floor(coord / GEOMETRY_QUERY_PRECISION));
+}
+
+GeometryQueryKey::GeometryQueryKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool ignoreM2Model) :
+    coords{ QuantizeCoord(x1), QuantizeCoord(y1), QuantizeCoord(z1), QuantizeCoord(x2), QuantizeCoord(y2), QuantizeCoord(z2) },
+    phasemask(phasemask), flags((GEOMETRY_QUERY_LINE_OF_SIGHT << 1) | (ignoreM2Model ? 1 : 0))
+{
+}
+
+GeometryQueryKey::GeometryQueryKey(float x, float y, float z, uint32 phasemask, bool swim) :
+    coords{ QuantizeCoord(x), QuantizeCoord(y), QuantizeCoord(z), 0, 0, 0 },
+    phasemask(phasemask), flags((GEOMETRY_QUERY_HEIGHT << 1) | (swim ? 1 : 0))
+{
+}
+
+bool GeometryQueryKey::operator==(GeometryQueryKey const& other) const
+{
+    for (uint32 i = 0; i < 6; ++i)
+        if (coords[i] != other.coords[i])
+            return false;
+
+    return phasemask == other.phasemask && flags == other.flags;
+}
+
+namespace
+{
+    struct GeometryQueryEntry
+    {
+        GeometryQueryStamp stamp;
+        GeometryQueryKey key;
+        float result = 0.0f;
+    };
+
+    // last tick stamp handed out, stamps are unique across all maps so entries never need to know their map
+    std::atomic<uint64> s_lastStamp(0);
+
+    GeometryQueryEntry* GetThreadEntries()
+    {
+        static thread_local std::unique_ptr<GeometryQueryEntry[]> entries;
+        if (!entries)
+            entries.reset(new GeometryQueryEntry[GEOMETRY_QUERY_CACHE_SIZE]);
+        return entries.get();
+    }
+
+    uint32 GetSlot(GeometryQueryKey const& key)
+    {
+        uint64 hash = key.phasemask ^ (uint64(key.flags) << 32);
+        for (int32 coord : key.coords)
+            hash = (hash ^ uint32(coord)) * 0x9E3779B97F4A7C15ULL;
+        return uint32(hash >> 32) & (GEOMETRY_QUERY_CACHE_SIZE - 1);
+    }
+}
+
+GeometryQueryCache::GeometryQueryCache(uint32 mapId, uint32 instanceId) : m_stamp(0), m_regionCount(0)
+{
+#ifdef BUILD_METRICS
+    static char const* const typeNames[MAX_GEOMETRY_QUERY_TYPES] = { "los", "height" };
+
+    std::map<std::string, std::string> tags = { { "map_id", std::to_string(mapId) }, { "instance_id", std::to_string(instanceId) } };
+    for (uint32 i = 0; i < MAX_GEOMETRY_QUERY_TYPES; ++i)
+    {
+        m_hits[i] = 0;
+        m_misses[i] = 0;
+
+        tags["query"] = typeNames[i];
+        m_hitMetrics[i] = std::make_unique<metric::counter>("map.geometry_cache.hit", tags);
+        m_missMetrics[i] = std::make_unique<metric::counter>("map.geometry_cache.miss", tags);
+    }
+#else
+    (void)mapId;
+    (void)instanceId;
+#endif
+}
+
+GeometryQueryCache::~GeometryQueryCache() = default;
+
+void GeometryQueryCache::PrepareTick()
+{
+    m_regionCount.store(0, std::memory_order_relaxed);
+    m_stamp.store(sWorld.getConfig(CONFIG_BOOL_MAP_GEOMETRY_CACHE) ? ++s_lastStamp : 0, std::memory_order_relaxed);
+}
+
+void GeometryQueryCache::FinishTick()
+{
+    // queries between two ticks are not cached, the map may be changed from outside of its update
+    m_stamp.store(0, std::memory_order_relaxed);
+
+#ifdef BUILD_METRICS
+    for (uint32 i = 0; i < MAX_GEOMETRY_QUERY_TYPES; ++i)
+    {
+        if (uint32 hits = m_hits[i].exchange(0, std::memory_order_relaxed))
+            m_hitMetrics[i]->add(double(hits));
+        if (uint32 misses = m_misses[i].exchange(0, std::memory_order_relaxed))
+            m_missMetrics[i]->add(double(misses));
+    }
+#endif
+}
+
+void GeometryQueryCache::Invalidate(G3D::AABox const& bounds)
+{
+    if (!m_stamp.load(std::memory_order_relaxed))
+        return;
+
+    std::lock_guard<std::mutex> guard(m_regionLock);
+
+    uint32 count = m_regionCount.load(std::memory_order_relaxed);
+    if (count == MAX_REGIONS)
+    {
+        m_stamp.store(++s_lastStamp, std::memory_order_relaxed);
+        return;
+    }
+
+    Region& region = m_regions[count];
+    for (int i = 0; i < 3; ++i)
+    {
+        region.low[i] = bounds.low()[i];
+        region.high[i] = bounds.high()[i];
+    }
+
+    // published after being written, regions below the count are never written again during the tick
+    m_regionCount.store(count + 1, std::memory_order_release);
+}
+
+bool GeometryQueryCache::IsChanged(GeometryQueryKey const& key, uint32 firstRegion, uint32 regions) const
+{
+    // box covered by the query: the segment between both positions, or the whole column for heights
+    float low[3];
+    float high[3];
+    if ((key.flags >> 1) == GEOMETRY_QUERY_LINE_OF_SIGHT)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            low[i] = std::min(key.coords[i], key.coords[i + 3]) * GEOMETRY_QUERY_PRECISION;
+            high[i] = (std::max(key.coords[i], key.coords[i + 3]) + 1) * GEOMETRY_QUERY_PRECISION;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            low[i] = key.coords[i] * GEOMETRY_QUERY_PRECISION;
+            high[i] = (key.coords[i] + 1) * GEOMETRY_QUERY_PRECISION;
+        }
+        low[2] = -FLT_MAX;
+        high[2] = FLT_MAX;
+    }
+
+    for (uint32 r = firstRegion; r < regions; ++r)
+    {
+        Region const& region = m_regions[r];
+        if (low[0] <= region.high[0] && high[0] >= region.low[0] &&
+                low[1] <= region.high[1] && high[1] >= region.low[1] &&
+                low[2] <= region.high[2] && high[2] >= region.low[2])
+            return true;
+    }
+    return false;
+}
+
+bool GeometryQueryCache::Find(GeometryQueryType type, GeometryQueryKey const& key, float& result, GeometryQueryStamp& stamp) const
+{
+    stamp.tick = m_stamp.load(std::memory_order_relaxed);
+    if (!stamp.tick)
+        return false;
+    stamp.regions = m_regionCount.load(std::memory_order_acquire);
+
+    GeometryQueryEntry const& entry = GetThreadEntries()[GetSlot(key)];
+    bool found = entry.stamp.tick == stamp.tick && entry.key == key && !IsChanged(key, entry.stamp.regions, stamp.regions);
+    if (found)
+        result = entry.result;
+
+#ifdef BUILD_METRICS
+    (found ? m_hits : m_misses)[type].fetch_add(1, std::memory_order_relaxed);
+#else
+    (void)type;
+#endif
+    return found;
+}
+
+void GeometryQueryCache::Store(GeometryQueryKey const& key, GeometryQueryStamp const& stamp, float result) const
+{
+    if (!stamp.tick || stamp.tick != m_stamp.load(std::memory_order_relaxed))
+        return;
+
+    // a region changed while the result was computed, it may be outdated already
+    uint32 regions = m_regionCount.load(std::memory_order_acquire);
+    if (IsChanged(key, stamp.regions, regions))
+        return;
+
+    GeometryQueryEntry& entry = GetThreadEntries()[GetSlot(key)];
+    entry.stamp = stamp;
+    entry.key = key;
+    entry.result = result;
+}
@@ -0,0 +1,119 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _GEOMETRY_QUERY_CACHE_H_INCLUDED
+#define _GEOMETRY_QUERY_CACHE_H_INCLUDED
+
+#include "Common.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+namespace G3D
+{
+    class AABox;
+}
+
+namespace metric
+{
+    class counter;
+}
+
+enum GeometryQueryType
+{
+    GEOMETRY_QUERY_LINE_OF_SIGHT    = 0,
+    GEOMETRY_QUERY_HEIGHT           = 1,
+    MAX_GEOMETRY_QUERY_TYPES
+};
+
+#define GEOMETRY_QUERY_PRECISION 0.125f
+
+// Query of Map::IsInLineOfSight or Map::GetHeight, with positions rounded to GEOMETRY_QUERY_PRECISION yards
+struct GeometryQueryKey
+{
+    GeometryQueryKey() : coords(), phasemask(0), flags(0) {}
+    GeometryQueryKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, bool ignoreM2Model);
+    GeometryQueryKey(float x, float y, float z, uint32 phasemask, bool swim);
+
+    bool operator==(GeometryQueryKey const& other) const;
+
+    int32 coords[6];
+    uint32 phasemask;
+    uint32 flags;
+};
+
+// What a missed query must store its result with: the tick and the changes of the map known when it was looked up
+struct GeometryQueryStamp
+{
+    uint64 tick = 0;
+    uint32 regions = 0;
+};
+
+// Remembers the results of line of sight and height queries of a map for the rest of its tick, as the same
+// positions are checked again and again by spells hitting the same targets, AI target selection and
+// movement. When a game object model of the map is added, removed or has its collision changed, the results
+// whose query touches its bounds are forgotten; transports move their model every tick, so forgetting all
+// results would leave nothing cached on their maps. Entries live in a small table per thread, so the object
+// updates of a map running in parallel never share one; each is stamped with the tick it was stored in and
+// the number of changed regions known then, so a new tick or a change needs no clearing.
+class GeometryQueryCache
+{
+    public:
+        GeometryQueryCache(uint32 mapId, uint32 instanceId);
+        ~GeometryQueryCache();
+
+        // called at the start of a tick, results are only cached while MapUpdate.GeometryCache is set
+        void PrepareTick();
+        // called at the end of a tick, results are forgotten
+        void FinishTick();
+        // forgets the results of queries touching bounds, thread safe
+        void Invalidate(G3D::AABox const& bounds);
+
+        // thread safe; a missed query gets the stamp its result must be stored with, so a result computed
+        // while its region changed is dropped instead of outliving the change
+        bool Find(GeometryQueryType type, GeometryQueryKey const& key, float& result, GeometryQueryStamp& stamp) const;
+        void Store(GeometryQueryKey const& key, GeometryQueryStamp const& stamp, float result) const;
+
+    private:
+        static uint32 const MAX_REGIONS = 64;               // changes per tick, past them every change forgets all results
+
+        struct Region
+        {
+            float low[3];
+            float high[3];
+        };
+
+        bool IsChanged(GeometryQueryKey const& key, uint32 firstRegion, uint32 regions) const;
+
+        std::atomic<uint64> m_stamp;                        // tick results are stored for, 0 while disabled
+
+        std::mutex m_regionLock;                            // serialises changes, lookups read the published regions
+        Region m_regions[MAX_REGIONS];                      // bounds changed in the current tick, only reset between ticks
+        std::atomic<uint32> m_regionCount;
+
+#ifdef BUILD_METRICS
+        mutable std::atomic<uint32> m_hits[MAX_GEOMETRY_QUERY_TYPES];
+        mutable std::atomic<uint32> m_misses[MAX_GEOMETRY_QUERY_TYPES];
+
+        std::unique_ptr<metric::counter> m_hitMetrics[MAX_GEOMETRY_QUERY_TYPES];
+        std::unique_ptr<metric::counter> m_missMetrics[MAX_GEOMETRY_QUERY_TYPES];
+#endif
+};
+
+#endif
@@ -28,7 +28,9 @@
 #include "World/World.h"
 #include "Policies/Singleton.h"
 #include "Util/Util.h"
+#include "Util/MappedFile.h"
 
+#include <cstring>
 #include <mutex>
 
 char const* MAP_MAGIC         = "MAPS";
@@ -82,141 +84,155 @@ bool GridMap::loadData(char const* filename)
     // Unload old data if exist
     unloadData();
 
-    GridMapFileHeader header;
     // Not return error if file not found
-    FILE* in = fopen(filename, "rb");
-    if (!in)
+    m_file = MappedFile::Open(filename);
+    if (!m_file)
     {
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Failled to found %s", filename);
         // its a valid error only in case of no vmap files are available too
         return true;
     }
 
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    GridMapFileHeader const* header = getSection<GridMapFileHeader>(0, 1);
+    if (!header)
     {
         sLog.outError("Error loading GridMapFileHeader\n");
-        fclose(in);
+        unloadData();
         return false;
     }
 
-    if (header.mapMagic == *((uint32 const*)(MAP_MAGIC)) &&
-            header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
-            IsAcceptableClientBuild(header.buildMagic))
+    if (header->mapMagic == *((uint32 const*)(MAP_MAGIC)) &&
+            header->versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)) &&
+            IsAcceptableClientBuild(header->buildMagic))
     {
         // loadup area data
-        if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
+        if (header->areaMapOffset && !loadAreaData(header->areaMapOffset, header->areaMapSize))
         {
             sLog.outError("Error loading map area data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup height data
-        if (header.heightMapOffset && !loadHeightData(in, header.heightMapOffset, header.heightMapSize))
+        if (header->heightMapOffset && !loadHeightData(header->heightMapOffset, header->heightMapSize))
         {
             sLog.outError("Error loading map height data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup liquid data
-        if (header.liquidMapOffset && !loadGridMapLiquidData(in, header.liquidMapOffset, header.liquidMapSize))
+        if (header->liquidMapOffset && !loadGridMapLiquidData(header->liquidMapOffset, header->liquidMapSize))
         {
             sLog.outError("Error loading map liquids data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
         // loadup holes data (if any. check header.holesOffset)
-        if (header.holesOffset && !loadHolesData(in, header.holesOffset, header.holesSize))
+        if (header->holesOffset && !loadHolesData(header->holesOffset, header->holesSize))
         {
             sLog.outError("Error loading map holes data\n");
-            fclose(in);
+            unloadData();
             return false;
         }
 
-        fclose(in);
         return true;
     }
 
     sLog.outError("Map file '%s' has the wrong version. Please extract the mapfiles again with the latest extractors.", filename);
-    fclose(in);
+    unloadData();
     return false;
 }
 
 void GridMap::unloadData()
 {
-    if (m_area_map)    { delete[] m_area_map;    m_area_map = nullptr; }
-    if (m_V9)          { delete[] m_V9;          m_V9 = nullptr; }
-    if (m_V8)          { delete[] m_V8;          m_V8 = nullptr; }
-    if (m_liquidEntry) { delete[] m_liquidEntry; m_liquidEntry = nullptr; }
-    if (m_liquidFlags) { delete[] m_liquidFlags; m_liquidFlags = nullptr; }
-    if (m_liquid_map)  { delete[] m_liquid_map;  m_liquid_map = nullptr; }
-    if (m_holes)       { delete[] m_holes;       m_holes = nullptr; }
+    m_area_map = nullptr;
+    m_V9 = nullptr;
+    m_V8 = nullptr;
+    m_liquidEntry = nullptr;
+    m_liquidFlags = nullptr;
+    m_liquid_map = nullptr;
+    m_holes = nullptr;
+
+    m_copies.clear();
+    m_file.reset();
 
     m_gridGetHeight = &GridMap::getHeightFromFlat;
 }
 
-bool GridMap::loadAreaData(FILE* in, uint32 offset, uint32 /*size*/)
+template<typename T>
+T* GridMap::getSection(uint32 offset, size_t count)
 {
-    GridMapAreaHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
+    if (offset > m_file->GetSize() || count * sizeof(T) > m_file->GetSize() - offset)
+        return nullptr;
+
+    unsigned char* data = m_file->GetData() + offset;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) == 0)
+        return reinterpret_cast<T*>(data);
+
+    // sections following 8 bit heights are not aligned in the file
+    m_copies.emplace_back(new unsigned char[count * sizeof(T) + alignof(T)]);
+    unsigned char* copy = m_copies.back().get();
+    copy += (alignof(T) - reinterpret_cast<uintptr_t>(copy) % alignof(T)) % alignof(T);
+    memcpy(copy, data, count * sizeof(T));
+    return reinterpret_cast<T*>(copy);
+}
+
+bool GridMap::loadAreaData(uint32 offset, uint32 /*size*/)
+{
+    GridMapAreaHeader const* header = getSection<GridMapAreaHeader>(offset, 1);
+    if (!header)
         return false;
-    if (header.fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+    if (header->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
         return false;
 
-    m_gridArea = header.gridArea;
-    if (!(header.flags & MAP_AREA_NO_AREA))
+    m_gridArea = header->gridArea;
+    if (!(header->flags & MAP_AREA_NO_AREA))
     {
-        m_area_map = new uint16 [16 * 16];
-        if (fread(m_area_map, sizeof(uint16), 16 * 16, in) != 16 * 16)
+        m_area_map = getSection<uint16>(offset + sizeof(GridMapAreaHeader), 16 * 16);
+        if (!m_area_map)
             return false;
     }
 
     return true;
 }
 
-bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHeightData(uint32 offset, uint32 /*size*/)
 {
-    GridMapHeightHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
+    GridMapHeightHeader const* header = getSection<GridMapHeightHeader>(offset, 1);
+    if (!header)
         return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
-        return false;
-    if (header.fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+    if (header->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
         return false;
 
-    m_gridHeight = header.gridHeight;
-    if (!(header.flags & MAP_HEIGHT_NO_HEIGHT))
+    offset += sizeof(GridMapHeightHeader);
+    m_gridHeight = header->gridHeight;
+    if (!(header->flags & MAP_HEIGHT_NO_HEIGHT))
     {
-        if ((header.flags & MAP_HEIGHT_AS_INT16))
+        if ((header->flags & MAP_HEIGHT_AS_INT16))
         {
-            m_uint16_V9 = new uint16[129 * 129];
-            m_uint16_V8 = new uint16[128 * 128];
-            if (fread(m_uint16_V9, sizeof(uint16), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint16_V8, sizeof(uint16), 128 * 128, in) != 128 * 128)
+            m_uint16_V9 = getSection<uint16>(offset, 129 * 129);
+            m_uint16_V8 = getSection<uint16>(offset + sizeof(uint16) * 129 * 129, 128 * 128);
+            if (!m_uint16_V9 || !m_uint16_V8)
                 return false;
-            m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 65535;
+            m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 65535;
             m_gridGetHeight = &GridMap::getHeightFromUint16;
         }
-        else if ((header.flags & MAP_HEIGHT_AS_INT8))
+        else if ((header->flags & MAP_HEIGHT_AS_INT8))
         {
-            m_uint8_V9 = new uint8[129 * 129];
-            m_uint8_V8 = new uint8[128 * 128];
-            if (fread(m_uint8_V9, sizeof(uint8), 129 * 129, in) != 129 * 129 ||
-                    fread(m_uint8_V8, sizeof(uint8), 128 * 128, in) != 128 * 128)
+            m_uint8_V9 = getSection<uint8>(offset, 129 * 129);
+            m_uint8_V8 = getSection<uint8>(offset + sizeof(uint8) * 129 * 129, 128 * 128);
+            if (!m_uint8_V9 || !m_uint8_V8)
                 return false;
-            m_gridIntHeightMultiplier = (header.gridMaxHeight - header.gridHeight) / 255;
+            m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 255;
             m_gridGetHeight = &GridMap::getHeightFromUint8;
         }
         else
         {
-            m_V9 = new float[129 * 129];
-            m_V8 = new float[128 * 128];
-            if (fread(m_V9, sizeof(float), 129 * 129, in) != 129 * 129 ||
-                    fread(m_V8, sizeof(float), 128 * 128, in) != 128 * 128)
+            m_V9 = getSection<float>(offset, 129 * 129);
+            m_V8 = getSection<float>(offset + sizeof(float) * 129 * 129, 128 * 128);
+            if (!m_V9 || !m_V8)
                 return false;
             m_gridGetHeight = &GridMap::getHeightFromFloat;
         }
@@ -227,47 +243,42 @@ bool GridMap::loadHeightData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
-bool GridMap::loadHolesData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadHolesData(uint32 offset, uint32 /*size*/)
 {
-    if (fseek(in, offset, SEEK_SET) != 0)
-        return false;
-    m_holes = new uint16[16 * 16];
-    return fread(m_holes, sizeof(uint16), 16 * 16, in) == 16 * 16;
+    m_holes = getSection<uint16>(offset, 16 * 16);
+    return m_holes != nullptr;
 }
 
-bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
+bool GridMap::loadGridMapLiquidData(uint32 offset, uint32 /*size*/)
 {
-    GridMapLiquidHeader header;
-    if (fseek(in, offset, SEEK_SET) != 0)
+    GridMapLiquidHeader const* header = getSection<GridMapLiquidHeader>(offset, 1);
+    if (!header)
         return false;
-    if (fread(&header, sizeof(header), 1, in) != 1)
-        return false;
-    if (header.fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+    if (header->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
         return false;
 
-    m_liquidGlobalEntry = header.liquidType;
-    m_liquidGlobalFlags = header.liquidFlags;
-    m_liquid_offX   = header.offsetX;
-    m_liquid_offY   = header.offsetY;
-    m_liquid_width  = header.width;
-    m_liquid_height = header.height;
-    m_liquidLevel   = header.liquidLevel;
+    m_liquidGlobalEntry = header->liquidType;
+    m_liquidGlobalFlags = header->liquidFlags;
+    m_liquid_offX   = header->offsetX;
+    m_liquid_offY   = header->offsetY;
+    m_liquid_width  = header->width;
+    m_liquid_height = header->height;
+    m_liquidLevel   = header->liquidLevel;
 
-    if (!(header.flags & MAP_LIQUID_NO_TYPE))
+    offset += sizeof(GridMapLiquidHeader);
+    if (!(header->flags & MAP_LIQUID_NO_TYPE))
     {
-        m_liquidEntry = new uint16[16 * 16];
-        if (fread(m_liquidEntry, sizeof(uint16), 16 * 16, in) != 16 * 16)
-            return false;
-
-        m_liquidFlags = new uint8[16 * 16];
-        if (fread(m_liquidFlags, sizeof(uint8), 16 * 16, in) != 16 * 16)
+        m_liquidEntry = getSection<uint16>(offset, 16 * 16);
+        m_liquidFlags = getSection<uint8>(offset + sizeof(uint16) * 16 * 16, 16 * 16);
+        if (!m_liquidEntry || !m_liquidFlags)
             return false;
+        offset += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
     }
 
-    if (!(header.flags & MAP_LIQUID_NO_HEIGHT))
+    if (!(header->flags & MAP_LIQUID_NO_HEIGHT))
     {
-        m_liquid_map = new float[m_liquid_width * m_liquid_height];
-        if (fread(m_liquid_map, sizeof(float), m_liquid_width * m_liquid_height, in) != size_t(m_liquid_width * m_liquid_height))
+        m_liquid_map = getSection<float>(offset, m_liquid_width * m_liquid_height);
+        if (!m_liquid_map)
             return false;
     }
 
@@ -1351,6 +1362,22 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y, bool mapOnl
                 //assert(false);
             }
 
+            // players reaching this grid are likely to go on into the next ones
+            if (sWorld.getConfig(CONFIG_BOOL_GRID_PREFETCH))
+            {
+                for (uint32 nx = x > 0 ? x - 1 : x; nx <= x + 1 && nx < MAX_NUMBER_OF_GRIDS; ++nx)
+                {
+                    for (uint32 ny = y > 0 ? y - 1 : y; ny <= y + 1 && ny < MAX_NUMBER_OF_GRIDS; ++ny)
+                    {
+                        if (m_GridMaps[nx][ny] || (nx == x && ny == y))
+                            continue;
+
+                        snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, nx, ny);
+                        MappedFile::Prefetch(tmp);
+                    }
+                }
+            }
+
             delete[] tmp;
             m_GridMaps[x][y] = map;
         }
@@ -27,9 +27,12 @@
 #include "Maps/GridMapDefines.h"
 
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 class Creature;
+class MappedFile;
 class Unit;
 class WorldPacket;
 class InstanceData;
@@ -84,10 +87,17 @@ class GridMap
         // For fast check
         bool m_fullyLoaded;
 
-        bool loadAreaData(FILE* in, uint32 offset, uint32 size);
-        bool loadHeightData(FILE* in, uint32 offset, uint32 size);
-        bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
-        bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        // the map file, height, area, liquid and holes arrays point into it
+        std::shared_ptr<MappedFile> m_file;
+        // arrays not aligned in the file are copied here
+        std::vector<std::unique_ptr<unsigned char[]>> m_copies;
+
+        // count values at offset of the file, nullptr past its end
+        template<typename T> T* getSection(uint32 offset, size_t count);
+        bool loadAreaData(uint32 offset, uint32 size);
+        bool loadHeightData(uint32 offset, uint32 size);
+        bool loadGridMapLiquidData(uint32 offset, uint32 size);
+        bool loadHolesData(uint32 offset, uint32 size);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -18,6 +18,7 @@
 
 #include "Maps/Map.h"
 #include "Maps/MapManager.h"
+#include "Maps/MapWorkers.h"
 #include "Entities/Player.h"
 #include "Grids/GridNotifiers.h"
 #include "Log/Log.h"
@@ -44,9 +45,11 @@
 #include "Vmap/GameObjectModel.h"
 #include "LFG/LFGMgr.h"
 #include "BattleGround/BattleGroundMgr.h"
+#include "Util/CodeBench.h"
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Metric/Instrument.h"
 #endif
 
 #ifdef ENABLE_PLAYERBOTS
@@ -167,6 +170,7 @@ void Map::SetNavTile(uint32 tileX, uint32 tileY, uint32 tileNumber)
     if (!mmap->IsEnabled())
         return;
 
+    auto guard = LockNavMeshWrite();
     mmap->ChangeTile(sWorld.GetDataPath(), GetId(), GetInstanceId(), tileX, tileY, tileNumber);
 }
 
@@ -215,6 +219,7 @@ void Map::ChangeGOPathfinding(uint32 entry, uint32 displayId, bool apply)
     MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
     if (!mmap->IsEnabled())
         return;
+    auto guard = LockNavMeshWrite();
     for (auto dataXY : tileIds)
     {
         uint32 tileX = dataXY.first;
@@ -243,16 +248,20 @@ void Map::LoadMapAndVMap(int gx, int gy)
         m_bLoadedGrids[gx][gy] = true;
 
     if (MMAP::MMapFactory::createOrGetMMapManager()->IsEnabled())
+    {
+        auto guard = LockNavMeshWrite();
         if (!MMAP::MMapFactory::createOrGetMMapManager()->IsMMapTileLoaded(GetId(), GetInstanceId(), gx, gy))
             MMAP::MMapFactory::createOrGetMMapManager()->loadMap(sWorld.GetDataPath(), GetId(), GetInstanceId(), gx, gy, 0);
+    }
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
-    : i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
-      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), m_clientUpdateTimer(0),
+    : m_objectsToClientUpdate(DIRTY_LIST_VALUES), m_objectsToClientCreateUpdate(DIRTY_LIST_CREATE), m_objectsToClientMovementUpdate(DIRTY_LIST_MOVEMENT),
+      i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode),
+      i_id(id), i_InstanceId(InstanceId), m_unloadTimer(0), m_clientUpdateTimer(0), m_predictedUpdateCost(0), m_lastUpdatedObjectCount(0), m_lastUpdateDataSize(0), m_updateBudget(id, InstanceId), m_geometryCache(id, InstanceId),
       m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), m_persistentState(nullptr),
       m_activeNonPlayersIter(m_activeNonPlayers.end()), m_onEventNotifiedIter(m_onEventNotifiedObjects.end()),
-      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)),
+      i_gridExpiry(expiry), m_TerrainData(sTerrainMgr.LoadTerrain(id)), m_parallelObjectUpdate(false),
       i_data(nullptr), i_script_id(0), m_transportsIterator(m_transports.begin()), m_defaultLight(GetDefaultMapLight(id)), m_spawnManager(*this),
 #ifdef ENABLE_PLAYERBOTS
       m_activeZonesTimer(0), hasRealPlayers(false),
@@ -261,6 +270,14 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode)
 {
     m_weatherSystem = new WeatherSystem(this);
     m_transportGuids.Set(sMapMgr.GetTransportCounter());
+
+#ifdef BUILD_METRICS
+    std::map<std::string, std::string> tags = { { "map_id", std::to_string(i_id) }, { "instance_id", std::to_string(i_InstanceId) } };
+    m_updateMetric = std::make_unique<metric::histogram>("map.update", tags);
+    m_sessionUpdateMetric = std::make_unique<metric::histogram>("map.update.session", tags);
+    m_sessionCountMetric = std::make_unique<metric::gauge>("map.update.session.count", tags);
+    m_updatedObjectsMetric = std::make_unique<metric::gauge>("map.update.count", tags);
+#endif
 }
 
 void Map::Initialize(bool loadInstanceData /*= true*/)
@@ -321,6 +338,7 @@ template<class T>
 void Map::AddToGrid(T* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).AddGridObject<T>(obj);
+    AddToCellIndex(obj, cell, CELL_INDEX_GRID_OBJECTS);
 }
 
 template<>
@@ -328,12 +346,14 @@ void Map::AddToGrid(GameObject* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).AddGridObject<GameObject>(obj);
     obj->SetCurrentCell(cell);
+    AddToCellIndex(obj, cell, CELL_INDEX_GRID_OBJECTS);
 }
 
 template<>
 void Map::AddToGrid(Player* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).AddWorldObject(obj);
+    AddToCellIndex(obj, cell, CELL_INDEX_WORLD_OBJECTS);
 }
 
 template<>
@@ -343,11 +363,13 @@ void Map::AddToGrid(Corpse* obj, NGridType* grid, Cell const& cell)
     if (obj->GetType() != CORPSE_BONES)
     {
         (*grid)(cell.CellX(), cell.CellY()).AddWorldObject(obj);
+        AddToCellIndex(obj, cell, CELL_INDEX_WORLD_OBJECTS);
     }
     // add to grid object store
     else
     {
         (*grid)(cell.CellX(), cell.CellY()).AddGridObject(obj);
+        AddToCellIndex(obj, cell, CELL_INDEX_GRID_OBJECTS);
     }
 }
 
@@ -359,12 +381,14 @@ void Map::AddToGrid(Creature* obj, NGridType* grid, Cell const& cell)
     {
         (*grid)(cell.CellX(), cell.CellY()).AddWorldObject<Creature>(obj);
         obj->SetCurrentCell(cell);
+        AddToCellIndex(obj, cell, CELL_INDEX_WORLD_OBJECTS);
     }
     // add to grid object store
     else
     {
         (*grid)(cell.CellX(), cell.CellY()).AddGridObject<Creature>(obj);
         obj->SetCurrentCell(cell);
+        AddToCellIndex(obj, cell, CELL_INDEX_GRID_OBJECTS);
     }
 }
 
@@ -372,12 +396,14 @@ template<class T>
 void Map::RemoveFromGrid(T* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).RemoveGridObject<T>(obj);
+    RemoveFromCellIndex(obj);
 }
 
 template<>
 void Map::RemoveFromGrid(Player* obj, NGridType* grid, Cell const& cell)
 {
     (*grid)(cell.CellX(), cell.CellY()).RemoveWorldObject(obj);
+    RemoveFromCellIndex(obj);
 }
 
 template<>
@@ -393,6 +419,7 @@ void Map::RemoveFromGrid(Corpse* obj, NGridType* grid, Cell const& cell)
     {
         (*grid)(cell.CellX(), cell.CellY()).RemoveGridObject(obj);
     }
+    RemoveFromCellIndex(obj);
 }
 
 template<>
@@ -408,6 +435,25 @@ void Map::RemoveFromGrid(Creature* obj, NGridType* grid, Cell const& cell)
     {
         (*grid)(cell.CellX(), cell.CellY()).RemoveGridObject<Creature>(obj);
     }
+    RemoveFromCellIndex(obj);
+}
+
+void Map::AddToCellIndex(WorldObject* obj, Cell const& cell, uint32 container)
+{
+    // never listed twice, whatever way the object left its previous cell
+    RemoveFromCellIndex(obj);
+
+    std::unique_ptr<CellObjectIndex[]>& indexes = m_cellIndexes[cell.GridX()][cell.GridY()];
+    if (!indexes)
+        indexes.reset(new CellObjectIndex[MAX_NUMBER_OF_CELLS * MAX_NUMBER_OF_CELLS]);
+
+    indexes[cell.CellX() * MAX_NUMBER_OF_CELLS + cell.CellY()].Add(obj, container);
+}
+
+void Map::RemoveFromCellIndex(WorldObject* obj)
+{
+    if (CellObjectIndex* index = obj->GetCellIndex())
+        index->Remove(obj);
 }
 
 void Map::DeleteFromWorld(Player* pl)
@@ -466,6 +512,10 @@ void Map::EnsureGridLoadedAtEnter(const Cell& cell, Player* player)
 
 bool Map::EnsureGridLoaded(const Cell& cell)
 {
+    if (m_gridObjectsReady[cell.GridX()][cell.GridY()].load(std::memory_order_acquire))
+        return false;
+
+    auto guard = LockCrossCell();
     EnsureGridCreated(GridPair(cell.GridX(), cell.GridY()));
     NGridType* grid = getNGrid(cell.GridX(), cell.GridY());
 
@@ -483,6 +533,7 @@ bool Map::EnsureGridLoaded(const Cell& cell)
 
         // Add resurrectable corpses to world object list in grid
         sObjectAccessor.AddCorpsesToGrid(GridPair(cell.GridX(), cell.GridY()), (*grid)(cell.CellX(), cell.CellY()), this);
+        m_gridObjectsReady[cell.GridX()][cell.GridY()].store(true, std::memory_order_release);
         return true;
     }
 
@@ -571,6 +622,7 @@ void Map::Add(T* obj)
         return;
     }
 
+    auto guard = LockCrossCell();
     obj->SetMap(this);
 
     Cell cell(p);
@@ -754,6 +806,11 @@ void Map::ExecuteMapWorkerArea(uint32 areaId, std::function<void(Player*)> const
 
 bool Map::loaded(const GridPair& p) const
 {
+    if (m_gridObjectsReady[p.x_coord][p.y_coord].load(std::memory_order_acquire))
+        return true;
+
+    // a grid being loaded counts as loaded for the thread loading it
+    auto guard = LockCrossCell();
     return (getNGrid(p.x_coord, p.y_coord) && isGridObjectDataLoaded(p.x_coord, p.y_coord));
 }
 
@@ -786,14 +843,17 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<MaNGOS::Obje
 
 void Map::Update(const uint32& t_diff)
 {
+    PROFILE_ZONE("Map::Update");
+
+    auto tickStart = std::chrono::steady_clock::now();
+    m_updateBudget.PrepareTick(*this);
+
     m_clientUpdateTimer += t_diff;
+    m_lastUpdateDataSize = 0;
     if (IsUpdateObjectTick())
         ++m_clientUpdateTick;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::milliseconds> meas("map.update", {
-        { "map_id", std::to_string(i_id) },
-        { "instance_id", std::to_string(i_InstanceId) }
-});
+    metric::timer<std::chrono::milliseconds> meas(*m_updateMetric);
 #endif
 
     m_curTime = time(nullptr);
@@ -805,6 +865,7 @@ void Map::Update(const uint32& t_diff)
 #endif
 
     m_dyn_tree.update(t_diff);
+    m_geometryCache.PrepareTick();
 
     GetMessager().Execute(this);
     m_spawnManager.Update();
@@ -829,10 +890,7 @@ void Map::Update(const uint32& t_diff)
     {
 #ifdef BUILD_METRICS
         uint32 updatedSessions = 0;
-        metric::duration<std::chrono::milliseconds> sessions_meas("map.update.session", {
-            { "map_id", std::to_string(i_id) },
-            { "instance_id", std::to_string(i_InstanceId) },
-            });
+        metric::timer<std::chrono::milliseconds> sessions_meas(*m_sessionUpdateMetric);
 #endif
 
         for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -849,7 +907,7 @@ void Map::Update(const uint32& t_diff)
 #endif
         }
 #ifdef BUILD_METRICS
-        sessions_meas.add_field("count", std::to_string(static_cast<int32>(updatedSessions)));
+        m_sessionCountMetric->set(updatedSessions);
 #endif
     }
 
@@ -1049,8 +1107,8 @@ void Map::Update(const uint32& t_diff)
                 continue;
 
 #ifdef ENABLE_PLAYERBOTS
-            // Skip objects on locations away from real players if world is laggy
-            if (!sPlayerbotAIConfig.disableBotOptimizations && IsContinent() && avgDiff > 100)
+            // Skip objects on locations away from real players if world is laggy, unless MapUpdate.TickBudget throttles them
+            if (!sPlayerbotAIConfig.disableBotOptimizations && IsContinent() && avgDiff > 100 && !m_updateBudget.IsEnabled())
             {
                 const bool isInActiveZone = IsContinent() ? HasActiveZone(obj->GetZoneId()) : HasRealPlayers();
                 if (!isInActiveZone && !shouldUpdateObjects)
@@ -1128,10 +1186,15 @@ void Map::Update(const uint32& t_diff)
         }
     }
 
-    uint64 count = PerformObjectUpdate(t_diff, objToUpdate);
+    uint64 count;
+    if (sWorld.getConfig(CONFIG_BOOL_MAP_PARALLEL_CELL_UPDATE) && IsContinent() && objToUpdate.size() >= MIN_PARALLEL_CELL_UPDATE_OBJECTS && sMapMgr.GetMapUpdater().thread_count() > 1)
+        count = PerformParallelObjectUpdate(t_diff, objToUpdate);
+    else
+        count = PerformObjectUpdate(t_diff, objToUpdate);
+    m_lastUpdatedObjectCount = uint32(count);
 
 #ifdef BUILD_METRICS
-    meas.add_field("count", std::to_string(static_cast<int32>(count)));
+    m_updatedObjectsMetric->set(double(count));
 #endif
 
     // Process necessary scripts
@@ -1165,6 +1228,38 @@ void Map::Update(const uint32& t_diff)
     }
 
     m_weatherSystem->UpdateWeathers(t_diff);
+
+    m_geometryCache.FinishTick();
+    m_updateBudget.FinishTick(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count()));
+}
+
+bool Map::UpdateWorldObject(WorldObject* object, uint32 t_diff)
+{
+    MapUpdateBudget& budget = object->GetMap()->m_updateBudget;
+    UpdateBucket bucket = UPDATE_BUCKET_ACTIVE;
+    if (budget.IsEnabled())
+    {
+        bucket = budget.GetBucket(object);
+
+        // left out of this tick while the map is over budget, the diff is handed to its next update
+        if (object->GetAccumulatedUpdateDiff() + t_diff < budget.GetInterval(bucket))
+        {
+            object->AddAccumulatedUpdateDiff(t_diff);
+            budget.CountUpdate(bucket, false);
+            return false;
+        }
+    }
+
+    if (uint32 accumulatedDiff = object->ShouldPerformObjectUpdate(t_diff))
+    {
+        object->Update(accumulatedDiff);
+        object->ResetAccumulatedUpdateDiff();
+        object->UpdateNextUpdateTime();
+        if (budget.IsEnabled())
+            budget.CountUpdate(bucket, true);
+        return true;
+    }
+    return false;
 }
 
 uint64 Map::PerformObjectUpdate(uint32 t_diff, WorldObjectUnSet& objToUpdate)
@@ -1172,16 +1267,116 @@ uint64 Map::PerformObjectUpdate(uint32 t_diff, WorldObjectUnSet& objToUpdate)
     uint64 count = 0;
     // update all objects
     for (WorldObject* object : objToUpdate)
+        if (UpdateWorldObject(object, t_diff))
+            ++count;
+    return count;
+}
+
+bool Map::HasCrossBatchRelations(WorldObject const* object)
+{
+    switch (object->GetTypeId())
     {
-        if (uint32 accumulatedDiff = object->ShouldPerformObjectUpdate(t_diff))
+        case TYPEID_DYNAMICOBJECT:
+            return true;                                    // ticks into its caster
+        case TYPEID_GAMEOBJECT:
         {
-            object->Update(accumulatedDiff);
-            object->ResetAccumulatedUpdateDiff();
-            object->UpdateNextUpdateTime();
+            ObjectGuid const& owner = object->GetOwnerGuid();
+            return (!owner.IsEmpty() && owner != object->GetObjectGuid()) || !object->GetSpawnerGuid().IsEmpty();
+        }
+        case TYPEID_UNIT:
+        case TYPEID_PLAYER:
+            break;
+        default:
+            return false;
+    }
 
-            ++count;
+    Unit const* unit = static_cast<Unit const*>(object);
+
+    // combat state and threat are kept on both sides, at any distance
+    if (unit->IsInCombat() || !unit->getThreatManager().isThreatListEmpty() || !unit->getHostileRefManager().isEmpty())
+        return true;
+
+    // owner, pet, charm, summon, vehicle and channel links
+    if (!unit->GetOwnerGuid().IsEmpty() || !unit->GetSpawnerGuid().IsEmpty() || !unit->GetPetGuid().IsEmpty() ||
+            unit->HasCharm() || unit->HasCharmer() || unit->HasMiniPet() || unit->HasChannelObject() ||
+            unit->HasGuardians() || unit->IsBoarded() || unit->GetVehicleInfo())
+        return true;
+
+    for (uint32 i = 0; i < MAX_TOTEM_SLOT; ++i)
+        if (!unit->GetTotemGuid(TotemSlot(i)).IsEmpty())
+            return true;
+
+    // auras of other casters deal their damage, threat and procs through the caster
+    for (auto const& holder : unit->GetSpellAuraHolderMap())
+        if (holder.second->GetCasterGuid() != unit->GetObjectGuid())
+            return true;
+
+    // group wide buffs and member updates, duels are ended from either side
+    if (unit->GetTypeId() == TYPEID_PLAYER)
+    {
+        Player const* player = static_cast<Player const*>(unit);
+        if (player->GetGroup() || player->duel)
+            return true;
+    }
+
+    return false;
+}
+
+uint64 Map::PerformParallelObjectUpdate(uint32 t_diff, WorldObjectUnSet& objToUpdate)
+{
+    // Objects are batched per grid. Grids are split in four phases by the parity of their coordinates,
+    // so two batches of the same phase are always at least one whole grid (533 yards) apart and their
+    // searches, spells and relocations cannot reach each other. Relations which are not bound by distance,
+    // as auras of far casters, threat, combat and owner links, can, so objects having any of them are
+    // updated alone after all phases. Side effects which are map wide (client update lists, grid loading,
+    // add/remove, scripts) are serialised through LockCrossCell.
+    std::vector<WorldObject*> related;
+    std::map<uint32, std::vector<WorldObject*>> phases[4];
+    for (WorldObject* object : objToUpdate)
+    {
+        if (HasCrossBatchRelations(object))
+        {
+            related.push_back(object);
+            continue;
         }
+
+        GridPair p = MaNGOS::ComputeGridPair(object->GetPositionX(), object->GetPositionY());
+        uint32 phase = (p.x_coord & 1) | ((p.y_coord & 1) << 1);
+        phases[phase][p.x_coord * MAX_NUMBER_OF_GRIDS + p.y_coord].push_back(object);
     }
+
+    MapUpdater& updater = sMapMgr.GetMapUpdater();
+    uint64 count = 0;
+
+    m_parallelObjectUpdate = true;
+    for (auto& phase : phases)
+    {
+        if (phase.empty())
+            continue;
+
+        // shared with the crawlers, which may be picked up from the queue after this phase already finished
+        auto batches = std::make_shared<GridCrawlerBatches>(t_diff);
+        batches->batches.reserve(phase.size());
+        for (auto& gridBatch : phase)
+            batches->batches.push_back(std::move(gridBatch.second));
+        batches->SetBatchCount(batches->batches.size());
+
+        size_t helpers = std::min(batches->batches.size() - 1, updater.thread_count());
+        for (size_t i = 0; i < helpers; ++i)
+            updater.schedule_update(new BatchCrawler(batches, updater));
+
+        // map thread crawls too, so the phase finishes even when every updater thread is busy with other maps
+        batches->Crawl();
+        batches->Wait();
+
+        count += batches->updated;
+    }
+    m_parallelObjectUpdate = false;
+
+    for (WorldObject* object : related)
+        if (UpdateWorldObject(object, t_diff))
+            ++count;
+
     return count;
 }
 
@@ -1199,9 +1394,9 @@ void Map::Remove(Player* player, bool remove)
     else
         player->RemoveFromWorld();
 
-    m_objectsToClientUpdate.erase(player);
-    m_objectsToClientCreateUpdate.erase({ player , player->GetObjectGuid() });
-    m_objectsToClientMovementUpdate.erase(player);
+    m_objectsToClientUpdate.Remove(player);
+    m_objectsToClientCreateUpdate.Remove(player);
+    m_objectsToClientMovementUpdate.Remove(player);
     m_visibilityAdded.erase(player);
 
     // this may be called during Map::Update
@@ -1253,6 +1448,7 @@ void Map::Remove(Player* player, bool remove)
 template<class T>
 void Map::Remove(T* obj, bool remove)
 {
+    auto guard = LockCrossCell();
     CellPair p = MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY());
     if (p.x_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP || p.y_coord >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
     {
@@ -1281,9 +1477,9 @@ void Map::Remove(T* obj, bool remove)
     else
         obj->RemoveFromWorld();
 
-    m_objectsToClientUpdate.erase(obj);
-    m_objectsToClientCreateUpdate.erase({ obj, obj->GetObjectGuid() });
-    m_objectsToClientMovementUpdate.erase(obj);
+    m_objectsToClientUpdate.Remove(obj);
+    m_objectsToClientCreateUpdate.Remove(obj);
+    m_objectsToClientMovementUpdate.Remove(obj);
     m_visibilityAdded.erase(obj);
 
     RemoveFromGrid(obj, grid, cell);
@@ -1347,6 +1543,7 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
 
 void Map::CreatureRelocation(Creature* creature, float x, float y, float z, float ang)
 {
+    auto guard = LockCrossCell();
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
 
     // do move or do move to respawn or remove creature if previous all fail
@@ -1367,6 +1564,7 @@ void Map::CreatureRelocation(Creature* creature, float x, float y, float z, floa
 
 void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float orientation, bool respawnRelocationOnFail)
 {
+    auto guard = LockCrossCell();
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
     Cell old_cell = go->GetCurrentCell();
 
@@ -1400,6 +1598,7 @@ void Map::GameObjectRelocation(GameObject* go, float x, float y, float z, float
 
 void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float z, float orientation)
 {
+    auto guard = LockCrossCell();
     Cell new_cell(MaNGOS::ComputeCellPair(x, y));
     Cell old_cell = dynObj->GetCurrentCell();
 
@@ -1545,6 +1744,7 @@ bool Map::UnloadGrid(const uint32& x, const uint32& y, bool pForce)
 
         delete getNGrid(x, y);
         setNGrid(nullptr, x, y);
+        m_cellIndexes[x][y].reset();
     }
 
     int gx = (MAX_NUMBER_OF_GRIDS - 1) - x;
@@ -1851,10 +2051,12 @@ inline void Map::setNGrid(NGridType* grid, uint32 x, uint32 y)
         MANGOS_ASSERT(false);
     }
     i_grids[x][y] = grid;
+    m_gridObjectsReady[x][y].store(false, std::memory_order_release);
 }
 
 void Map::AddObjectToRemoveList(WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     MANGOS_ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
     obj->CleanupsBeforeDelete();                            // remove or simplify at least cross referenced links
@@ -1866,6 +2068,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
 void Map::RemoveObjectFromRemoveList(WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     i_objectsToRemove.erase(obj);
     obj->m_inRemoveList = false;
 }
@@ -1985,6 +2188,7 @@ bool Map::ActiveObjectsNearGrid(uint32 x, uint32 y) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     m_activeNonPlayers.insert(obj);
     Cell cell = Cell(MaNGOS::ComputeCellPair(obj->GetPositionX(), obj->GetPositionY()));
     EnsureGridLoaded(cell);
@@ -2013,6 +2217,7 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     // Map::Update for active object in proccess
     if (m_activeNonPlayersIter != m_activeNonPlayers.end())
     {
@@ -2567,6 +2772,7 @@ bool Map::CanEnter(Player* player)
 /// Put scripts in the execution queue
 bool Map::ScriptsStart(ScriptMapType scriptType, uint32 id, Object* source, Object* target, ScriptExecutionParam execParams /*=SCRIPT_EXEC_PARAM_UNIQUE_BY_SOURCE_TARGET*/)
 {
+    auto guard = LockCrossCell();
     MANGOS_ASSERT(source);
 
     ///- Find the script map
@@ -2699,6 +2905,7 @@ Player* Map::GetPlayer(ObjectGuid guid)
  */
 Creature* Map::GetCreature(ObjectGuid guid)
 {
+    auto guard = LockObjectsStoreRead();
     return m_objectsStore.find<Creature>(guid, (Creature*)nullptr);
 }
 
@@ -2709,6 +2916,7 @@ Creature* Map::GetCreature(ObjectGuid guid)
  */
 Pet* Map::GetPet(ObjectGuid guid)
 {
+    auto guard = LockObjectsStoreRead();
     return m_objectsStore.find<Pet>(guid, (Pet*)nullptr);
 }
 
@@ -2750,6 +2958,7 @@ Creature* Map::GetAnyTypeCreature(ObjectGuid guid)
  */
 GameObject* Map::GetGameObject(ObjectGuid guid)
 {
+    auto guard = LockObjectsStoreRead();
     return m_objectsStore.find<GameObject>(guid, (GameObject*)nullptr);
 }
 
@@ -2760,6 +2969,7 @@ GameObject* Map::GetGameObject(ObjectGuid guid)
  */
 DynamicObject* Map::GetDynamicObject(ObjectGuid guid)
 {
+    auto guard = LockObjectsStoreRead();
     return m_objectsStore.find<DynamicObject>(guid, (DynamicObject*)nullptr);
 }
 
@@ -2810,28 +3020,24 @@ void Map::UpdateVisibility(UpdateDataMapType& update_players)
     // newly created npcs are done every tick
     std::unordered_set<Object*> visited;
     {
-        std::set<std::pair<Object*, ObjectGuid>> createObjects;
-        std::swap(createObjects, m_objectsToClientCreateUpdate);
-        for (auto& createObj : createObjects)
+        m_objectsToClientCreateUpdate.Take(m_dirtyObjectsBuffer);
+        for (Object* createObj : m_dirtyObjectsBuffer)
         {
-            createObj.first->UpdateVisibility(update_players);
-            visited.insert(createObj.first);
+            if (createObj && visited.insert(createObj).second)
+                createObj->UpdateVisibility(update_players);
         }
     }
 
     if (m_clientUpdateTick % 3 == 0) // every 1200ms update vis on moved objects
     {
-        std::set<Object*> movementObjects;
-        std::swap(movementObjects, m_objectsToClientMovementUpdate);
-        for (auto& movObj : movementObjects)
+        m_objectsToClientMovementUpdate.Take(m_dirtyObjectsBuffer);
+        for (Object* movObj : m_dirtyObjectsBuffer)
         {
-            if (visited.find(movObj) == visited.end())
-            {
+            if (movObj && visited.insert(movObj).second)
                 movObj->UpdateVisibility(update_players);
-                visited.insert(movObj);
-            }
         }
     }
+    m_dirtyObjectsBuffer.clear();
 
     if (m_clientUpdateTick % 6 == 0) // every 2400ms update vis on large and gigantic objects
     {
@@ -2862,14 +3068,17 @@ void Map::UpdateVisibility(UpdateDataMapType& update_players)
 
 void Map::SendObjectUpdates()
 {
+    PROFILE_ZONE("Map::SendObjectUpdates");
+
     UpdateDataMapType update_players;
+    UpdateBlockCache cache;                                 // blocks are built once per object and field set
 
-    while (!m_objectsToClientUpdate.empty()) // do it first to avoid sending update and create to same obj
+    // do it first to avoid sending update and create to same obj
+    m_objectsToClientUpdate.Drain([&update_players, &cache](Object* obj)
     {
-        Object* obj = *m_objectsToClientUpdate.begin();
-        m_objectsToClientUpdate.erase(m_objectsToClientUpdate.begin());
-        obj->BuildUpdateData(update_players);
-    }
+        cache.Clear();
+        obj->BuildUpdateData(update_players, cache);
+    });
 
     UpdateVisibility(update_players);
 
@@ -2877,9 +3086,11 @@ void Map::SendObjectUpdates()
         std::unordered_map<Object*, PlayerSet> visibilityAdded;
         std::swap(visibilityAdded, m_visibilityAdded);
         for (auto& visData : visibilityAdded)
-        {               
+        {
+            cache.Clear();
+            UpdateBlockCache* sharedCache = visData.second.size() > 1 ? &cache : nullptr;
             for (Player* player : visData.second)
-                visData.first->BuildCreateDataForPlayer(player, update_players, false);
+                visData.first->BuildCreateDataForPlayer(player, update_players, false, sharedCache);
 
             if (visData.first->IsUnit())
             {
@@ -2906,12 +3117,46 @@ void Map::SendObjectUpdates()
         }
     }
 
+    for (auto& update_player : update_players)
+        m_lastUpdateDataSize += update_player.second.GetBlockDataSize();
+
+    if (sWorld.getConfig(CONFIG_BOOL_MAP_PARALLEL_PACKET_BUILD) && update_players.size() >= MIN_PARALLEL_PACKET_BUILD_PLAYERS && sMapMgr.GetMapUpdater().thread_count() > 1)
+    {
+        SendObjectUpdatesParallel(update_players);
+        return;
+    }
+
     for (auto& update_player : update_players)
     {
         update_player.second.SendData(*update_player.first->GetSession());
     }
 }
 
+void Map::SendObjectUpdatesParallel(UpdateDataMapType& update_players)
+{
+    // packets are built and compressed by the map update threads, but still sent from this thread in player order
+    auto batches = std::make_shared<UpdatePacketBatches>();
+    batches->batches.reserve(update_players.size());
+    for (auto& update_player : update_players)
+        batches->batches.emplace_back(&update_player.second, std::vector<WorldPacket>());
+    batches->SetBatchCount(batches->batches.size());
+
+    MapUpdater& updater = sMapMgr.GetMapUpdater();
+    size_t helpers = std::min(batches->batches.size() - 1, updater.thread_count());
+    for (size_t i = 0; i < helpers; ++i)
+        updater.schedule_update(new BatchCrawler(batches, updater));
+
+    batches->Crawl();
+    batches->Wait();
+
+    size_t index = 0;
+    for (auto& update_player : update_players)
+    {
+        update_player.second.SendPackets(*update_player.first->GetSession(), batches->batches[index].second);
+        ++index;
+    }
+}
+
 Creature* Map::GetCreature(uint32 dbguid) const
 {
     auto itr = m_dbGuidObjects.find(std::make_pair(HIGHGUID_UNIT, dbguid));
@@ -3003,17 +3248,20 @@ GameObject* Map::GetGameObject(std::string stringId) const
 
 void Map::AddDbGuidObject(WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     m_dbGuidObjects[std::make_pair(HighGuid(obj->GetParentHigh()), obj->GetDbGuid())].push_back(obj);
 }
 
 void Map::RemoveDbGuidObject(WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     auto& vec = m_dbGuidObjects[std::make_pair(HighGuid(obj->GetParentHigh()), obj->GetDbGuid())];
     vec.erase(std::remove(vec.begin(), vec.end(), obj), vec.end());
 }
 
 void Map::AddStringIdObject(uint32 stringId, WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     auto& data = m_objectsPerStringId[stringId];
     data.worldObjects.push_back(obj);
     if (obj->IsCreature())
@@ -3024,6 +3272,7 @@ void Map::AddStringIdObject(uint32 stringId, WorldObject* obj)
 
 void Map::RemoveStringIdObject(uint32 stringId, WorldObject* obj)
 {
+    auto guard = LockCrossCell();
     auto& data = m_objectsPerStringId[stringId];
     data.worldObjects.erase(std::remove(data.worldObjects.begin(), data.worldObjects.end(), obj), data.worldObjects.end());
     if (obj->IsCreature())
@@ -3034,21 +3283,25 @@ void Map::RemoveStringIdObject(uint32 stringId, WorldObject* obj)
 
 void Map::AddUpdateRemoveObject(GuidSet& visible, ObjectGuid guid)
 {
+    auto guard = LockCrossCell();
     m_objectsToClientRemove.emplace_back(visible, guid);
 }
 
 void Map::AddUpdateRemoveObject(GuidSet&& visible, ObjectGuid guid)
 {
+    auto guard = LockCrossCell();
     m_objectsToClientRemove.emplace_back(visible, guid);
 }
 
 void Map::AddCreateAtClientObject(Player* player, Object* obj)
 {
+    auto guard = LockCrossCell();
     m_visibilityAdded[obj].insert(player);
 }
 
 void Map::AddCreateAtClientObjects(PlayerSet const& players, Object* obj)
 {
+    auto guard = LockCrossCell();
     m_visibilityAdded[obj].insert(players.begin(), players.end());
 }
 
@@ -3062,6 +3315,7 @@ void Map::AddCameraToWorld(WorldObject* obj)
 
 uint32 Map::GenerateLocalLowGuid(HighGuid guidhigh)
 {
+    auto guard = LockCrossCell();
     // TODO: for map local guid counters possible force reload map instead shutdown server at guid counter overflow
     switch (guidhigh)
     {
@@ -3185,8 +3439,16 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ, uint32 phasemask, bool ignoreM2Model) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    GeometryQueryKey key(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    float cached;
+    GeometryQueryStamp stamp;
+    if (m_geometryCache.Find(GEOMETRY_QUERY_LINE_OF_SIGHT, key, cached, stamp))
+        return cached != 0.0f;
+
+    bool result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ, ignoreM2Model)
+                  && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ, phasemask, ignoreM2Model);
+    m_geometryCache.Store(key, stamp, result ? 1.0f : 0.0f);
+    return result;
 }
 
 /**
@@ -3275,21 +3537,36 @@ bool Map::GetHeightInRange(uint32 phasemask, float x, float y, float& z, float m
 
 float Map::GetHeight(uint32 phasemask, float x, float y, float z, bool swim) const
 {
+    GeometryQueryKey key(x, y, z, phasemask, swim);
+    float height;
+    GeometryQueryStamp stamp;
+    if (m_geometryCache.Find(GEOMETRY_QUERY_HEIGHT, key, height, stamp))
+        return height;
+
     float staticHeight = m_TerrainData->GetHeightStatic(x, y, z, true, (swim ? DEFAULT_WATER_SEARCH : DEFAULT_HEIGHT_SEARCH));
 
     // Get Dynamic Height around static Height (if valid)
     float dynSearchHeight = 2.0f + (z < staticHeight ? staticHeight : z);
-    return std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask));
+    height = std::max<float>(staticHeight, m_dyn_tree.getHeight(x, y, dynSearchHeight, dynSearchHeight - staticHeight, phasemask));
+    m_geometryCache.Store(key, stamp, height);
+    return height;
 }
 
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    m_geometryCache.Invalidate(mdl.getBounds());
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    m_geometryCache.Invalidate(mdl.getBounds());
+}
+
+void Map::InvalidateGeometryQueries(const GameObjectModel& mdl)
+{
+    m_geometryCache.Invalidate(mdl.getBounds());
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -3510,11 +3787,13 @@ uint32 Map::SpawnedCountForEntry(uint32 entry)
 
 void Map::AddToSpawnCount(const ObjectGuid& guid)
 {
+    auto guard = LockCrossCell();
     m_spawnedCount[guid.GetEntry()].insert(guid);
 }
 
 void Map::RemoveFromSpawnCount(const ObjectGuid& guid)
 {
+    auto guard = LockCrossCell();
     m_spawnedCount[guid.GetEntry()].erase(guid);
 }
 
@@ -38,12 +38,18 @@
 #include "Globals/GraveyardManager.h"
 #include "Maps/SpawnManager.h"
 #include "Maps/MapDataContainer.h"
+#include "Maps/DirtyObjectList.h"
+#include "Maps/MapUpdateBudget.h"
+#include "Maps/GeometryQueryCache.h"
+#include "Maps/CellObjectIndex.h"
 #include "Util/UniqueTrackablePtr.h"
 #include "World/WorldStateVariableManager.h"
 
 #include <bitset>
 #include <functional>
 #include <list>
+#include <mutex>
+#include <shared_mutex>
 
 struct CreatureInfo;
 class Creature;
@@ -63,6 +69,9 @@ class WeatherSystem;
 class GenericTransport;
 namespace MaNGOS { struct ObjectUpdater; }
 class Transport;
+#ifdef BUILD_METRICS
+namespace metric { class histogram; class gauge; }
+#endif
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
@@ -122,6 +131,8 @@ struct ZoneDynamicInfo
 
 #define MIN_UNLOAD_DELAY      1                             // immediate unload
 #define UPDATE_TICK         400
+#define MIN_PARALLEL_CELL_UPDATE_OBJECTS 256                // below this object count a parallel cell update costs more than it saves
+#define MIN_PARALLEL_PACKET_BUILD_PLAYERS 16                // below this player count packets are built on the map thread only
 
 typedef std::unordered_map<uint32 /*zoneId*/, ZoneDynamicInfo> ZoneDynamicInfoMap;
 
@@ -159,6 +170,42 @@ class Map : public GridRefManager<NGridType>
         virtual void Update(const uint32&);
 
         uint64 PerformObjectUpdate(uint32 t_diff, WorldObjectUnSet& objToUpdate);
+        uint64 PerformParallelObjectUpdate(uint32 t_diff, WorldObjectUnSet& objToUpdate);
+        static bool UpdateWorldObject(WorldObject* object, uint32 t_diff);
+        // true when updating object may change objects at any distance, such objects are left out of parallel batches
+        static bool HasCrossBatchRelations(WorldObject const* object);
+
+        // exponentially smoothed duration of Update in microseconds, used by MapManager to schedule heavy maps first
+        uint32 GetPredictedUpdateCost() const { return m_predictedUpdateCost; }
+        void UpdateCostPrediction(uint32 cost) { m_predictedUpdateCost = uint32((uint64(m_predictedUpdateCost) * 7 + cost) / 8); }
+
+        // work done by the last Update: objects updated and bytes of update blocks built for clients, before compression
+        uint32 GetLastUpdatedObjectCount() const { return m_lastUpdatedObjectCount; }
+        uint64 GetLastUpdateDataSize() const { return m_lastUpdateDataSize; }
+
+        // serialises map wide side effects of object updates while cell batches are updated in parallel
+        std::unique_lock<std::recursive_mutex> LockCrossCell() const
+        {
+            return m_parallelObjectUpdate ? std::unique_lock<std::recursive_mutex>(m_crossCellLock) : std::unique_lock<std::recursive_mutex>();
+        }
+        // guid lookups of the batches against objects added or removed by others
+        std::shared_lock<std::shared_mutex> LockObjectsStoreRead() const
+        {
+            return m_parallelObjectUpdate ? std::shared_lock<std::shared_mutex>(m_objectsStoreLock) : std::shared_lock<std::shared_mutex>();
+        }
+        std::unique_lock<std::shared_mutex> LockObjectsStoreWrite() const
+        {
+            return m_parallelObjectUpdate ? std::unique_lock<std::shared_mutex>(m_objectsStoreLock) : std::unique_lock<std::shared_mutex>();
+        }
+        // path searches of the batches against navmesh tiles loaded or changed by others
+        std::shared_lock<std::shared_mutex> LockNavMeshRead() const
+        {
+            return m_parallelObjectUpdate ? std::shared_lock<std::shared_mutex>(m_navMeshLock) : std::shared_lock<std::shared_mutex>();
+        }
+        std::unique_lock<std::shared_mutex> LockNavMeshWrite() const
+        {
+            return m_parallelObjectUpdate ? std::unique_lock<std::shared_mutex>(m_navMeshLock) : std::unique_lock<std::shared_mutex>();
+        }
 
         void MessageBroadcast(Player const*, WorldPacket const&, bool to_self);
         void MessageBroadcast(WorldObject const*, WorldPacket const&);
@@ -184,6 +231,8 @@ class Map : public GridRefManager<NGridType>
         void CorpseRelocation(Corpse* corpse, float x, float y, float z, float orientation);
 
         template<class T, class CONTAINER> void Visit(const Cell& cell, TypeContainerVisitor<T, CONTAINER>& visitor);
+        // visits the objects of a loaded cell passing the query of its position index, never loads the grid
+        template<class T> void VisitCellIndex(const Cell& cell, CellIndexQuery const& query, T& visitor) const;
 
         bool IsRemovalGrid(float x, float y) const
         {
@@ -334,18 +383,28 @@ class Map : public GridRefManager<NGridType>
 
         typedef TypeUnorderedMapContainer<AllMapStoredObjectTypes, ObjectGuid> MapStoredObjectTypesContainer;
         MapStoredObjectTypesContainer& GetObjectsStore() { return m_objectsStore; }
+        template<class T> void InsertInObjectsStore(T* obj)
+        {
+            auto guard = LockObjectsStoreWrite();
+            m_objectsStore.insert<T>(obj->GetObjectGuid(), obj);
+        }
+        template<class T> void EraseFromObjectsStore(T* obj)
+        {
+            auto guard = LockObjectsStoreWrite();
+            m_objectsStore.erase<T>(obj->GetObjectGuid(), (T*)nullptr);
+        }
         std::map<uint32, uint32>& GetTempCreatures() { return m_tempCreatures; }
         std::map<uint32, uint32>& GetTempPets() { return m_tempPets; }
         
         // schedule for update object create change
-        void AddUpdateCreateObject(Object* obj) { m_objectsToClientCreateUpdate.insert({ obj, obj->GetObjectGuid() }); }
-        void RemoveUpdateCreateObject(Object* obj) { m_objectsToClientCreateUpdate.erase({ obj, obj->GetObjectGuid() }); }
+        void AddUpdateCreateObject(Object* obj) { auto guard = LockCrossCell(); m_objectsToClientCreateUpdate.Add(obj); }
+        void RemoveUpdateCreateObject(Object* obj) { auto guard = LockCrossCell(); m_objectsToClientCreateUpdate.Remove(obj); }
         // schedule for update object values change
-        void AddUpdateObject(Object* obj) { m_objectsToClientUpdate.insert(obj); }
-        void RemoveUpdateObject(Object* obj) { m_objectsToClientUpdate.erase(obj); }
+        void AddUpdateObject(Object* obj) { auto guard = LockCrossCell(); m_objectsToClientUpdate.Add(obj); }
+        void RemoveUpdateObject(Object* obj) { auto guard = LockCrossCell(); m_objectsToClientUpdate.Remove(obj); }
         // schedule for update object visibility change
-        void AddUpdateMovementObject(Object* obj) { m_objectsToClientMovementUpdate.insert(obj); }
-        void RemoveUpdateMovementObject(Object* obj) { m_objectsToClientMovementUpdate.erase(obj); }
+        void AddUpdateMovementObject(Object* obj) { auto guard = LockCrossCell(); m_objectsToClientMovementUpdate.Add(obj); }
+        void RemoveUpdateMovementObject(Object* obj) { auto guard = LockCrossCell(); m_objectsToClientMovementUpdate.Remove(obj); }
         // schedule update object destruction of object
         void AddUpdateRemoveObject(GuidSet& visible, ObjectGuid guid);
         void AddUpdateRemoveObject(GuidSet&& visible, ObjectGuid guid);
@@ -379,6 +438,8 @@ class Map : public GridRefManager<NGridType>
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // a game object model of the map changed its collision, cached line of sight and heights within its bounds are outdated
+        void InvalidateGeometryQueries(const GameObjectModel& mdl);
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -509,9 +570,11 @@ class Map : public GridRefManager<NGridType>
 
         void UpdateVisibility(UpdateDataMapType& update_players);
         void SendObjectUpdates();
-        std::set<Object*> m_objectsToClientUpdate;
-        std::set<std::pair<Object*, ObjectGuid>> m_objectsToClientCreateUpdate;
-        std::set<Object*> m_objectsToClientMovementUpdate;
+        void SendObjectUpdatesParallel(UpdateDataMapType& update_players);
+        DirtyObjectList m_objectsToClientUpdate;
+        DirtyObjectList m_objectsToClientCreateUpdate;
+        DirtyObjectList m_objectsToClientMovementUpdate;
+        std::vector<Object*> m_dirtyObjectsBuffer;          // reused by UpdateVisibility to take the dirty lists out
         std::vector<std::pair<GuidSet, ObjectGuid>> m_objectsToClientRemove;
         std::unordered_map<Object*, PlayerSet> m_visibilityAdded;
 
@@ -528,6 +591,17 @@ class Map : public GridRefManager<NGridType>
         uint32 m_unloadTimer;
         uint32 m_clientUpdateTimer;
         uint32 m_clientUpdateTick;
+        uint32 m_predictedUpdateCost;
+        uint32 m_lastUpdatedObjectCount;
+        uint64 m_lastUpdateDataSize;
+        MapUpdateBudget m_updateBudget;
+        GeometryQueryCache m_geometryCache;
+#ifdef BUILD_METRICS
+        std::unique_ptr<metric::histogram> m_updateMetric;
+        std::unique_ptr<metric::histogram> m_sessionUpdateMetric;
+        std::unique_ptr<metric::gauge> m_sessionCountMetric;
+        std::unique_ptr<metric::gauge> m_updatedObjectsMetric;
+#endif
         float m_VisibleDistance;
         MapPersistentState* m_persistentState;
 
@@ -554,6 +628,10 @@ class Map : public GridRefManager<NGridType>
         tm m_curTimeTm;
 
         NGridType* i_grids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        // set once the objects of a grid are loaded, checked by the batches without LockCrossCell
+        std::atomic<bool> m_gridObjectsReady[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        // position indexes of the cells of a grid, created with its first object and dropped with the grid
+        std::unique_ptr<CellObjectIndex[]> m_cellIndexes[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         // Shared geodata object with map coord info...
         TerrainInfo* const m_TerrainData;
@@ -563,6 +641,12 @@ class Map : public GridRefManager<NGridType>
 
         WorldObjectSet i_objectsToRemove;
 
+        // intra-map parallel object update state, see PerformParallelObjectUpdate
+        bool m_parallelObjectUpdate;
+        mutable std::recursive_mutex m_crossCellLock;
+        mutable std::shared_mutex m_objectsStoreLock;
+        mutable std::shared_mutex m_navMeshLock;
+
         typedef std::multimap<TimePoint, ScriptAction> ScriptScheduleMap;
         ScriptScheduleMap m_scriptSchedule;
 
@@ -583,6 +667,8 @@ class Map : public GridRefManager<NGridType>
 
         template<class T>
         void RemoveFromGrid(T*, NGridType*, Cell const&);
+        void AddToCellIndex(WorldObject* obj, Cell const& cell, uint32 container);
+        void RemoveFromCellIndex(WorldObject* obj);
         // Holder for information about linked mobs
         CreatureLinkingHolder m_creatureLinkingHolder;
 
@@ -715,4 +801,20 @@ Map::Visit(const Cell& cell, TypeContainerVisitor<T, CONTAINER>& visitor)
         getNGrid(x, y)->Visit(cell_x, cell_y, visitor);
     }
 }
+
+template<class T>
+inline void
+Map::VisitCellIndex(const Cell& cell, CellIndexQuery const& query, T& visitor) const
+{
+    const uint32 x = cell.GridX();
+    const uint32 y = cell.GridY();
+
+    if (!m_cellIndexes[x][y] || !loaded(GridPair(x, y)))
+        return;
+
+    m_cellIndexes[x][y][cell.CellX() * MAX_NUMBER_OF_CELLS + cell.CellY()].Query(query, [&visitor](WorldObject* object)
+    {
+        visitor.VisitIndexed(object);
+    });
+}
 #endif
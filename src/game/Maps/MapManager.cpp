@@ -197,16 +197,29 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (auto& map : i_maps)
+    if (m_updater.activated())
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(new MapUpdateWorker(*map.second, (uint32)i_timer.GetCurrent(), m_updater));
-        else
-            map.second->Update((uint32)i_timer.GetCurrent());
-    }
+        // longest predicted update first, so a heavy continent is never the last job of the tick
+        std::vector<Map*> maps;
+        maps.reserve(i_maps.size());
+        for (auto& map : i_maps)
+            maps.push_back(map.second.get());
+
+        std::stable_sort(maps.begin(), maps.end(), [](Map const* left, Map const* right)
+        {
+            return left->GetPredictedUpdateCost() > right->GetPredictedUpdateCost();
+        });
+
+        for (Map* map : maps)
+            m_updater.schedule_update(new MapUpdateWorker(*map, (uint32)i_timer.GetCurrent(), m_updater), map->GetPredictedUpdateCost());
 
-    if (m_updater.activated())
         m_updater.wait();
+    }
+    else
+    {
+        for (auto& map : i_maps)
+            map.second->Update((uint32)i_timer.GetCurrent());
+    }
 
     // remove all maps which can be unloaded
     MapMapType::iterator iter = i_maps.begin();
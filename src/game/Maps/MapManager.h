@@ -164,6 +164,8 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
 
         uint32 GetTransportCounter() const { return m_transportCounter; }
 
+        MapUpdater& GetMapUpdater() { return m_updater; }
+
     private:
 
         // debugging code, should be deleted some day
@@ -0,0 +1,173 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "Maps/MapUpdateBudget.h"
+#include "Maps/Map.h"
+#include "Entities/Player.h"
+#include "World/World.h"
+
+#ifdef BUILD_METRICS
+ #include "Metric/Instrument.h"
+#endif
+
+#include <algorithm>
+
+// milliseconds between two updates of an object, per throttle level and bucket
+uint32 const MapUpdateBudget::m_intervals[MAX_UPDATE_BUDGET_LEVEL + 1][MAX_UPDATE_BUCKETS] =
+{
+    //  active  near   mid    far
+    {   0,      0,     0,     0    },
+    {   0,      0,     0,     400  },
+    {   0,      0,     200,   1000 },
+    {   0,      100,   400,   2000 },
+};
+
+static float const NEAR_BUCKET_DISTANCE = 40.0f;
+static float const MID_BUCKET_DISTANCE = 100.0f;
+static int32 const MID_BUCKET_CELL_REACH = int32(MID_BUCKET_DISTANCE / SIZE_OF_GRID_CELL) + 1;
+
+static uint32 const LEVEL_CHANGE_COOLDOWN = 10;             // ticks, so the effect of a level change is seen before the next one
+
+MapUpdateBudget::MapUpdateBudget(uint32 mapId, uint32 instanceId) : m_enabled(false), m_level(0), m_smoothedTickTime(0), m_ticksSinceLevelChange(0)
+{
+#ifdef BUILD_METRICS
+    static char const* const bucketNames[MAX_UPDATE_BUCKETS] = { "active", "near", "mid", "far" };
+
+    std::map<std::string, std::string> tags = { { "map_id", std::to_string(mapId) }, { "instance_id", std::to_string(instanceId) } };
+    m_levelMetric = std::make_unique<metric::gauge>("map.update.budget.level", tags);
+    for (uint32 i = 0; i < MAX_UPDATE_BUCKETS; ++i)
+    {
+        m_updated[i] = 0;
+        m_throttled[i] = 0;
+
+        tags["bucket"] = bucketNames[i];
+        m_updatedMetrics[i] = std::make_unique<metric::counter>("map.update.budget.updated", tags);
+        m_throttledMetrics[i] = std::make_unique<metric::counter>("map.update.budget.throttled", tags);
+    }
+#else
+    (void)mapId;
+    (void)instanceId;
+#endif
+}
+
+MapUpdateBudget::~MapUpdateBudget() = default;
+
+void MapUpdateBudget::PrepareTick(Map& map)
+{
+    m_playerCells.clear();
+    m_enabled = sWorld.getConfig(CONFIG_UINT32_MAP_TICK_BUDGET) != 0;
+    if (!m_enabled)
+        return;
+
+    for (auto const& ref : map.GetPlayers())
+    {
+        Player* player = ref.getSource();
+        if (!player || !player->IsInWorld())
+            continue;
+#ifdef ENABLE_PLAYERBOTS
+        if (!player->isRealPlayer())
+            continue;
+#endif
+
+        CellPair center = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
+        for (int32 dx = -MID_BUCKET_CELL_REACH; dx <= MID_BUCKET_CELL_REACH; ++dx)
+        {
+            for (int32 dy = -MID_BUCKET_CELL_REACH; dy <= MID_BUCKET_CELL_REACH; ++dy)
+            {
+                int32 x = int32(center.x_coord) + dx;
+                int32 y = int32(center.y_coord) + dy;
+                if (x < 0 || y < 0 || x >= TOTAL_NUMBER_OF_CELLS_PER_MAP || y >= TOTAL_NUMBER_OF_CELLS_PER_MAP)
+                    continue;
+
+                m_playerCells.push_back({ uint32(y * TOTAL_NUMBER_OF_CELLS_PER_MAP + x), player->GetPositionX(), player->GetPositionY() });
+            }
+        }
+    }
+
+    std::sort(m_playerCells.begin(), m_playerCells.end());
+}
+
+UpdateBucket MapUpdateBudget::GetBucket(WorldObject const* object) const
+{
+    if (object->isActiveObject())
+        return UPDATE_BUCKET_ACTIVE;
+
+    if (object->IsUnit())
+    {
+        Unit const* unit = static_cast<Unit const*>(object);
+        if (unit->IsPlayer() || unit->IsPlayerControlled() || unit->IsInCombat())
+            return UPDATE_BUCKET_ACTIVE;
+    }
+
+    CellPair cell = MaNGOS::ComputeCellPair(object->GetPositionX(), object->GetPositionY());
+    PlayerInCell key = { cell.y_coord * TOTAL_NUMBER_OF_CELLS_PER_MAP + cell.x_coord, 0.0f, 0.0f };
+    auto range = std::equal_range(m_playerCells.begin(), m_playerCells.end(), key);
+
+    float nearest = MID_BUCKET_DISTANCE * MID_BUCKET_DISTANCE;
+    for (auto itr = range.first; itr != range.second; ++itr)
+    {
+        float dx = itr->x - object->GetPositionX();
+        float dy = itr->y - object->GetPositionY();
+        nearest = std::min(nearest, dx * dx + dy * dy);
+    }
+
+    if (nearest < NEAR_BUCKET_DISTANCE * NEAR_BUCKET_DISTANCE)
+        return UPDATE_BUCKET_NEAR;
+    if (nearest < MID_BUCKET_DISTANCE * MID_BUCKET_DISTANCE)
+        return UPDATE_BUCKET_MID;
+    return UPDATE_BUCKET_FAR;
+}
+
+void MapUpdateBudget::FinishTick(uint32 tickTime)
+{
+    if (!m_enabled)
+    {
+        m_level = 0;
+        return;
+    }
+
+    uint32 budget = sWorld.getConfig(CONFIG_UINT32_MAP_TICK_BUDGET) * IN_MILLISECONDS;
+
+    m_smoothedTickTime = (m_smoothedTickTime * 7 + tickTime) / 8;
+    ++m_ticksSinceLevelChange;
+
+    if (m_ticksSinceLevelChange >= LEVEL_CHANGE_COOLDOWN)
+    {
+        if (m_smoothedTickTime > budget && m_level < MAX_UPDATE_BUDGET_LEVEL)
+        {
+            ++m_level;
+            m_ticksSinceLevelChange = 0;
+        }
+        else if (m_smoothedTickTime < budget * 3 / 4 && m_level > 0)
+        {
+            --m_level;
+            m_ticksSinceLevelChange = 0;
+        }
+    }
+
+#ifdef BUILD_METRICS
+    m_levelMetric->set(double(m_level));
+    for (uint32 i = 0; i < MAX_UPDATE_BUCKETS; ++i)
+    {
+        if (uint32 updated = m_updated[i].exchange(0, std::memory_order_relaxed))
+            m_updatedMetrics[i]->add(double(updated));
+        if (uint32 throttled = m_throttled[i].exchange(0, std::memory_order_relaxed))
+            m_throttledMetrics[i]->add(double(throttled));
+    }
+#endif
+}
@@ -0,0 +1,106 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef _MAP_UPDATE_BUDGET_H_INCLUDED
+#define _MAP_UPDATE_BUDGET_H_INCLUDED
+
+#include "Common.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class Map;
+class WorldObject;
+
+namespace metric
+{
+    class counter;
+    class gauge;
+}
+
+enum UpdateBucket
+{
+    UPDATE_BUCKET_ACTIVE    = 0,                            // players, pets, units in combat and active objects, never slowed down
+    UPDATE_BUCKET_NEAR      = 1,                            // closer than 40 yards to a player
+    UPDATE_BUCKET_MID       = 2,                            // closer than 100 yards to a player
+    UPDATE_BUCKET_FAR       = 3,
+    MAX_UPDATE_BUCKETS
+};
+
+#define MAX_UPDATE_BUDGET_LEVEL 3
+
+// Keeps the update of a map within MapUpdate.TickBudget. Objects are sorted in buckets by distance to the
+// nearest real player, and while the smoothed update time of the map stays over budget the throttle level
+// rises, which gives the far buckets longer intervals between their updates first. An object left out of a
+// tick keeps its diff accumulated, so it catches up on its next update. The level falls again once the map
+// is well below budget.
+class MapUpdateBudget
+{
+    public:
+        MapUpdateBudget(uint32 mapId, uint32 instanceId);
+        ~MapUpdateBudget();
+
+        // objects are only sorted in buckets while MapUpdate.TickBudget is set
+        bool IsEnabled() const { return m_enabled; }
+        uint32 GetLevel() const { return m_level; }
+
+        // called before the objects of a tick are updated
+        void PrepareTick(Map& map);
+        // called at the end of a tick with the time Map::Update took, in microseconds
+        void FinishTick(uint32 tickTime);
+
+        // thread safe between PrepareTick and FinishTick, objects may be updated in parallel
+        UpdateBucket GetBucket(WorldObject const* object) const;
+        uint32 GetInterval(UpdateBucket bucket) const { return m_intervals[m_level][bucket]; }
+#ifdef BUILD_METRICS
+        void CountUpdate(UpdateBucket bucket, bool updated) { (updated ? m_updated : m_throttled)[bucket].fetch_add(1, std::memory_order_relaxed); }
+#else
+        void CountUpdate(UpdateBucket /*bucket*/, bool /*updated*/) {}
+#endif
+
+    private:
+        struct PlayerInCell
+        {
+            uint32 cellId;
+            float x, y;
+
+            bool operator<(PlayerInCell const& other) const { return cellId < other.cellId; }
+        };
+
+        static uint32 const m_intervals[MAX_UPDATE_BUDGET_LEVEL + 1][MAX_UPDATE_BUCKETS];
+
+        bool m_enabled;
+        uint32 m_level;
+        uint32 m_smoothedTickTime;
+        uint32 m_ticksSinceLevelChange;
+
+        // real players listed in every cell within reach of the farthest bucket, sorted by cell
+        std::vector<PlayerInCell> m_playerCells;
+
+#ifdef BUILD_METRICS
+        std::atomic<uint32> m_updated[MAX_UPDATE_BUCKETS];
+        std::atomic<uint32> m_throttled[MAX_UPDATE_BUCKETS];
+
+        std::unique_ptr<metric::gauge> m_levelMetric;
+        std::unique_ptr<metric::counter> m_updatedMetrics[MAX_UPDATE_BUCKETS];
+        std::unique_ptr<metric::counter> m_throttledMetrics[MAX_UPDATE_BUCKETS];
+#endif
+};
+
+#endif
@@ -19,10 +19,12 @@
 #include "MapUpdater.h"
 #include "MapWorkers.h"
 
-MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0)
+// length of the window thread utilisation is measured over
+static const std::chrono::seconds MAP_UPDATER_UTILISATION_WINDOW(10);
+
+MapUpdater::MapUpdater(size_t num_threads) : _cancelationToken(false), pending_requests(0), queued_requests(0)
 {
-    for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+    activate(num_threads);
 }
 
 void MapUpdater::activate(size_t num_threads)
@@ -31,25 +33,45 @@ void MapUpdater::activate(size_t num_threads)
         return;
 
     for (size_t i = 0; i < num_threads; ++i)
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _queues.push_back(std::make_unique<WorkerQueue>());
+
+    _utilisationStart = std::chrono::steady_clock::now();
+    _utilisation.assign(num_threads, 0.0f);
+
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
 }
 
 void MapUpdater::deactivate()
 {
-    _cancelationToken = true;
-
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        _cancelationToken = true;
+        _queueCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
         thread.join();
+
+    for (auto& queue : _queues)
+    {
+        for (auto& job : queue->jobs)
+            delete job.first;
+        queue->jobs.clear();
+    }
 }
 
 void MapUpdater::wait()
 {
-    std::unique_lock<std::mutex> lock(_lock);
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+
+        while (pending_requests > 0)
+            _condition.wait(lock);
+    }
 
-    while (pending_requests > 0)
-        _condition.wait(lock);
+    if (std::chrono::steady_clock::now() - _utilisationStart >= MAP_UPDATER_UTILISATION_WINDOW)
+        update_utilisation();
 }
 
 void MapUpdater::join()
@@ -71,30 +93,94 @@ void MapUpdater::update_finished()
     _condition.notify_all();
 }
 
-void MapUpdater::schedule_update(Worker* worker)
+void MapUpdater::schedule_update(Worker* worker, uint32 predicted_cost /*= 0*/)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        ++pending_requests;
+    }
+
+    WorkerQueue* target = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        for (auto& queue : _queues)
+            if (!target || queue->assigned_cost < target->assigned_cost)
+                target = queue.get();
+
+        target->jobs.emplace_back(worker, predicted_cost);
+        target->assigned_cost += predicted_cost;
+
+        ++queued_requests;
+        _queueCondition.notify_one();
+    }
+}
+
+std::vector<float> MapUpdater::thread_utilisation()
 {
     std::lock_guard<std::mutex> lock(_lock);
+    return _utilisation;
+}
+
+void MapUpdater::update_utilisation()
+{
+    auto now = std::chrono::steady_clock::now();
+    uint64 window = std::chrono::duration_cast<std::chrono::microseconds>(now - _utilisationStart).count();
+    _utilisationStart = now;
 
-    ++pending_requests;
-    _queue.Push(std::move(worker));
+    std::lock_guard<std::mutex> lock(_lock);
+    for (size_t i = 0; i < _queues.size(); ++i)
+        _utilisation[i] = window ? _queues[i]->busy_time.exchange(0) * 100.0f / window : 0.0f;
 }
 
-void MapUpdater::WorkerThread()
+Worker* MapUpdater::pop_or_steal(WorkerQueue& own)
 {
-    while (true)
+    // own queue front first, it holds the most expensive job assigned to this thread
+    if (!own.jobs.empty())
     {
-        Worker* request = nullptr;
+        auto job = own.jobs.front();
+        own.jobs.pop_front();
+        own.assigned_cost -= job.second;
+        return job.first;
+    }
+
+    // steal the cheapest job of the most loaded queue
+    WorkerQueue* victim = nullptr;
+    for (auto& queue : _queues)
+        if (!queue->jobs.empty() && (!victim || queue->assigned_cost > victim->assigned_cost))
+            victim = queue.get();
 
-        _queue.WaitAndPop(request);
+    MANGOS_ASSERT(victim);
 
-        if (_cancelationToken)
+    auto job = victim->jobs.back();
+    victim->jobs.pop_back();
+    victim->assigned_cost -= job.second;
+    return job.first;
+}
+
+void MapUpdater::WorkerThread(size_t index)
+{
+    WorkerQueue& own = *_queues[index];
+
+    while (true)
+    {
+        Worker* request;
         {
-            delete request;
-            return;
+            std::unique_lock<std::mutex> lock(_queueLock);
+
+            while (queued_requests == 0 && !_cancelationToken)
+                _queueCondition.wait(lock);
+
+            if (_cancelationToken)
+                return;
+
+            --queued_requests;
+            request = pop_or_steal(own);
         }
 
+        auto start = std::chrono::steady_clock::now();
         request->execute();
+        own.busy_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
 
         delete request;
     }
-}
\ No newline at end of file
+}
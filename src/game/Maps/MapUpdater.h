@@ -20,33 +20,60 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Platform/Define.h"
-#include "Util/ProducerConsumerQueue.h"
 
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <vector>
 #include <condition_variable>
 
 class Worker;
 
+/**
+ * Pool of map update threads.
+ *
+ * Every thread has a queue of workers. New workers go to the queue with the lowest outstanding predicted cost,
+ * so scheduling maps longest first spreads the heavy ones over all threads. A thread runs its own queue from the
+ * front and takes from the back of the most loaded queue once it runs dry, so a tick is bounded by its critical
+ * path rather than by the order the workers were queued in.
+ *
+ * The queues only decide which thread runs a worker, they are not lock free: all of them are guarded by the
+ * single _queueLock. A tick schedules a few dozen map workers at most, each running for milliseconds, so the
+ * lock is held for a tiny share of the tick and per queue locking would not pay for itself.
+ */
 class MapUpdater
 {
     public:
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), pending_requests(0), queued_requests(0) {}
         MapUpdater(size_t num_threads);
         MapUpdater(const MapUpdater&) = delete;
-        
+
         void activate(size_t num_threads);
         void deactivate();
         void wait();
         void join();
         bool activated();
+        size_t thread_count() const { return _workerThreads.size(); }
         void update_finished();
-        void schedule_update(Worker* worker);
+        void schedule_update(Worker* worker, uint32 predicted_cost = 0);
+
+        // busy share of each thread in percent, measured over the last full utilisation window
+        std::vector<float> thread_utilisation();
 
     private:
-        ProducerConsumerQueue<Worker *> _queue;
+        struct WorkerQueue
+        {
+            WorkerQueue() : assigned_cost(0), busy_time(0) {}
+
+            std::deque<std::pair<Worker*, uint32>> jobs;
+            uint64 assigned_cost;                           // predicted cost of the jobs still in the queue
+            std::atomic<uint64> busy_time;                  // microseconds spent executing workers in the current window
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> _queues;
 
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
@@ -55,7 +82,16 @@ class MapUpdater
         std::condition_variable _condition;
         size_t pending_requests;
 
-        void WorkerThread();
+        std::mutex _queueLock;                              // guards all worker queues, shared by every thread
+        std::condition_variable _queueCondition;
+        size_t queued_requests;
+
+        std::chrono::steady_clock::time_point _utilisationStart;
+        std::vector<float> _utilisation;
+
+        Worker* pop_or_steal(WorkerQueue& own);             // _queueLock must be held
+        void update_utilisation();
+        void WorkerThread(size_t index);
 };
 
-#endif //_MAP_UPDATER_H_INCLUDED
\ No newline at end of file
+#endif //_MAP_UPDATER_H_INCLUDED
@@ -24,8 +24,13 @@
 #include "MapUpdater.h"
 #include "MotionGenerators/MovementGenerator.h"
 #include "Entities/Object.h"
+#include "Entities/UpdateData.h"
+#include "Server/WorldPacket.h"
 #include "Platform/Define.h"
 
+#include <chrono>
+#include <memory>
+
 class Worker
 {
     public:
@@ -49,7 +54,9 @@ class MapUpdateWorker : public Worker
 
         void execute() override
         {
+            auto start = std::chrono::steady_clock::now();
             m_map.Update(m_diff);
+            m_map.UpdateCostPrediction(uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count()));
             GetWorker().update_finished();
         }
 
@@ -58,33 +65,97 @@ class MapUpdateWorker : public Worker
         uint32 m_diff;
 };
 
-class GridCrawler : public Worker
+// Work split in batches which the map thread and the helper workers pick up alike
+struct ParallelBatches
 {
-    public:
-        GridCrawler(Map& map, std::vector<Cell> &cells, uint32 diff, MapUpdater& updater) :
-            Worker(updater), m_map(map), m_cells(cells), m_diff(diff)
-        {}
-
-        void execute() override
+    ParallelBatches() : count(0), next(0), remaining(0) {}
+    virtual ~ParallelBatches() = default;
+
+    // must be set before the batches are shared with any helper
+    void SetBatchCount(size_t batchCount)
+    {
+        count = batchCount;
+        remaining = batchCount;
+    }
+
+    // process batches until none is left to pick up
+    void Crawl()
+    {
+        size_t index;
+        while ((index = next.fetch_add(1)) < count)
         {
-            WorldObjectUnSet objToUpdate;
-            MaNGOS::ObjectUpdater obj_updater(objToUpdate, m_diff);
-            TypeContainerVisitor<MaNGOS::ObjectUpdater, GridTypeMapContainer  > grid_object_update(obj_updater);    // For creature
-            TypeContainerVisitor<MaNGOS::ObjectUpdater, WorldTypeMapContainer > world_object_update(obj_updater);   // For pets
+            Process(index);
 
-            for (auto &cell : m_cells)
+            if (--remaining == 0)
             {
-                m_map.Visit(cell, grid_object_update);
-                m_map.Visit(cell, world_object_update);
+                std::lock_guard<std::mutex> guard(lock);
+                condition.notify_all();
             }
+        }
+    }
+
+    // wait for batches picked up by other threads
+    void Wait()
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        condition.wait(guard, [this] { return remaining == 0; });
+    }
+
+    virtual void Process(size_t index) = 0;
+
+    size_t count;
+    std::atomic<size_t> next;
+    std::atomic<size_t> remaining;
+    std::mutex lock;
+    std::condition_variable condition;
+};
+
+// Objects of one map update phase, one batch per grid (see Map::PerformParallelObjectUpdate)
+struct GridCrawlerBatches : public ParallelBatches
+{
+    GridCrawlerBatches(uint32 diff) : diff(diff), updated(0) {}
+
+    void Process(size_t index) override
+    {
+        uint64 objects = 0;
+        for (WorldObject* object : batches[index])
+            if (Map::UpdateWorldObject(object, diff))
+                ++objects;
+
+        updated += objects;
+    }
+
+    std::vector<std::vector<WorldObject*>> batches;
+    uint32 diff;
+    std::atomic<uint64> updated;
+};
 
+// Update packets of one map tick, one batch per player (see Map::SendObjectUpdates)
+struct UpdatePacketBatches : public ParallelBatches
+{
+    void Process(size_t index) override
+    {
+        batches[index].first->BuildPackets(batches[index].second);
+    }
+
+    std::vector<std::pair<UpdateData*, std::vector<WorldPacket>>> batches;
+};
+
+class BatchCrawler : public Worker
+{
+    public:
+        BatchCrawler(std::shared_ptr<ParallelBatches> batches, MapUpdater& updater) :
+            Worker(updater), m_batches(std::move(batches))
+        {}
+
+        void execute() override
+        {
+            m_batches->Crawl();
             GetWorker().update_finished();
         }
 
     private:
-        Map& m_map;
-        std::vector<Cell> &m_cells;
-        uint32 m_diff;
+        std::shared_ptr<ParallelBatches> m_batches;
 };
 
 
@@ -41,6 +41,7 @@
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Metric/Instrument.h"
 #endif
 
 #include <cassert>
@@ -59,13 +60,8 @@ inline bool isStatic(MovementGenerator* mv)
 void MotionMaster::Initialize()
 {
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.initialize", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram const initializeMetric("motionmaster.initialize");
+    auto meas = metric::make_timer<std::chrono::microseconds>(initializeMetric, 1000, [this](metric::measurement& slow) { m_owner->AddMetricTags(slow); });
 #endif
     // stop current move
     m_owner->StopMoving();
@@ -119,13 +115,8 @@ void MotionMaster::UpdateMotion(uint32 diff)
     if (m_owner->hasUnitState(UNIT_STAT_CAN_NOT_MOVE))
         return;
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("motionmaster.updatemotion", {
-        { "entry", std::to_string(m_owner->GetEntry()) },
-        { "guid", std::to_string(m_owner->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_owner->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_owner->GetMapId()) },
-        { "instance_id", std::to_string(m_owner->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram const updateMotionMetric("motionmaster.updatemotion");
+    auto meas = metric::make_timer<std::chrono::microseconds>(updateMotionMetric, 1000, [this](metric::measurement& slow) { m_owner->AddMetricTags(slow); });
 #endif
 
     MANGOS_ASSERT(!empty());
@@ -372,18 +372,19 @@ namespace MMAP
 
         auto& mmap = m_loadedMMaps[packInstanceId(mapId, instanceId)];
 
-        // allocate mesh query
-        dtNavMeshQuery* query = dtAllocNavMeshQuery();
-        MANGOS_ASSERT(query);
-        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        // queries are allocated by the threads using them, this one checks the mesh accepts one
         {
-            dtFreeNavMeshQuery(query);
-            ERROR_DB_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
+            std::lock_guard<std::mutex> guard(mmap->queriesMutex);
+            mmap->queriesEnabled = true;
+        }
+
+        if (!GetNavMeshQuery(mapId, instanceId))
+        {
+            std::lock_guard<std::mutex> guard(mmap->queriesMutex);
+            mmap->queriesEnabled = false;
             return false;
         }
 
-        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
-        mmap->navMeshQuery = query;
         return true;
     }
 
@@ -485,10 +486,11 @@ namespace MMAP
 
         const auto& mmapData = (*itr).second;
 
-        dtNavMeshQuery* query = mmapData->navMeshQuery;
-
-        dtFreeNavMeshQuery(query);
-        mmapData->navMeshQuery = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(mmapData->queriesMutex);
+            mmapData->FreeQueries();
+            mmapData->queriesEnabled = false;
+        }
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Unloaded mapId %03u instanceId %u", mapId, instanceId);
 
         return true;
@@ -517,7 +519,29 @@ namespace MMAP
         if (itr == m_loadedMMaps.end())
             return nullptr;
 
-        return itr->second->navMeshQuery;
+        MMapData& mmap = *itr->second;
+        std::lock_guard<std::mutex> guard(mmap.queriesMutex);
+        if (!mmap.queriesEnabled)
+            return nullptr;
+
+        auto threadId = std::this_thread::get_id();
+        auto queryItr = mmap.navMeshQueries.find(threadId);
+        if (queryItr != mmap.navMeshQueries.end())
+            return queryItr->second;
+
+        // allocate mesh query
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        if (dtStatusFailed(query->init(mmap.navMesh, 1024)))
+        {
+            dtFreeNavMeshQuery(query);
+            ERROR_DB_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
+            return nullptr;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId %03u instanceId %u", mapId, instanceId);
+        mmap.navMeshQueries.emplace(threadId, query);
+        return query;
     }
 
     dtNavMeshQuery const* MMapManager::GetModelNavMeshQuery(uint32 displayId)
@@ -527,26 +551,24 @@ namespace MMAP
 
         auto threadId = std::this_thread::get_id();
         const auto& mmapGOData = m_loadedModels[displayId];
+        // looked up under the lock too, another thread may be adding its query
+        std::lock_guard<std::mutex> guard(m_modelsMutex);
         if (mmapGOData->navMeshGOQueries.find(threadId) == mmapGOData->navMeshGOQueries.end())
         {
-            std::lock_guard<std::mutex> guard(m_modelsMutex);
-            if (mmapGOData->navMeshGOQueries.find(threadId) == mmapGOData->navMeshGOQueries.end())
+            // allocate mesh query
+            std::stringstream ss;
+            ss << threadId;
+            dtNavMeshQuery* query = dtAllocNavMeshQuery();
+            MANGOS_ASSERT(query);
+            if (dtStatusFailed(query->init(mmapGOData->navMesh, 2048)))
             {
-                // allocate mesh query
-                std::stringstream ss;
-                ss << threadId;
-                dtNavMeshQuery* query = dtAllocNavMeshQuery();
-                MANGOS_ASSERT(query);
-                if (dtStatusFailed(query->init(mmapGOData->navMesh, 2048)))
-                {
-                    dtFreeNavMeshQuery(query);
-                    sLog.outError("MMAP:GetModelNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u tid %s", displayId, ss.str().data());
-                    return nullptr;
-                }
-
-                DETAIL_LOG("MMAP:GetModelNavMeshQuery: created dtNavMeshQuery for displayid %03u tid %s", displayId, ss.str().data());
-                mmapGOData->navMeshGOQueries.insert(std::pair<std::thread::id, dtNavMeshQuery*>(threadId, query));
+                dtFreeNavMeshQuery(query);
+                sLog.outError("MMAP:GetModelNavMeshQuery: Failed to initialize dtNavMeshQuery for displayid %03u tid %s", displayId, ss.str().data());
+                return nullptr;
             }
+
+            DETAIL_LOG("MMAP:GetModelNavMeshQuery: created dtNavMeshQuery for displayid %03u tid %s", displayId, ss.str().data());
+            mmapGOData->navMeshGOQueries.insert(std::pair<std::thread::id, dtNavMeshQuery*>(threadId, query));
         }
 
         return mmapGOData->navMeshGOQueries[threadId];
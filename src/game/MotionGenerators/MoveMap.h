@@ -45,23 +45,34 @@ namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
     typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshGOQuerySet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> NavMeshQuerySet;
 
     // dummy struct to hold map's mmap data
     struct MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh), navMeshQuery(nullptr), fullLoaded(false) {}
+        MMapData(dtNavMesh* mesh) : navMesh(mesh), queriesEnabled(false), fullLoaded(false) {}
         ~MMapData()
         {
-            dtFreeNavMeshQuery(navMeshQuery);
+            FreeQueries();
 
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
 
+        void FreeQueries()
+        {
+            for (auto& navMeshQuery : navMeshQueries)
+                dtFreeNavMeshQuery(navMeshQuery.second);
+            navMeshQueries.clear();
+        }
+
         dtNavMesh* navMesh;
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        dtNavMeshQuery* navMeshQuery;       // mmap data in wotlk is already packed per instance id
+        // dtNavMeshQuery keeps the state of its searches, so every thread searching the instance has its own;
+        // objects of a continent may be updated by several threads at once (MapUpdate.ParallelCells)
+        NavMeshQuerySet navMeshQueries;     // mmap data in wotlk is already packed per instance id
+        std::mutex queriesMutex;
+        bool queriesEnabled;                // between loadMapInstance and unloadMapInstance
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
 
         bool fullLoaded;
@@ -106,7 +117,7 @@ namespace MMAP
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
             bool IsMMapTileLoaded(uint32 mapId, uint32 instanceId, uint32 x, uint32 y) const;
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
+            // the returned [dtNavMeshQuery const*] is NOT threadsafe, it belongs to the calling thread
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
             dtNavMeshQuery const* GetModelNavMeshQuery(uint32 displayId);
             dtNavMesh const* GetNavMesh(uint32 mapId, uint32 instanceId);
@@ -23,6 +23,7 @@
 #include "Log/Log.h"
 #include "World/World.h"
 #include "Entities/Transports.h"
+#include "Maps/Map.h"
 #include <Detour/Include/DetourCommon.h>
 #include <Detour/Include/DetourMath.h>
 #ifdef ENABLE_PLAYERBOTS
@@ -31,6 +32,7 @@
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Metric/Instrument.h"
 #endif
 
 #include <limits>
@@ -51,6 +53,7 @@ PathFinder::PathFinder(const Unit* owner, bool ignoreNormalization) :
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
         m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
+        m_defaultNavMeshQueryThread = std::this_thread::get_id();
     }
 
     createFilter();
@@ -90,9 +93,12 @@ void PathFinder::SetCurrentNavMesh()
             m_navMeshQuery = mmap->GetModelNavMeshQuery(transport->GetDisplayId());
         else
         {
-            if (m_defaultMapId != m_sourceUnit->GetMapId())
+            // queries belong to a thread, the owner may be updated by another one than last time
+            if (m_defaultMapId != m_sourceUnit->GetMapId() || m_defaultNavMeshQueryThread != std::this_thread::get_id())
+            {
                 m_defaultNavMeshQuery = mmap->GetNavMeshQuery(m_sourceUnit->GetMapId(), m_sourceUnit->GetInstanceId());
-
+                m_defaultNavMeshQueryThread = std::this_thread::get_id();
+            }
             m_navMeshQuery = m_defaultNavMeshQuery;
         }
 
@@ -135,13 +141,8 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
 #endif
 
 #ifdef BUILD_METRICS
-    metric::duration<std::chrono::microseconds> meas("pathfinder.calculate", {
-        { "entry", std::to_string(m_sourceUnit->GetEntry()) },
-        { "guid", std::to_string(m_sourceUnit->GetGUIDLow()) },
-        { "unit_type", std::to_string(m_sourceUnit->GetGUIDHigh()) },
-        { "map_id", std::to_string(m_sourceUnit->GetMapId()) },
-        { "instance_id", std::to_string(m_sourceUnit->GetInstanceId()) }
-    }, 1000);
+    static metric::histogram const calculateMetric("pathfinder.calculate");
+    auto meas = metric::make_timer<std::chrono::microseconds>(calculateMetric, 1000, [this](metric::measurement& slow) { m_sourceUnit->AddMetricTags(slow); });
 #endif
 
     //if (GenericTransport* transport = m_sourceUnit->GetTransport())
@@ -156,6 +157,14 @@ bool PathFinder::calculate(Vector3 const& start, Vector3 const& dest, bool force
 
     SetCurrentNavMesh();
 
+#ifdef ENABLE_PLAYERBOTS
+    std::shared_lock<std::shared_mutex> navMeshGuard;
+    if (m_sourceUnit)
+        navMeshGuard = m_sourceUnit->GetMap()->LockNavMeshRead();
+#else
+    auto navMeshGuard = m_sourceUnit->GetMap()->LockNavMeshRead();
+#endif
+
 #ifdef ENABLE_PLAYERBOTS
     if(m_sourceUnit)
 #endif
@@ -1368,6 +1377,7 @@ void PathFinder::ComputePathToRandomPoint(Vector3 const& startPoint, float maxRa
 
     // be sure navmesh are set
     SetCurrentNavMesh();
+    auto navMeshGuard = m_sourceUnit->GetMap()->LockNavMeshRead();
 
     float angle = rand_norm_f() * 2 * M_PI_F;
     float range = rand_norm_f() * maxRange;
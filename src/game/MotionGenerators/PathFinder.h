@@ -26,6 +26,8 @@
 
 #include "Movement/MoveSplineInitArgs.h"
 
+#include <thread>
+
 using Movement::Vector3;
 using Movement::PointsArray;
 
@@ -130,6 +132,7 @@ class PathFinder
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
 
         const dtNavMeshQuery*   m_defaultNavMeshQuery;     // the nav mesh query used to find the path
+        std::thread::id         m_defaultNavMeshQueryThread;  // queries belong to a thread, this is the one of m_defaultNavMeshQuery
         uint32                  m_defaultMapId;
 #ifdef ENABLE_PLAYERBOTS
         uint32                  m_defaultInstanceId;
@@ -64,6 +64,8 @@ PacketLog::PacketLog() : _file(nullptr)
 
 PacketLog::~PacketLog()
 {
+    _writer.Stop();
+
     if (_file)
         fclose(_file);
 
@@ -102,13 +104,20 @@ void PacketLog::Initialize()
         header.OptionalDataSize = 0;
 
         if (CanLogPacket())
+        {
             fwrite(&header, sizeof(header), 1, _file);
+
+            if (uint32 queueSize = sConfig.GetIntDefault("LogAsyncQueueSize", 10000))
+                _writer.Start(queueSize, sConfig.GetIntDefault("LogAsyncOverflow", 0) ? LOG_OVERFLOW_DROP : LOG_OVERFLOW_BLOCK);
+        }
     }
 }
 
 void PacketLog::Reinitialize()
 {
     std::lock_guard<std::mutex> lock(_logPacketLock);
+    // packets queued for the file are written before it is closed
+    _writer.Stop();
     if (CanLogPacket())
     {
         fclose(_file);
@@ -119,8 +128,6 @@ void PacketLog::Reinitialize()
 
 void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost::asio::ip::address const& addr, uint16 port)
 {
-    std::lock_guard<std::mutex> lock(_logPacketLock);
-
     PacketHeader header;
     header.Direction = direction == CLIENT_TO_SERVER ? 0x47534d43 : 0x47534d53;
     header.ConnectionId = 0;
@@ -143,9 +150,22 @@ void PacketLog::LogPacket(WorldPacket const& packet, Direction direction, boost:
     header.Length = packet.size() + sizeof(header.Opcode);
     header.Opcode = packet.GetOpcode();
 
-    fwrite(&header, sizeof(header), 1, _file);
+    std::string record(sizeof(header) + packet.size(), '\0');
+    memcpy(&record[0], &header, sizeof(header));
     if (!packet.empty())
-        fwrite(packet.contents(), 1, packet.size(), _file);
+        memcpy(&record[sizeof(header)], packet.contents(), packet.size());
+
+    // only the file may change meanwhile, see Reinitialize
+    std::lock_guard<std::mutex> lock(_logPacketLock);
+    if (!CanLogPacket())
+        return;
+
+    if (_writer.IsRunning())
+    {
+        _writer.Write(_file, std::move(record), false);
+        return;
+    }
 
+    fwrite(record.data(), 1, record.size(), _file);
     fflush(_file);
 }
@@ -19,6 +19,7 @@
 #define TRINITY_PACKETLOG_H
 
 #include "Common.h"
+#include "Log/LogWriter.h"
 
 #include <boost/asio/ip/address.hpp>
 #include <mutex>
@@ -49,6 +50,7 @@ class PacketLog
 
     private:
         FILE* _file;
+        LogWriter _writer;
 };
 
 #define sPacketLog PacketLog::instance()
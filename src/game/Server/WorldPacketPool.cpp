@@ -0,0 +1,80 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Server/WorldPacketPool.h"
+
+static size_t const PACKET_BATCH_SIZE = 64;                 // packets traded at once between a thread cache and the pool
+static size_t const MAX_POOLED_BATCHES = 256;               // pooled packets above this are freed
+static size_t const MAX_POOLED_PACKET_SIZE = 1024;          // bigger buffers are rare enough to be freed instead of kept
+
+WorldPacketPool& WorldPacketPool::Instance()
+{
+    static WorldPacketPool instance;
+    return instance;
+}
+
+WorldPacketPool::PacketBatch& WorldPacketPool::GetThreadCache()
+{
+    thread_local PacketBatch cache;
+    return cache;
+}
+
+std::unique_ptr<WorldPacket> WorldPacketPool::Acquire(Opcodes opcode, size_t reservedSize)
+{
+    PacketBatch& cache = GetThreadCache();
+    if (cache.empty())
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        if (!m_batches.empty())
+        {
+            cache = std::move(m_batches.back());
+            m_batches.pop_back();
+        }
+    }
+
+    if (cache.empty())
+        return std::make_unique<WorldPacket>(opcode, reservedSize);
+
+    std::unique_ptr<WorldPacket> packet = std::move(cache.back());
+    cache.pop_back();
+    packet->Initialize(opcode, reservedSize);
+    packet->SetReceivedTime(std::chrono::steady_clock::time_point());
+    return packet;
+}
+
+void WorldPacketPool::Release(std::unique_ptr<WorldPacket> packet)
+{
+    if (!packet || packet->capacity() > MAX_POOLED_PACKET_SIZE)
+        return;
+
+    PacketBatch& cache = GetThreadCache();
+    if (cache.capacity() < PACKET_BATCH_SIZE)
+        cache.reserve(PACKET_BATCH_SIZE);
+
+    cache.push_back(std::move(packet));
+    if (cache.size() < PACKET_BATCH_SIZE)
+        return;
+
+    PacketBatch batch;
+    batch.reserve(PACKET_BATCH_SIZE);
+    std::swap(batch, cache);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    if (m_batches.size() < MAX_POOLED_BATCHES)
+        m_batches.push_back(std::move(batch));
+}
@@ -0,0 +1,54 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _WORLD_PACKET_POOL_H
+#define _WORLD_PACKET_POOL_H
+
+#include "Common.h"
+#include "Server/WorldPacket.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Recycles the packets received from clients. Network threads acquire a packet for every message read and
+// the session hands it back once handled, so the buffers grown by earlier messages are reused instead of
+// allocated again. Each thread keeps a small cache of its own and trades whole batches with the shared
+// list, so the lock is only taken once per batch.
+class WorldPacketPool
+{
+    public:
+        static WorldPacketPool& Instance();
+
+        std::unique_ptr<WorldPacket> Acquire(Opcodes opcode, size_t reservedSize);
+        void Release(std::unique_ptr<WorldPacket> packet);
+
+    private:
+        WorldPacketPool() = default;
+
+        typedef std::vector<std::unique_ptr<WorldPacket>> PacketBatch;
+
+        static PacketBatch& GetThreadCache();
+
+        std::mutex m_lock;
+        std::vector<PacketBatch> m_batches;
+};
+
+#define sWorldPacketPool WorldPacketPool::Instance()
+
+#endif
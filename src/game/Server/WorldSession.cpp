@@ -28,6 +28,7 @@
 #include "Log/Log.h"
 #include "Server/Opcodes.h"
 #include "Server/WorldPacket.h"
+#include "Server/WorldPacketPool.h"
 #include "Server/WorldSession.h"
 #include "Entities/Player.h"
 #include "Globals/ObjectMgr.h"
@@ -278,6 +279,8 @@ void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 
         if (new_packet->rpos() < new_packet->wpos() && sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
             LogUnprocessedTail(*new_packet);
+
+        sWorldPacketPool.Release(std::move(new_packet));
         return;
     }
 
@@ -378,7 +381,7 @@ bool WorldSession::Update(uint32 /*diff*/)
     {
         // sLog.outError("MOEP: %s (0x%.4X)", packet->GetOpcodeName(), packet->GetOpcode());
 
-        auto const packet = std::move(recvQueueCopy.front());
+        auto packet = std::move(recvQueueCopy.front());
         recvQueueCopy.pop_front();
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
@@ -449,6 +452,8 @@ bool WorldSession::Update(uint32 /*diff*/)
                               packet->GetOpcode());
                 break;
         }
+
+        sWorldPacketPool.Release(std::move(packet));
     }
 
 #ifdef BUILD_DEPRECATED_PLAYERBOT
@@ -577,7 +582,7 @@ void WorldSession::UpdateMap(uint32 diff)
 
     while (m_socket && !m_socket->IsClosed() && recvQueueMapCopy.size())
     {
-        auto const packet = std::move(recvQueueMapCopy.front());
+        auto packet = std::move(recvQueueMapCopy.front());
         recvQueueMapCopy.pop_front();
 
         OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
@@ -586,6 +591,8 @@ void WorldSession::UpdateMap(uint32 diff)
         {
             ExecuteOpcode(opHandle, *packet);
         }
+
+        sWorldPacketPool.Release(std::move(packet));
     }
 }
 
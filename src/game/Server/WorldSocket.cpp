@@ -26,6 +26,7 @@
 #include "Util/ByteBuffer.h"
 #include "Server/Opcodes.h"
 #include "Server/PacketLog.h"
+#include "Server/WorldPacketPool.h"
 #include "Database/DatabaseEnv.h"
 #include "Auth/CryptoHash.h"
 #include "Server/WorldSession.h"
@@ -118,14 +119,23 @@ std::deque<uint32> WorldSocket::GetIncOpcodeHistory()
     return m_opcodeHistoryInc;
 }
 
+static size_t const SEND_BUFFER_SIZE = 16 * 1024;           // initial size of both send buffers
+static size_t const SEND_BUFFER_KEEP_SIZE = 256 * 1024;     // send buffers grown above this are released once written
+static size_t const READ_BUFFER_SIZE = 16 * 1024;           // holds the largest packet a client may send
+
 WorldSocket::WorldSocket(boost::asio::io_context& context) : AsyncSocket(context), m_lastPingTime(std::chrono::system_clock::time_point::min()), m_overSpeedPings(0),
-    m_session(nullptr), m_seed(urand()), m_loggingPackets(true)
+    m_session(nullptr), m_seed(urand()),
+    m_readBuffer(READ_BUFFER_SIZE), m_readBufferSize(0), m_headerReceived(false), m_flushScheduled(false), m_sending(false), m_closing(false), m_loggingPackets(true)
 {
+    m_sendQueue.reserve(SEND_BUFFER_SIZE);
+    m_sendInFlight.reserve(SEND_BUFFER_SIZE);
 }
 
+WorldSocket::~WorldSocket() = default;
+
 void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
 {
-    if (IsClosed())
+    if (IsClosed() || m_closing)
         return;
 
     if (sPacketLog->CanLogPacket() && IsLoggingPackets())
@@ -134,35 +144,116 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     // Dump outgoing packet.
     sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
 
-    // encrypt thread unsafe due to being executed from map contexts frequently - TODO: move to post service context in future
-    std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+    m_pendingPackets.Enqueue(WorldPacket(pct));
+
+    // otherwise picked up by the flush already scheduled
+    if (!m_flushScheduled.exchange(true, std::memory_order_acq_rel))
+    {
+        auto self(shared_from_this());
+        boost::asio::post(GetAsioSocket().get_executor(), [self]()
+        {
+            self->FlushPendingPackets();
+        });
+    }
+}
+
+void WorldSocket::FlushPendingPackets()
+{
+    // cleared before dequeuing, so a packet queued meanwhile is either framed now or schedules another flush
+    m_flushScheduled.store(false, std::memory_order_release);
 
-    ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
-    m_crypt.EncryptSend(static_cast<uint8*>(header.header), header.headerSize());
+    std::lock_guard<std::mutex> guard(m_worldSocketMutex);
 
-    uint32 opcode = pct.GetOpcode();
+    FramePendingPackets();
 
-    m_opcodeHistoryOut.push_front(uint32(opcode));
-    if (m_opcodeHistoryOut.size() > 50)
-        m_opcodeHistoryOut.resize(30);
+    // otherwise picked up when the write in progress completes
+    if (!m_sending && !m_sendQueue.empty())
+        StartSending();
+}
 
-    if (pct.size() > 0)
+void WorldSocket::Close()
+{
     {
-        // allocate array for full message
-        std::shared_ptr<std::vector<char>> fullMessage = std::make_shared<std::vector<char>>(header.headerSize() + pct.size());
-        std::memcpy(fullMessage->data(), header.data(), header.headerSize()); // copy header
-        std::memcpy((fullMessage->data() + header.headerSize()), reinterpret_cast<const char*>(pct.contents()), pct.size()); // copy packet
-        auto self(shared_from_this());
-        Write(fullMessage->data(), fullMessage->size(), [self, fullMessage](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+        std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+
+        if (m_closing.exchange(true))
+            return;
+
+        // the flush posted for them may only run after the socket is gone
+        FramePendingPackets();
+
+        if (m_sending || !m_sendQueue.empty())
+        {
+            // a pending read completes with an error and ends reading, the write handler closes the socket
+            boost::system::error_code ec;
+            GetAsioSocket().shutdown(boost::asio::ip::tcp::socket::shutdown_receive, ec);
+
+            if (!m_sending)
+                StartSending();
+            return;
+        }
     }
-    else
+
+    MaNGOS::AsyncSocket<WorldSocket>::Close();
+}
+
+void WorldSocket::FramePendingPackets()
+{
+    WorldPacket pct;
+    while (m_pendingPackets.Dequeue(pct))
     {
-        std::shared_ptr<ServerPktHeader> sharedHeader = std::make_shared<ServerPktHeader>(header);
-        auto self(shared_from_this());
-        Write(sharedHeader->data(), sharedHeader->headerSize(), [self, sharedHeader](const boost::system::error_code& /*error*/, std::size_t /*written*/) {});
+        ServerPktHeader header(pct.size() + 2, pct.GetOpcode());
+        m_crypt.EncryptSend(static_cast<uint8*>(header.header), header.headerSize());
+
+        uint32 opcode = pct.GetOpcode();
+
+        m_opcodeHistoryOut.push_front(uint32(opcode));
+        if (m_opcodeHistoryOut.size() > 50)
+            m_opcodeHistoryOut.resize(30);
+
+        m_sendQueue.insert(m_sendQueue.end(), header.data(), header.data() + header.headerSize());
+        if (pct.size() > 0)
+            m_sendQueue.insert(m_sendQueue.end(), reinterpret_cast<const char*>(pct.contents()), reinterpret_cast<const char*>(pct.contents()) + pct.size());
     }
 }
 
+void WorldSocket::StartSending()
+{
+    m_sending = true;
+    std::swap(m_sendQueue, m_sendInFlight);
+
+    auto self(shared_from_this());
+    Write(m_sendInFlight.data(), m_sendInFlight.size(), [self](const boost::system::error_code& error, std::size_t /*written*/)
+    {
+        std::lock_guard<std::mutex> guard(self->m_worldSocketMutex);
+
+        if (self->m_sendInFlight.capacity() > SEND_BUFFER_KEEP_SIZE)
+        {
+            std::vector<char>().swap(self->m_sendInFlight);
+            self->m_sendInFlight.reserve(SEND_BUFFER_SIZE);
+        }
+        else
+            self->m_sendInFlight.clear();
+
+        if (error)
+        {
+            self->m_sending = false;
+            self->m_sendQueue.clear();
+            self->MaNGOS::AsyncSocket<WorldSocket>::Close();
+            return;
+        }
+
+        if (!self->m_sendQueue.empty())
+            self->StartSending();
+        else
+        {
+            self->m_sending = false;
+            if (self->m_closing)
+                self->MaNGOS::AsyncSocket<WorldSocket>::Close();
+        }
+    });
+}
+
 bool WorldSocket::OnOpen()
 {
     // Send startup packet.
@@ -185,10 +276,8 @@ bool WorldSocket::OnOpen()
 
 bool WorldSocket::ProcessIncomingData()
 {
-    std::shared_ptr<ClientPktHeader> header = std::make_shared<ClientPktHeader>();
-
     auto self(shared_from_this());
-    Read((char*)header.get(), sizeof(ClientPktHeader), [self, header](const boost::system::error_code& error, std::size_t /*read*/) -> void
+    ReadSome(m_readBuffer.data() + m_readBufferSize, m_readBuffer.size() - m_readBufferSize, [self](const boost::system::error_code& error, std::size_t read) -> void
     {
         if (error)
         {
@@ -196,129 +285,170 @@ bool WorldSocket::ProcessIncomingData()
             return;
         }
 
+        self->m_readBufferSize += read;
+
         // thread safe due to always being called from service context
-        self->m_crypt.DecryptRecv((uint8*)header.get(), sizeof(ClientPktHeader));
+        if (!self->ProcessReadBuffer())
+            return;
 
-        EndianConvertReverse(header->size);
-        EndianConvert(header->cmd);
+        self->ProcessIncomingData();
+    });
 
-        if ((header->size < 4) || (header->size > 0x2800) || (header->cmd >= NUM_MSG_TYPES))
+    return true;
+}
+
+bool WorldSocket::ProcessReadBuffer()
+{
+    size_t offset = 0;
+    while (true)
+    {
+        // the header is decrypted once, even when its body arrives in a later read
+        if (!m_headerReceived)
         {
-            sLog.outError("WorldSocket::ProcessIncomingData: client sent malformed packet size = %u , cmd = %u", header->size, header->cmd);
-            return;
-        }
+            if (m_readBufferSize - offset < sizeof(ClientPktHeader))
+                break;
 
-        const Opcodes opcode = static_cast<Opcodes>(header->cmd);
+            memcpy(&m_header, m_readBuffer.data() + offset, sizeof(ClientPktHeader));
+            offset += sizeof(ClientPktHeader);
 
-        size_t packetSize = header->size - 4;
-        std::shared_ptr<std::vector<uint8>> packetBuffer = std::make_shared<std::vector<uint8>>(packetSize);
+            m_crypt.DecryptRecv((uint8*)&m_header, sizeof(ClientPktHeader));
 
-        self->Read(reinterpret_cast<char*>(packetBuffer->data()), packetBuffer->size(), [self, packetBuffer, opcode = opcode](const boost::system::error_code& error, std::size_t /*read*/) -> void
-        {
-            if (error)
+            EndianConvertReverse(m_header.size);
+            EndianConvert(m_header.cmd);
+
+            if ((m_header.size < 4) || (m_header.size > 0x2800) || (m_header.cmd >= NUM_MSG_TYPES))
             {
-                self->Close();
-                return;
+                sLog.outError("WorldSocket::ProcessIncomingData: client sent malformed packet size = %u , cmd = %u", m_header.size, m_header.cmd);
+                return false;
             }
 
-            std::unique_ptr<WorldPacket> pct = std::make_unique<WorldPacket>(opcode, packetBuffer->size());
-            pct->append(*packetBuffer.get());
-            if (sPacketLog->CanLogPacket() && self->IsLoggingPackets())
-                sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, self->GetRemoteIpAddress(), self->GetRemotePort());
+            m_headerReceived = true;
+        }
 
-            sLog.outWorldPacketDump(self->GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, true);
+        size_t packetSize = m_header.size - 4;
+        if (m_readBufferSize - offset < packetSize)
+            break;
 
-            if (WorldSocket::m_packetCooldowns.size() <= size_t(opcode))
-            {
-                sLog.outError("WorldSocket::ProcessIncomingData: Received opcode beyond range of opcodes: %u", opcode);
-                self->Close();
-                return;
-            }
+        m_headerReceived = false;
 
-            if (WorldSocket::m_packetCooldowns[opcode])
-            {
-                auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
-                if (now < self->m_lastPacket[opcode]) // packet on cooldown
+        std::unique_ptr<WorldPacket> pct = sWorldPacketPool.Acquire(static_cast<Opcodes>(m_header.cmd), packetSize);
+        if (packetSize > 0)
+            pct->append(m_readBuffer.data() + offset, packetSize);
+        offset += packetSize;
+
+        if (!ProcessPacket(std::move(pct)))
+            return false;
+    }
+
+    // keep the incomplete packet at the front, the largest one allowed always fits in the buffer
+    if (offset)
+    {
+        m_readBufferSize -= offset;
+        if (m_readBufferSize)
+            memmove(m_readBuffer.data(), m_readBuffer.data() + offset, m_readBufferSize);
+    }
+
+    return true;
+}
+
+bool WorldSocket::ProcessPacket(std::unique_ptr<WorldPacket> pct)
+{
+    const Opcodes opcode = pct->GetOpcode();
+
+    if (sPacketLog->CanLogPacket() && IsLoggingPackets())
+        sPacketLog->LogPacket(*pct, CLIENT_TO_SERVER, GetRemoteIpAddress(), GetRemotePort());
+
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, true);
+
+    if (WorldSocket::m_packetCooldowns.size() <= size_t(opcode))
+    {
+        sLog.outError("WorldSocket::ProcessIncomingData: Received opcode beyond range of opcodes: %u", opcode);
+        Close();
+        return false;
+    }
+
+    if (WorldSocket::m_packetCooldowns[opcode])
+    {
+        auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
+        if (now < m_lastPacket[opcode]) // packet on cooldown
+        {
+            sWorldPacketPool.Release(std::move(pct));
+            return true;
+        }
+        else // start cooldown and allow execution
+            m_lastPacket[opcode] = now + std::chrono::milliseconds(WorldSocket::m_packetCooldowns[opcode]);
+    }
+
+    try
+    {
+        switch (opcode)
+        {
+            case CMSG_AUTH_SESSION:
+                if (m_session)
                 {
-                    self->ProcessIncomingData();
-                    return;
+                    sLog.outError("WorldSocket::ProcessIncomingData: Player send CMSG_AUTH_SESSION again");
+                    Close();
+                    return false;
                 }
-                else // start cooldown and allow execution
-                    self->m_lastPacket[opcode] = now + std::chrono::milliseconds(WorldSocket::m_packetCooldowns[opcode]);
-            }
 
-            try
-            {
-                switch (opcode)
+                if (!HandleAuthSession(*pct))
                 {
-                    case CMSG_AUTH_SESSION:
-                        if (self->m_session)
-                        {
-                            sLog.outError("WorldSocket::ProcessIncomingData: Player send CMSG_AUTH_SESSION again");
-                            self->Close();
-                            return;
-                        }
-
-                        if (!self->HandleAuthSession(*pct))
-                        {
-                            self->Close();
-                            return;
-                        }
-                        break;
-                    case CMSG_PING:
-                        if (!self->HandlePing(*pct))
-                        {
-                            self->Close();
-                            return;
-                        }
-                        break;
-                    case CMSG_KEEP_ALIVE:
-                        DEBUG_LOG("CMSG_KEEP_ALIVE, size: " SIZEFMTD " ", pct->size());
-                        break;
-                    case CMSG_TIME_SYNC_RESP:
-                        pct->SetReceivedTime(std::chrono::steady_clock::now());
-                        [[fallthrough]];
-                    default:
-                    {
-                        self->m_opcodeHistoryInc.push_front(uint32(pct->GetOpcode()));
-                        if (self->m_opcodeHistoryInc.size() > 50)
-                            self->m_opcodeHistoryInc.resize(30);
-
-                        if (!self->m_session)
-                        {
-                            sLog.outError("WorldSocket::ProcessIncomingData: Client not authed opcode = %u", uint32(opcode));
-                            self->Close();
-                            return;
-                        }
-
-                        self->m_session->QueuePacket(std::move(pct));
-                        break;
-                    }
+                    Close();
+                    return false;
                 }
-            }
-            catch (ByteBufferException&)
-            {
-                sLog.outError("WorldSocket::ProcessIncomingData ByteBufferException occured while parsing an instant handled packet (opcode: %u) from client %s, accountid=%i.",
-                    opcode, self->GetRemoteAddress().c_str(), self->m_session ? self->m_session->GetAccountId() : -1);
-
-                if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+                break;
+            case CMSG_PING:
+                if (!HandlePing(*pct))
                 {
-                    DEBUG_LOG("Dumping error-causing packet:");
-                    pct->hexlike();
+                    Close();
+                    return false;
                 }
+                break;
+            case CMSG_KEEP_ALIVE:
+                DEBUG_LOG("CMSG_KEEP_ALIVE, size: " SIZEFMTD " ", pct->size());
+                break;
+            case CMSG_TIME_SYNC_RESP:
+                pct->SetReceivedTime(std::chrono::steady_clock::now());
+                [[fallthrough]];
+            default:
+            {
+                m_opcodeHistoryInc.push_front(uint32(pct->GetOpcode()));
+                if (m_opcodeHistoryInc.size() > 50)
+                    m_opcodeHistoryInc.resize(30);
 
-                if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+                if (!m_session)
                 {
-                    DETAIL_LOG("Disconnecting session [account id %i / address %s] for badly formatted packet.",
-                        self->m_session ? self->m_session->GetAccountId() : -1, self->GetRemoteAddress().c_str());
-                    self->Close();
-                    return;
+                    sLog.outError("WorldSocket::ProcessIncomingData: Client not authed opcode = %u", uint32(opcode));
+                    Close();
+                    return false;
                 }
+
+                m_session->QueuePacket(std::move(pct));
+                break;
             }
-            self->ProcessIncomingData();
-        });
-    });
+        }
+    }
+    catch (ByteBufferException&)
+    {
+        sLog.outError("WorldSocket::ProcessIncomingData ByteBufferException occured while parsing an instant handled packet (opcode: %u) from client %s, accountid=%i.",
+            opcode, GetRemoteAddress().c_str(), m_session ? m_session->GetAccountId() : -1);
+
+        if (sLog.HasLogLevelOrHigher(LOG_LVL_DEBUG))
+        {
+            DEBUG_LOG("Dumping error-causing packet:");
+            pct->hexlike();
+        }
 
+        if (sWorld.getConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET))
+        {
+            DETAIL_LOG("Disconnecting session [account id %i / address %s] for badly formatted packet.",
+                m_session ? m_session->GetAccountId() : -1, GetRemoteAddress().c_str());
+            Close();
+            return false;
+        }
+    }
+
+    sWorldPacketPool.Release(std::move(pct));
     return true;
 }
 
@@ -536,7 +666,12 @@ bool WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
     SqlStatement stmt = LoginDatabase.CreateStatement(updAccount, "INSERT INTO account_logons(accountId,ip,loginTime,loginSource) VALUES(?,?," _NOW_ ",?)");
     stmt.PExecute(id, address.c_str(), std::to_string(realmID).c_str());
 
-    m_crypt.Init(&K);
+    {
+        // packets queued so far go out unencrypted, as the client expects
+        std::lock_guard<std::mutex> guard(m_worldSocketMutex);
+        FramePendingPackets();
+        m_crypt.Init(&K);
+    }
 
     m_session = sWorld.FindSession(id);
 
@@ -29,10 +29,14 @@
 #include "AuthCrypt.h"
 #include "Auth/BigNumber.h"
 #include "Network/AsyncSocket.hpp"
+#include "Util/MPSCQueue.h"
 
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <deque>
+#include <memory>
+#include <vector>
 
 class WorldPacket;
 class WorldSession;
@@ -61,10 +65,10 @@ class WorldSession;
  * The calls to Update () method are managed by WorldSocketMgr
  * and ReactorRunnable.
  *
- * For input ,the class uses one 1024 bytes buffer on stack
- * to which it does recv() calls. And then received data is
- * distributed where its needed. 1024 matches pretty well the
- * traffic generated by client for now.
+ * For input, the class uses one 16K buffer per socket
+ * to which it does recv() calls, and received packets are
+ * copied into pooled WorldPackets which the session hands
+ * back to WorldPacketPool once handled.
  *
  * The input/output do speculative reads/writes (AKA it tries
  * to read all data available in the kernel buffer or tries to
@@ -109,9 +113,23 @@ class WorldSocket : public MaNGOS::AsyncSocket<WorldSocket>
 
         BigNumber m_s;
 
-        /// process one incoming packet.
+        /// Incoming data. Each read takes whatever the kernel has available, up to the free space left
+        /// after an incomplete packet, and every complete packet is parsed out of it before reading again.
+        std::vector<char> m_readBuffer;
+        size_t m_readBufferSize;
+        /// header of the incomplete packet, already decrypted
+        ClientPktHeader m_header;
+        bool m_headerReceived;
+
+        /// read and process incoming packets.
         virtual bool ProcessIncomingData() override;
 
+        /// parse the complete packets read so far, false when reading must stop
+        bool ProcessReadBuffer();
+
+        /// process one incoming packet, false when reading must stop
+        bool ProcessPacket(std::unique_ptr<WorldPacket> pct);
+
         /// Called by ProcessIncoming() on CMSG_AUTH_SESSION.
         bool HandleAuthSession(WorldPacket& recvPacket);
 
@@ -120,6 +138,28 @@ class WorldSocket : public MaNGOS::AsyncSocket<WorldSocket>
 
         std::mutex m_worldSocketMutex;
 
+        /// Packets sent from any thread wait in m_pendingPackets until a flush posted to the network thread
+        /// encrypts their headers and frames them into m_sendQueue, so senders never wait for the socket.
+        /// Only one flush is scheduled at a time, guarded by m_flushScheduled.
+        MPSCQueue<WorldPacket> m_pendingPackets;
+        std::atomic<bool> m_flushScheduled;
+
+        /// Outgoing data. m_sendQueue is swapped with m_sendInFlight and written in one go whenever no
+        /// write is in progress, so a burst of packets costs a single write and packets always leave in
+        /// the order they were queued. Guarded by m_worldSocketMutex, only used by network threads.
+        std::vector<char> m_sendQueue;
+        std::vector<char> m_sendInFlight;
+        bool m_sending;
+        /// Close was called while data was still to be written, the socket is closed once it is
+        std::atomic<bool> m_closing;
+
+        /// runs on a network thread, frames the pending packets and starts writing them
+        void FlushPendingPackets();
+        /// moves the pending packets into m_sendQueue, m_worldSocketMutex must be held
+        void FramePendingPackets();
+        /// write all queued data, m_worldSocketMutex must be held
+        void StartSending();
+
         std::deque<uint32> m_opcodeHistoryOut;
         std::deque<uint32> m_opcodeHistoryInc;
 
@@ -127,10 +167,15 @@ class WorldSocket : public MaNGOS::AsyncSocket<WorldSocket>
 
     public:
         WorldSocket(boost::asio::io_context& context);
+        ~WorldSocket();
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
 
+        /// stops reading and closes the socket once the packets sent before the call are written,
+        /// so a final packet like SMSG_AUTH_RESPONSE reaches the client
+        void Close();
+
         void FinalizeSession() { m_session = nullptr; }
 
         bool OnOpen() override;
@@ -41,6 +41,7 @@
 #include "Vmap/VMapFactory.h"
 #include "BattleGround/BattleGround.h"
 #include "Util/Util.h"
+#include "Util/CodeBench.h"
 #include "Chat/Chat.h"
 #include "Entities/Vehicle.h"
 #include "Entities/TemporarySpawn.h"
@@ -4055,6 +4056,8 @@ void Spell::SendSpellCooldown()
 
 void Spell::update(uint32 difftime)
 {
+    PROFILE_ZONE("Spell::update");
+
     if (!m_updated)
     {
         m_updated = true;
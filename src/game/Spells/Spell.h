@@ -28,6 +28,7 @@
 #include "Entities/Player.h"
 #include "Server/SQLStorages.h"
 #include "Spells/SpellEffectDefines.h"
+#include "Maps/CellObjectIndex.h"
 #include "Util/UniqueTrackablePtr.h"
 
 class WorldSession;
@@ -1222,92 +1223,111 @@ namespace MaNGOS
                 return;
 
             for (typename GridRefManager<T>::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Push(itr->getSource());
+        }
+
+        // every check below accepts units at most i_radius plus their combat reach away from the center in 2D
+        bool GetIndexedQuery(CellIndexQuery& query) const
+        {
+            if (!i_originalCaster || !i_castingObject || i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX6_IGNORE_PHASE_SHIFT))
+                return false;
+
+            query.x = i_centerX;
+            query.y = i_centerY;
+            query.range = i_radius;
+            query.typeMask = TYPEMASK_UNIT;
+            query.phaseMask = i_originalCaster->GetPhaseMask();
+            return true;
+        }
+
+        void VisitIndexed(WorldObject* object) { Push(static_cast<Unit*>(object)); }
+
+        void Push(Unit* target)
+        {
+            // there are still more spells which can be casted on dead, but
+            // they are no AOE and don't have such a nice SPELL_ATTR flag
+            // mostly phase check
+            if (i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX6_IGNORE_PHASE_SHIFT))
             {
-                // there are still more spells which can be casted on dead, but
-                // they are no AOE and don't have such a nice SPELL_ATTR flag
-                // mostly phase check
-                if (i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX6_IGNORE_PHASE_SHIFT))
-                {
-                    if (!itr->getSource()->IsInMapIgnorePhase(i_originalCaster))
-                        continue;
-                }
-                else if (!itr->getSource()->IsInMap(i_originalCaster))
-                    continue;
+                if (!target->IsInMapIgnorePhase(i_originalCaster))
+                    return;
+            }
+            else if (!target->IsInMap(i_originalCaster))
+                return;
 
-                if (itr->getSource()->IsTaxiFlying())
-                    continue;
+            if (target->IsTaxiFlying())
+                return;
+
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_CHAIN_ATTACKABLE:
+                    if (target->IsChainImmune())
+                        return;
+                    break;
+                case SPELL_TARGETS_AOE_ATTACKABLE:
+                    if (target->IsAOEImmune())
+                        return;
+                    break;
+                default: break;
+            }
 
-                switch (i_TargetType)
+            switch (i_TargetType)
+            {
+                case SPELL_TARGETS_ASSISTABLE:
+                    if (!i_originalCaster->CanAssistSpell(target, i_spell.m_spellInfo))
+                        return;
+                    break;
+                case SPELL_TARGETS_CHAIN_ATTACKABLE:
+                case SPELL_TARGETS_AOE_ATTACKABLE:
                 {
-                    case SPELL_TARGETS_CHAIN_ATTACKABLE:
-                        if (itr->getSource()->IsChainImmune())
-                            continue;
-                        break;
-                    case SPELL_TARGETS_AOE_ATTACKABLE:
-                        if (itr->getSource()->IsAOEImmune())
-                            continue;
-                        break;
-                    default: break;
+                    if (!i_originalCaster->CanAttackSpell(target, i_spell.m_spellInfo, !i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX5_IGNORE_AREA_EFFECT_PVP_CHECK)))
+                        return;
+                    break;
                 }
+                case SPELL_TARGETS_ALL:
+                    break;
+                default: return;
+            }
 
-                switch (i_TargetType)
+            // we don't need to check InMap here, it's already done some lines above
+            switch (i_push_type)
+            {
+                case PUSH_CONE:
                 {
-                    case SPELL_TARGETS_ASSISTABLE:
-                        if (!i_originalCaster->CanAssistSpell(itr->getSource(), i_spell.m_spellInfo))
-                            continue;
-                        break;
-                    case SPELL_TARGETS_CHAIN_ATTACKABLE:
-                    case SPELL_TARGETS_AOE_ATTACKABLE:
+                    float heightDifference = std::abs(target->GetPositionZ() - i_centerZ);
+                    float maxHeight = i_radius / 2;
+                    float distance = std::min(sqrtf(target->GetDistance2d(i_centerX, i_centerY, DIST_CALC_NONE)), i_radius);
+                    float ratio = distance / i_radius;
+                    float conalMaxHeight = maxHeight * ratio; // pvp combat uses true cone from roughly model
+                    if (!i_originalCaster->IsControlledByPlayer() && target->IsControlledByPlayer())
+                        conalMaxHeight = maxHeight; // npcs just do a conal max Z aoe
+                    if (i_cone >= 0.f)
                     {
-                        if (!i_originalCaster->CanAttackSpell(itr->getSource(), i_spell.m_spellInfo, !i_spell.m_spellInfo->HasAttribute(SPELL_ATTR_EX5_IGNORE_AREA_EFFECT_PVP_CHECK)))
-                            continue;
-                        break;
+                        if (i_castingObject->isInFront(target, i_radius, i_cone) &&
+                            std::abs(target->GetPositionZ() - i_centerZ) - target->GetCombatReach() <= conalMaxHeight)
+                            i_data.push_back(target);
                     }
-                    case SPELL_TARGETS_ALL:
-                        break;
-                    default: continue;
-                }
-
-                // we don't need to check InMap here, it's already done some lines above
-                switch (i_push_type)
-                {
-                    case PUSH_CONE:
+                    else
                     {
-                        float heightDifference = std::abs(itr->getSource()->GetPositionZ() - i_centerZ);
-                        float maxHeight = i_radius / 2;
-                        float distance = std::min(sqrtf(itr->getSource()->GetDistance2d(i_centerX, i_centerY, DIST_CALC_NONE)), i_radius);
-                        float ratio = distance / i_radius;
-                        float conalMaxHeight = maxHeight * ratio; // pvp combat uses true cone from roughly model
-                        if (!i_originalCaster->IsControlledByPlayer() && itr->getSource()->IsControlledByPlayer())
-                            conalMaxHeight = maxHeight; // npcs just do a conal max Z aoe
-                        if (i_cone >= 0.f)
-                        {
-                            if (i_castingObject->isInFront(itr->getSource(), i_radius, i_cone) &&
-                                std::abs(itr->getSource()->GetPositionZ() - i_centerZ) - itr->getSource()->GetCombatReach() <= conalMaxHeight)
-                                i_data.push_back(itr->getSource());
-                        }
-                        else
-                        {
-                            if (i_castingObject->isInBack(itr->getSource(), i_radius, -i_cone) &&
-                                std::abs(itr->getSource()->GetPositionZ() - i_centerZ) - itr->getSource()->GetCombatReach() <= conalMaxHeight)
-                                i_data.push_back(itr->getSource());
-                        }
-                        break;
+                        if (i_castingObject->isInBack(target, i_radius, -i_cone) &&
+                            std::abs(target->GetPositionZ() - i_centerZ) - target->GetCombatReach() <= conalMaxHeight)
+                            i_data.push_back(target);
                     }
-                    case PUSH_SELF_CENTER:
-                        if (itr->getSource()->GetDistance2d(i_centerX, i_centerY, DIST_CALC_COMBAT_REACH) <= i_radius)
-                            i_data.push_back(itr->getSource());
-                        break;
-                    case PUSH_SRC_CENTER:
-                    case PUSH_DEST_CENTER:
-                    case PUSH_TARGET_CENTER:
-                        float radius = i_radius;
-                        if (i_originalCaster->IsControlledByPlayer() && !itr->getSource()->IsControlledByPlayer())
-                            radius += itr->getSource()->GetCombatReach();
-                        if (itr->getSource()->GetDistance(i_centerX, i_centerY, i_centerZ, DIST_CALC_NONE) <= radius * radius)
-                            i_data.push_back(itr->getSource());
-                        break;
+                    break;
                 }
+                case PUSH_SELF_CENTER:
+                    if (target->GetDistance2d(i_centerX, i_centerY, DIST_CALC_COMBAT_REACH) <= i_radius)
+                        i_data.push_back(target);
+                    break;
+                case PUSH_SRC_CENTER:
+                case PUSH_DEST_CENTER:
+                case PUSH_TARGET_CENTER:
+                    float radius = i_radius;
+                    if (i_originalCaster->IsControlledByPlayer() && !target->IsControlledByPlayer())
+                        radius += target->GetCombatReach();
+                    if (target->GetDistance(i_centerX, i_centerY, i_centerZ, DIST_CALC_NONE) <= radius * radius)
+                        i_data.push_back(target);
+                    break;
             }
         }
 
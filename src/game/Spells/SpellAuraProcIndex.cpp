@@ -0,0 +1,71 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Spells/SpellAuraProcIndex.h"
+#include "Spells/SpellAuras.h"
+#include "Spells/SpellMgr.h"
+
+#include <algorithm>
+
+SpellAuraProcIndex::SpellAuraProcIndex() : m_procFlags(0), m_generation(sSpellMgr.GetSpellProcEventGeneration())
+{
+}
+
+void SpellAuraProcIndex::Add(SpellAuraHolder* holder)
+{
+    SpellEntry const* spellProto = holder->GetSpellProto();
+    uint32 procFlags = SpellMgr::GetSpellProcFlags(spellProto, sSpellMgr.GetSpellProcEvent(spellProto->Id));
+    if (!procFlags)
+        return;
+
+    // after the holders of the same spell, as std::multimap::insert does
+    auto itr = std::upper_bound(m_entries.begin(), m_entries.end(), spellProto->Id, [](uint32 spellId, Entry const& entry)
+    {
+        return spellId < entry.spellId;
+    });
+    m_entries.insert(itr, { spellProto->Id, procFlags, holder });
+    m_procFlags |= procFlags;
+}
+
+void SpellAuraProcIndex::Remove(SpellAuraHolder* holder)
+{
+    auto itr = std::lower_bound(m_entries.begin(), m_entries.end(), holder->GetId(), [](Entry const& entry, uint32 spellId)
+    {
+        return entry.spellId < spellId;
+    });
+    while (itr != m_entries.end() && itr->spellId == holder->GetId() && itr->holder != holder)
+        ++itr;
+    if (itr == m_entries.end() || itr->holder != holder)
+        return;
+
+    m_entries.erase(itr);
+
+    m_procFlags = 0;
+    for (Entry const& entry : m_entries)
+        m_procFlags |= entry.procFlags;
+}
+
+bool SpellAuraProcIndex::IsCurrent() const
+{
+    return m_generation == sSpellMgr.GetSpellProcEventGeneration();
+}
+
+void SpellAuraProcIndex::SetCurrent()
+{
+    m_generation = sSpellMgr.GetSpellProcEventGeneration();
+}
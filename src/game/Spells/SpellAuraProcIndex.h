@@ -0,0 +1,89 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_SPELLAURAPROCINDEX_H
+#define MANGOS_SPELLAURAPROCINDEX_H
+
+#include "Common.h"
+
+#include <vector>
+
+class SpellAuraHolder;
+
+/**
+ * The aura holders of a unit which can proc at all, with the proc flags each reacts to, in the order of
+ * Unit::m_spellAuraHolders so procs keep happening in the same order. Holders without proc flags never
+ * pass the first check of Unit::IsTriggeredAtSpellProcEvent and are not listed, and an event sharing no
+ * flag with any listed holder is rejected at once.
+ *
+ * Proc flags of a holder come from `spell_proc_event` when set there, so the index is rebuilt by the unit
+ * after that table is reloaded.
+ */
+class SpellAuraProcIndex
+{
+    public:
+        SpellAuraProcIndex();
+
+        void Add(SpellAuraHolder* holder);
+        void Remove(SpellAuraHolder* holder);
+
+        template<class HolderMap> void Rebuild(HolderMap const& holders)
+        {
+            m_entries.clear();
+            m_procFlags = 0;
+            for (auto const& itr : holders)
+                Add(itr.second);
+            SetCurrent();
+        }
+
+        // false once `spell_proc_event` was reloaded since the index was created or rebuilt
+        bool IsCurrent() const;
+
+        // union of the proc flags of all listed holders
+        uint32 GetProcFlags() const { return m_procFlags; }
+
+        // calls visit for every listed holder sharing a flag with procFlags, in order; a holder added or removed
+        // meanwhile shifts the ones after it, which may then be skipped or visited twice
+        template<class F> void Visit(uint32 procFlags, F&& visit) const
+        {
+            if (!(procFlags & m_procFlags))
+                return;
+
+            for (size_t i = 0; i < m_entries.size(); ++i)
+                if (m_entries[i].procFlags & procFlags)
+                    visit(m_entries[i].holder);
+        }
+
+        size_t GetCount() const { return m_entries.size(); }
+
+    private:
+        void SetCurrent();
+
+        struct Entry
+        {
+            uint32 spellId;
+            uint32 procFlags;
+            SpellAuraHolder* holder;
+        };
+
+        std::vector<Entry> m_entries;                       // sorted by spell id, then by time of adding
+        uint32 m_procFlags;
+        uint32 m_generation;                                // of `spell_proc_event` the flags were read from
+};
+
+#endif
@@ -42,7 +42,7 @@ bool IsPrimaryProfessionSkill(uint32 skill)
     return true;
 }
 
-SpellMgr::SpellMgr()
+SpellMgr::SpellMgr() : m_spellProcEventGeneration(0)
 {
 }
 
@@ -830,6 +830,7 @@ struct DoSpellProcEvent
 void SpellMgr::LoadSpellProcEvents()
 {
     mSpellProcEventMap.clear();                             // need for reload case
+    ++m_spellProcEventGeneration;                           // units rebuild their proc index at next proc
 
     //                                             0      1           2                3                  4                  5                  6                  7                  8                  9                  10                 11                 12         13      14       15            16
     auto queryResult = WorldDatabase.Query("SELECT entry, SchoolMask, SpellFamilyName, SpellFamilyMaskA0, SpellFamilyMaskA1, SpellFamilyMaskA2, SpellFamilyMaskB0, SpellFamilyMaskB1, SpellFamilyMaskB2, SpellFamilyMaskC0, SpellFamilyMaskC1, SpellFamilyMaskC2, procFlags, procEx, ppmRate, CustomChance, Cooldown FROM spell_proc_event");
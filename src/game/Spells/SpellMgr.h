@@ -3003,6 +3003,15 @@ class SpellMgr
             return nullptr;
         }
 
+        // bumped at every (re)load of `spell_proc_event`
+        uint32 GetSpellProcEventGeneration() const { return m_spellProcEventGeneration; }
+
+        // proc flags an aura of the spell reacts to, the ones of its `spell_proc_event` row if any
+        static uint32 GetSpellProcFlags(SpellEntry const* spellProto, SpellProcEventEntry const* spellProcEvent)
+        {
+            return spellProcEvent && spellProcEvent->procFlags ? spellProcEvent->procFlags : spellProto->procFlags;
+        }
+
         // Spell procs from item enchants
         float GetItemEnchantProcChance(uint32 spellid) const
         {
@@ -3344,6 +3353,7 @@ class SpellMgr
         SpellElixirMap     mSpellElixirs;
         SpellThreatMap     mSpellThreatMap;
         SpellProcEventMap  mSpellProcEventMap;
+        uint32             m_spellProcEventGeneration;
         SpellProcItemEnchantMap mSpellProcItemEnchantMap;
         SkillLineAbilityMap mSkillLineAbilityMapBySpellId;
         SkillLineAbilityMap mSkillLineAbilityMapBySkillId;
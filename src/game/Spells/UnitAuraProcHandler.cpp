@@ -539,15 +539,18 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
 
     ProcTriggeredList procTriggered;
     std::vector<SpellAuraHolder*> holdersForDeletion;
-    // Fill procTriggered list
-    for (SpellAuraHolderMap::const_iterator itr = GetSpellAuraHolderMap().begin(); itr != GetSpellAuraHolderMap().end(); ++itr)
+
+    if (!m_procAuraHolders.IsCurrent())
+        m_procAuraHolders.Rebuild(m_spellAuraHolders);
+
+    // Fill procTriggered list, only holders sharing a proc flag with the event can pass IsTriggeredAtSpellProcEvent
+    m_procAuraHolders.Visit(execData.procFlags, [&](SpellAuraHolder* holder)
     {
-        SpellAuraHolder* holder = itr->second;
         // skip deleted auras (possible at recursive triggered call
         if (holder->GetState() != SPELLAURAHOLDER_STATE_READY || holder->IsDeleted())
-            continue;
+            return;
 
-        ProcTriggeredData procTriggeredData(nullptr, itr->second);
+        ProcTriggeredData procTriggeredData(nullptr, holder);
 
         SpellProcEventTriggerCheck result = IsTriggeredAtSpellProcEvent(execData, holder, procTriggeredData.spellProcEvent, procTriggeredData.canProc);
         if (holder->GetSpellProto()->HasAttribute(SPELL_ATTR_PROC_FAILURE_BURNS_CHARGE) &&
@@ -564,10 +567,10 @@ void Unit::ProcDamageAndSpellFor(ProcSystemArguments& argData, bool isVictim)
         }
 
         if (result != SpellProcEventTriggerCheck::SPELL_PROC_TRIGGER_OK)
-            continue;
+            return;
 
         procTriggered.emplace_back(procTriggeredData);
-    }
+    });
 
     for (SpellAuraHolder* holder : holdersForDeletion)
         if (holder->DropAuraCharge())
@@ -648,11 +651,7 @@ Unit::SpellProcEventTriggerCheck Unit::IsTriggeredAtSpellProcEvent(ProcExecution
     spellProcEvent = sSpellMgr.GetSpellProcEvent(spellProto->Id);
 
     // Get EventProcFlag
-    uint32 EventProcFlag;
-    if (spellProcEvent && spellProcEvent->procFlags) // if exist get custom spellProcEvent->procFlags
-        EventProcFlag = spellProcEvent->procFlags;
-    else
-        EventProcFlag = spellProto->procFlags;       // else get from spell proto
+    uint32 EventProcFlag = SpellMgr::GetSpellProcFlags(spellProto, spellProcEvent);
     // Continue if no trigger exist
     if (!EventProcFlag)
         return SpellProcEventTriggerCheck::SPELL_PROC_TRIGGER_FAILED;
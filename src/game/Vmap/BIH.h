@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <type_traits>
 
 #define MAX_STACK_SIZE 64
 
@@ -61,6 +62,14 @@ struct AABound
     Vector3 lo, hi;
 };
 
+// ray callbacks defining intersectLeaf(ray, firstSlot, count, maxDist) are given a whole leaf at once,
+// as a range of slots of BIH::getObjects(), instead of one object at a time
+template<typename RayCallback, typename = void>
+struct HasLeafIntersection : std::false_type {};
+
+template<typename RayCallback>
+struct HasLeafIntersection<RayCallback, std::void_t<decltype(&RayCallback::intersectLeaf)>> : std::true_type {};
+
 /** Bounding Interval Hierarchy Class.
     Building and Ray-Intersection functions based on BIH from
     Sunflow, a Java Raytracer, released under MIT/X11 License
@@ -117,6 +126,8 @@ class BIH
             delete[] dat.indices;
         }
         size_t primCount() const { return objects.size(); }
+        // object index of every slot, the objects of a leaf are in consecutive slots
+        std::vector<uint32> const& getObjects() const { return objects; }
 
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false, bool ignoreM2Model = false) const
@@ -219,12 +230,20 @@ class BIH
                         {
                             // leaf - test some objects
                             int n = tree[node + 1];
-                            while (n > 0)
+                            if constexpr (HasLeafIntersection<RayCallback>::value)
                             {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst, ignoreM2Model);
+                                bool hit = intersectCallback.intersectLeaf(r, offset, n, maxDist);
                                 if (stopAtFirst && hit) return;
-                                --n;
-                                ++offset;
+                            }
+                            else
+                            {
+                                while (n > 0)
+                                {
+                                    bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst, ignoreM2Model);
+                                    if (stopAtFirst && hit) return;
+                                    --n;
+                                    ++offset;
+                                }
                             }
                             break;
                         }
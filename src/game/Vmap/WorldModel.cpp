@@ -22,6 +22,11 @@
 #include "ModelInstance.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #include <emmintrin.h>
+ #define VMAP_SSE_TRIANGLES
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -32,15 +37,12 @@ template<> struct BoundsTrait<VMAP::GroupModel>
 
 namespace VMAP
 {
-    bool IntersectTriangle(MeshTriangle const& tri, std::vector<Vector3>::const_iterator points, G3D::Ray const& ray, float& distance)
-    {
 #define EPS 1e-5f
 
+    bool IntersectTriangle(Vector3 const& idx0, Vector3 const& e1, Vector3 const& e2, G3D::Ray const& ray, float& distance)
+    {
         // See RTR2 ch. 13.7 for the algorithm.
 
-        Vector3 const idx0 = points[tri.idx0];
-        Vector3 const e1 = points[tri.idx1] - idx0;
-        Vector3 const e2 = points[tri.idx2] - idx0;
         Vector3 const p(ray.direction().cross(e2));
         float a = e1.dot(p);
 
@@ -86,6 +88,130 @@ namespace VMAP
         return false;
     }
 
+    // ===================== LeafTriangles ==================================
+
+    void LeafTriangles::build(std::vector<Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, BIH const& tree)
+    {
+        std::vector<uint32> const& objects = tree.getObjects();
+        // padded to a whole batch past the last slot, so a batch is always loaded from valid memory
+        size_t size = triangles.empty() ? 0 : objects.size() + 3;
+        for (int i = 0; i < 3; ++i)
+        {
+            v0[i].assign(size, 0.0f);
+            e1[i].assign(size, 0.0f);
+            e2[i].assign(size, 0.0f);
+        }
+
+        for (size_t slot = 0; slot < objects.size(); ++slot)
+        {
+            MeshTriangle const& tri = triangles[objects[slot]];
+            Vector3 const idx0 = vertices[tri.idx0];
+            Vector3 const edge1 = vertices[tri.idx1] - idx0;
+            Vector3 const edge2 = vertices[tri.idx2] - idx0;
+            for (int i = 0; i < 3; ++i)
+            {
+                v0[i][slot] = idx0[i];
+                e1[i][slot] = edge1[i];
+                e2[i][slot] = edge2[i];
+            }
+        }
+    }
+
+    void LeafTriangles::clear()
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            v0[i].clear();
+            e1[i].clear();
+            e2[i].clear();
+        }
+    }
+
+#ifdef VMAP_SSE_TRIANGLES
+    // Same test as IntersectTriangle for four triangles at once, with the same operations in the same order,
+    // so each lane computes exactly what the scalar test would. Comparisons are written so that NaN lanes are
+    // accepted or rejected like there too. The closest accepted hit of the four is kept.
+    bool LeafTriangles::intersect(G3D::Ray const& ray, uint32 firstSlot, uint32 count, float& distance) const
+    {
+        __m128 const ox = _mm_set1_ps(ray.origin().x);
+        __m128 const oy = _mm_set1_ps(ray.origin().y);
+        __m128 const oz = _mm_set1_ps(ray.origin().z);
+        __m128 const dx = _mm_set1_ps(ray.direction().x);
+        __m128 const dy = _mm_set1_ps(ray.direction().y);
+        __m128 const dz = _mm_set1_ps(ray.direction().z);
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const eps = _mm_set1_ps(EPS);
+        __m128 const absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        bool hit = false;
+        for (uint32 slot = firstSlot; count > 0; slot += 4)
+        {
+            uint32 lanes = count < 4 ? count : 4;
+            count -= lanes;
+
+            __m128 const e1x = _mm_loadu_ps(&e1[0][slot]);
+            __m128 const e1y = _mm_loadu_ps(&e1[1][slot]);
+            __m128 const e1z = _mm_loadu_ps(&e1[2][slot]);
+            __m128 const e2x = _mm_loadu_ps(&e2[0][slot]);
+            __m128 const e2y = _mm_loadu_ps(&e2[1][slot]);
+            __m128 const e2z = _mm_loadu_ps(&e2[2][slot]);
+
+            // p = dir x e2, a = e1 . p
+            __m128 const px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 const py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 const pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 const a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 mask = _mm_cmpnlt_ps(_mm_and_ps(a, absMask), eps);
+
+            // s = origin - v0, u = f * (s . p)
+            __m128 const f = _mm_div_ps(one, a);
+            __m128 const sx = _mm_sub_ps(ox, _mm_loadu_ps(&v0[0][slot]));
+            __m128 const sy = _mm_sub_ps(oy, _mm_loadu_ps(&v0[1][slot]));
+            __m128 const sz = _mm_sub_ps(oz, _mm_loadu_ps(&v0[2][slot]));
+            __m128 const u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpnlt_ps(u, zero), _mm_cmpngt_ps(u, one)));
+
+            // q = s x e1, v = f * (dir . q)
+            __m128 const qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 const qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 const qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            __m128 const v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpnlt_ps(v, zero), _mm_cmpngt_ps(_mm_add_ps(u, v), one)));
+
+            // t = f * (e2 . q)
+            __m128 const t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+            mask = _mm_and_ps(mask, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+
+            int hits = _mm_movemask_ps(mask) & ((1 << lanes) - 1);
+            if (!hits)
+                continue;
+
+            float lane[4];
+            _mm_storeu_ps(lane, t);
+            for (uint32 i = 0; i < 4; ++i)
+                if ((hits & (1 << i)) && lane[i] < distance)
+                    distance = lane[i];
+            hit = true;
+        }
+        return hit;
+    }
+#else
+    bool LeafTriangles::intersect(G3D::Ray const& ray, uint32 firstSlot, uint32 count, float& distance) const
+    {
+        bool hit = false;
+        for (uint32 slot = firstSlot; slot < firstSlot + count; ++slot)
+        {
+            Vector3 const idx0(v0[0][slot], v0[1][slot], v0[2][slot]);
+            Vector3 const edge1(e1[0][slot], e1[1][slot], e1[2][slot]);
+            Vector3 const edge2(e2[0][slot], e2[1][slot], e2[2][slot]);
+            if (IntersectTriangle(idx0, edge1, edge2, ray, distance))
+                hit = true;
+        }
+        return hit;
+    }
+#endif
+
     class TriBoundFunc
     {
         public:
@@ -265,7 +391,7 @@ namespace VMAP
 
     GroupModel::GroupModel(GroupModel const& other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), leafTriangles(other.leafTriangles), iLiquid(nullptr)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -277,6 +403,7 @@ namespace VMAP
         triangles.swap(tri);
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
+        leafTriangles.build(vertices, triangles, meshTree);
     }
 
     bool GroupModel::writeToFile(FILE* wf)
@@ -332,6 +459,7 @@ namespace VMAP
         uint32 count = 0;
         triangles.clear();
         vertices.clear();
+        leafTriangles.clear();
         delete iLiquid;
         iLiquid = nullptr;
 
@@ -361,6 +489,12 @@ namespace VMAP
         // read mesh BIH
         if (result && !readChunk(rf, chunk, "MBIH", 4)) result = false;
         if (result) result = meshTree.readFromFile(rf);
+        if (result) leafTriangles.build(vertices, triangles, meshTree);
+#ifndef NO_CORE_FUNCS
+        // only the tools write the mesh again or hand it out
+        std::vector<Vector3>().swap(vertices);
+        std::vector<MeshTriangle>().swap(triangles);
+#endif
 
         // read liquid data
         if (result && !readChunk(rf, chunk, "LIQU", 4)) result = false;
@@ -372,33 +506,31 @@ namespace VMAP
 
     struct GModelRayCallback
     {
-        GModelRayCallback(const std::vector<MeshTriangle>& tris, const std::vector<Vector3>& vert):
-            vertices(vert.begin()), triangles(tris.begin()), hit(false) {}
-        bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool /*pStopAtFirstHit*/, bool /*ignoreM2Model*/)
+        GModelRayCallback(LeafTriangles const& tris): triangles(tris), hit(false) {}
+        bool intersectLeaf(const G3D::Ray& ray, uint32 firstSlot, uint32 count, float& distance)
         {
-            bool result = IntersectTriangle(triangles[entry], vertices, ray, distance);
+            bool result = triangles.intersect(ray, firstSlot, count, distance);
             if (result)
                 hit = true;
             return hit;
         }
-        std::vector<Vector3>::const_iterator vertices;
-        std::vector<MeshTriangle>::const_iterator triangles;
+        LeafTriangles const& triangles;
         bool hit;
     };
 
     bool GroupModel::IntersectRay(G3D::Ray const& ray, float& distance, bool stopAtFirstHit, bool ignoreM2Model) const
     {
-        if (triangles.empty())
+        if (leafTriangles.empty())
             return false;
 
-        GModelRayCallback callback(triangles, vertices);
+        GModelRayCallback callback(leafTriangles);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit, ignoreM2Model);
         return callback.hit;
     }
 
     bool GroupModel::IsInsideObject(Vector3 const& pos, Vector3 const& down, float& z_dist) const
     {
-        if (triangles.empty() || !iBound.contains(pos))
+        if (leafTriangles.empty() || !iBound.contains(pos))
             return false;
 
         Vector3 rPos = pos - 0.1f * down;
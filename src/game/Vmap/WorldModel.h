@@ -45,6 +45,23 @@ namespace VMAP
             uint32 idx2;
     };
 
+    /*! Triangles of a group model copied in the order of the leaves of its mesh BIH, with the first vertex
+        and both edges from it stored one coordinate per array, so the triangles of a leaf are tested together.
+        The server only tests rays against these, so it releases the vertices and triangles they are built from. */
+    class LeafTriangles
+    {
+        public:
+            void build(std::vector<Vector3> const& vertices, std::vector<MeshTriangle> const& triangles, BIH const& tree);
+            void clear();
+            bool empty() const { return v0[0].empty(); }
+            //! tests the triangles of slots [firstSlot, firstSlot + count), distance becomes the one of the closest hit
+            bool intersect(G3D::Ray const& ray, uint32 firstSlot, uint32 count, float& distance) const;
+        private:
+            std::vector<float> v0[3];
+            std::vector<float> e1[3];
+            std::vector<float> e2[3];
+    };
+
     class WmoLiquid
     {
         public:
@@ -102,6 +119,7 @@ namespace VMAP
             std::vector<Vector3> vertices;
             std::vector<MeshTriangle> triangles;
             BIH meshTree;
+            LeafTriangles leafTriangles;
             WmoLiquid* iLiquid;
 
 #ifdef MMAP_GENERATOR
@@ -63,6 +63,7 @@
 #include "MotionGenerators/WaypointManager.h"
 #include "GMTickets/GMTicketMgr.h"
 #include "Util/Util.h"
+#include "Util/CodeBench.h"
 #include "Tools/CharacterDatabaseCleaner.h"
 #include "Entities/CreatureLinkingMgr.h"
 #include "Calendar/Calendar.h"
@@ -80,6 +81,7 @@
 
 #ifdef BUILD_METRICS
  #include "Metric/Metric.h"
+ #include "Metric/Instrument.h"
 #endif
 
 #ifdef ENABLE_PLAYERBOTS
@@ -517,6 +519,7 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
+    setConfig(CONFIG_BOOL_GRID_PREFETCH, "GridPrefetch", true);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
@@ -666,6 +669,10 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_UINT32_NUM_MAP_THREADS, "MapUpdate.Threads", 3);
+    setConfig(CONFIG_BOOL_MAP_PARALLEL_CELL_UPDATE, "MapUpdate.ParallelCells", false);
+    setConfig(CONFIG_BOOL_MAP_PARALLEL_PACKET_BUILD, "MapUpdate.ParallelPackets", true);
+    setConfig(CONFIG_UINT32_MAP_TICK_BUDGET, "MapUpdate.TickBudget", 0);
+    setConfig(CONFIG_BOOL_MAP_GEOMETRY_CACHE, "MapUpdate.GeometryCache", true);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_ORANGE, "SkillChance.Orange", 100);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_YELLOW, "SkillChance.Yellow", 75);
     setConfig(CONFIG_UINT32_SKILL_CHANCE_GREEN,  "SkillChance.Green",  25);
@@ -1645,6 +1652,10 @@ void World::DetectDBCLang()
 /// Update the World !
 void World::Update(uint32 diff)
 {
+    // no zone is open on any thread between two ticks
+    Profiler::Instance().OnWorldTickStart();
+    PROFILE_ZONE("World::Update");
+
     m_currentMSTime = WorldTimer::getMSTime();
     m_currentTime = std::chrono::time_point_cast<std::chrono::milliseconds>(Clock::now());
     m_currentDiff = diff;
@@ -1853,14 +1864,22 @@ void World::Update(uint32 diff)
     long long singletons = (postSingletonTime - postMapTime).count();
     long long cleanup = (updateEndTime - postSingletonTime).count();
 
-    metric::measurement meas("world.update");
-    meas.add_field("total", std::to_string(total));
-    meas.add_field("presession", std::to_string(presession));
-    meas.add_field("premap", std::to_string(premap));
-    meas.add_field("map", std::to_string(map));
-    meas.add_field("singletons", std::to_string(singletons));
-    meas.add_field("cleanup", std::to_string(cleanup));
+    static metric::histogram const totalMetric("world.update", { { "phase", "total" } });
+    static metric::histogram const presessionMetric("world.update", { { "phase", "presession" } });
+    static metric::histogram const premapMetric("world.update", { { "phase", "premap" } });
+    static metric::histogram const mapMetric("world.update", { { "phase", "map" } });
+    static metric::histogram const singletonsMetric("world.update", { { "phase", "singletons" } });
+    static metric::histogram const cleanupMetric("world.update", { { "phase", "cleanup" } });
+
+    totalMetric.observe(double(total));
+    presessionMetric.observe(double(presession));
+    premapMetric.observe(double(premap));
+    mapMetric.observe(double(map));
+    singletonsMetric.observe(double(singletons));
+    cleanupMetric.observe(double(cleanup));
 #endif
+
+    Profiler::Instance().OnWorldTick(uint32(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - m_currentTime).count()));
 }
 
 namespace MaNGOS
@@ -2944,6 +2963,13 @@ void World::GeneratePacketMetrics()
 
     metric::measurement meas_latency("world.metrics.latency");
     meas_latency.add_field("online", std::to_string(GetAverageLatency()));
+
+    std::vector<float> utilisation = sMapMgr.GetMapUpdater().thread_utilisation();
+    for (size_t i = 0; i < utilisation.size(); ++i)
+    {
+        metric::measurement meas_thread("world.metrics.mapthreads", { { "thread", std::to_string(i) } });
+        meas_thread.add_field("utilisation", std::to_string(utilisation[i]));
+    }
 }
 
 uint32 World::GetAverageLatency() const
@@ -152,6 +152,7 @@ enum eConfigUInt32Values
     CONFIG_UINT32_MASS_MAILER_SEND_PER_TICK,
     CONFIG_UINT32_UPTIME_UPDATE,
     CONFIG_UINT32_NUM_MAP_THREADS,
+    CONFIG_UINT32_MAP_TICK_BUDGET,
     CONFIG_UINT32_AUCTION_DEPOSIT_MIN,
     CONFIG_UINT32_SKILL_CHANCE_ORANGE,
     CONFIG_UINT32_SKILL_CHANCE_YELLOW,
@@ -418,6 +419,10 @@ enum eConfigBoolValues
     CONFIG_BOOL_DISABLE_INSTANCE_RELOCATE,
     CONFIG_BOOL_PRELOAD_MMAP_TILES,
     CONFIG_BOOL_SPECIALS_ACTIVE,
+    CONFIG_BOOL_MAP_PARALLEL_CELL_UPDATE,
+    CONFIG_BOOL_MAP_PARALLEL_PACKET_BUILD,
+    CONFIG_BOOL_GRID_PREFETCH,
+    CONFIG_BOOL_MAP_GEOMETRY_CACHE,
     CONFIG_BOOL_VALUE_COUNT
 };
 
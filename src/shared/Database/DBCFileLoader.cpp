@@ -21,68 +21,44 @@
 #include <string.h>
 
 #include "DBCFileLoader.h"
+#include "Util/MappedFile.h"
 
 DBCFileLoader::DBCFileLoader()
 {
     data = nullptr;
     fieldsOffset = nullptr;
+    dataInPlace = false;
 }
 
 bool DBCFileLoader::Load(const char* filename, const char* fmt)
 {
-    uint32 header;
-    delete[] data;
-
-    FILE* f = fopen(filename, "rb");
-    if (!f)
-        return false;
-
-    if (fread(&header, 4, 1, f) != 1)                       // Number of records
-    {
-        fclose(f);
-        return false;
-    }
-
-
-    EndianConvert(header);
-
-    if (header != 0x43424457)                               //'WDBC'
-    {
-        fclose(f);
-        return false;
-    }
+    delete[] fieldsOffset;
+    fieldsOffset = nullptr;
+    data = nullptr;
 
-    if (fread(&recordCount, 4, 1, f) != 1)                  // Number of records
-    {
-        fclose(f);
+    file = MappedFile::Open(filename);
+    if (!file)
         return false;
-    }
-
-    EndianConvert(recordCount);
 
-    if (fread(&fieldCount, 4, 1, f) != 1)                   // Number of fields
-    {
-        fclose(f);
+    uint32 const headerSize = 5 * 4;
+    if (file->GetSize() < headerSize)
         return false;
-    }
 
-    EndianConvert(fieldCount);
+    uint32 header[5];
+    memcpy(header, file->GetData(), headerSize);
+    for (uint32& value : header)
+        EndianConvert(value);
 
-    if (fread(&recordSize, 4, 1, f) != 1)                   // Size of a record
-    {
-        fclose(f);
+    if (header[0] != 0x43424457)                            //'WDBC'
         return false;
-    }
 
-    EndianConvert(recordSize);
+    recordCount = header[1];                                // Number of records
+    fieldCount = header[2];                                 // Number of fields
+    recordSize = header[3];                                 // Size of a record
+    stringSize = header[4];                                 // String size
 
-    if (fread(&stringSize, 4, 1, f) != 1)                   // String size
-    {
-        fclose(f);
+    if (file->GetSize() - headerSize < uint64(recordSize) * recordCount + stringSize)
         return false;
-    }
-
-    EndianConvert(stringSize);
 
     fieldsOffset = new uint32[fieldCount];
     fieldsOffset[0] = 0;
@@ -95,22 +71,14 @@ bool DBCFileLoader::Load(const char* filename, const char* fmt)
             fieldsOffset[i] += 4;
     }
 
-    data = new unsigned char[recordSize * recordCount + stringSize];
+    // records and strings are used where they are, in the mapped file
+    data = file->GetData() + headerSize;
     stringTable = data + recordSize * recordCount;
-
-    if (fread(data, recordSize * recordCount + stringSize, 1, f) != 1)
-    {
-        fclose(f);
-        return false;
-    }
-
-    fclose(f);
     return true;
 }
 
 DBCFileLoader::~DBCFileLoader()
 {
-    delete[] data;
     delete[] fieldsOffset;
 }
 
@@ -208,6 +176,16 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
         indexTable = new ptr[recordCount];
     }
 
+    // records already laid out as the structure are used from the file
+    dataInPlace = IsFileLayout(format) && recordSize == recordsize;
+    if (dataInPlace)
+    {
+        for (uint32 y = 0; y < recordCount; ++y)
+            indexTable[i >= 0 ? getRecord(y).getUInt(i) : y] = reinterpret_cast<char*>(data + y * recordSize);
+
+        return reinterpret_cast<char*>(data);
+    }
+
     char* dataTable = new char[recordCount * recordsize];
 
     uint32 offset = 0;
@@ -259,13 +237,10 @@ char* DBCFileLoader::AutoProduceData(const char* format, uint32& records, char**
     return dataTable;
 }
 
-char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
+bool DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
 {
     if (strlen(format) != fieldCount)
-        return nullptr;
-
-    char* stringPool = new char[stringSize];
-    memcpy(stringPool, stringTable, stringSize);
+        return false;
 
     uint32 offset = 0;
 
@@ -291,8 +266,7 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
                     char** slot = (char**)(&dataTable[offset]);
                     if (!*slot || !** slot)
                     {
-                        const char* st = getRecord(y).getString(x);
-                        *slot = stringPool + (st - (const char*)stringTable);
+                        *slot = const_cast<char*>(getRecord(y).getString(x));
                     }
                     offset += sizeof(char*);
                     break;
@@ -311,5 +285,29 @@ char* DBCFileLoader::AutoProduceStrings(const char* format, char* dataTable)
         }
     }
 
-    return stringPool;
+    return true;
+}
+
+bool DBCFileLoader::IsFileLayout(const char* format)
+{
+#if MANGOS_ENDIAN == MANGOS_BIG_ENDIAN
+    (void)format;
+    return false;                                           // values are stored little endian
+#else
+    // only fields stored in the file with the same size as in the structure, strings are offsets in the file
+    for (uint32 x = 0; format[x]; ++x)
+    {
+        switch (format[x])
+        {
+            case FT_FLOAT:
+            case FT_INT:
+            case FT_IND:
+            case FT_BYTE:
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+#endif
 }
@@ -21,6 +21,9 @@
 #include "Platform/Define.h"
 #include "Util/ByteConverter.h"
 #include <cassert>
+#include <memory>
+
+class MappedFile;
 
 enum FieldFormat
 {
@@ -93,10 +96,16 @@ class DBCFileLoader
         uint32 GetCols() const { return fieldCount; }
         uint32 GetOffset(size_t id) const { return (fieldsOffset != nullptr && id < fieldCount) ? fieldsOffset[id] : 0; }
         bool IsLoaded() const { return data != nullptr; }
+        // data table of the records, pointing into the file when IsDataInPlace() afterwards
         char* AutoProduceData(const char* format, uint32& records, char**& indexTable);
-        char* AutoProduceStrings(const char* format, char* dataTable);
+        // string fields point into the file, which must be kept as long as the data table is used
+        bool AutoProduceStrings(const char* format, char* dataTable);
+        bool IsDataInPlace() const { return dataInPlace; }
+        std::shared_ptr<MappedFile> const& GetFile() const { return file; }
         static uint32 GetFormatRecordSize(const char* format, int32* index_pos = nullptr);
     private:
+        // true when records of this format are stored in the file exactly as in their structure
+        static bool IsFileLayout(const char* format);
 
         uint32 recordSize;
         uint32 recordCount;
@@ -105,5 +114,7 @@ class DBCFileLoader
         uint32* fieldsOffset;
         unsigned char* data;
         unsigned char* stringTable;
+        bool dataInPlace;
+        std::shared_ptr<MappedFile> file;
 };
 #endif
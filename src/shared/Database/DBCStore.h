@@ -21,12 +21,15 @@
 
 #include "DBCFileLoader.h"
 
+#include <list>
+#include <memory>
+
 template<class T>
 class DBCStorage
 {
-        typedef std::list<char*> StringPoolList;
+        typedef std::list<std::shared_ptr<MappedFile>> FileList;
     public:
-        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr) { }
+        explicit DBCStorage(const char* f) : nCount(0), fieldCount(0), fmt(f), indexTable(nullptr), m_dataTable(nullptr), m_dataInPlace(false) { }
         ~DBCStorage() { Clear(); }
 
         T const* LookupEntry(uint32 id) const { return (id >= nCount) ? nullptr : indexTable[id]; }
@@ -45,9 +48,13 @@ class DBCStorage
 
             // load raw non-string data
             m_dataTable = (T*)dbc.AutoProduceData(fmt, nCount, (char**&)indexTable);
+            m_dataInPlace = dbc.IsDataInPlace();
 
             // load strings from dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            dbc.AutoProduceStrings(fmt, (char*)m_dataTable);
+
+            // strings and in place records point into the file
+            m_files.push_back(dbc.GetFile());
 
             // error in dbc file at loading if nullptr
             return indexTable != nullptr;
@@ -65,7 +72,8 @@ class DBCStorage
                 return false;
 
             // load strings from another locale dbc data
-            m_stringPoolList.push_back(dbc.AutoProduceStrings(fmt, (char*)m_dataTable));
+            if (dbc.AutoProduceStrings(fmt, (char*)m_dataTable))
+                m_files.push_back(dbc.GetFile());
 
             return true;
         }
@@ -77,14 +85,12 @@ class DBCStorage
 
             delete[]((char*)indexTable);
             indexTable = nullptr;
-            delete[]((char*)m_dataTable);
+            if (!m_dataInPlace)
+                delete[]((char*)m_dataTable);
             m_dataTable = nullptr;
+            m_dataInPlace = false;
 
-            while (!m_stringPoolList.empty())
-            {
-                delete[] m_stringPoolList.front();
-                m_stringPoolList.pop_front();
-            }
+            m_files.clear();
             nCount = 0;
         }
 
@@ -97,7 +103,8 @@ class DBCStorage
         char const* fmt;
         T** indexTable;
         T* m_dataTable;
-        StringPoolList m_stringPoolList;
+        bool m_dataInPlace;                                 // records are used from the first file
+        FileList m_files;
 };
 
 #endif
@@ -139,6 +139,12 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
     if (!m_pAsyncConn->Initialize(infoString))
         return false;
 
+    // last field of the connection string, only used to tell the databases apart
+    m_databaseName = infoString;
+    size_t nameStart = m_databaseName.find_last_of(';');
+    if (nameStart != std::string::npos)
+        m_databaseName = m_databaseName.substr(nameStart + 1);
+
     m_pResultQueue = new SqlResultQueue;
 
     InitDelayThread();
@@ -164,7 +170,7 @@ void Database::StopServer()
 SqlDelayThread* Database::CreateDelayThread()
 {
     assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    return new SqlDelayThread(this, m_pAsyncConn, m_databaseName);
 }
 
 void Database::InitDelayThread()
@@ -413,6 +419,14 @@ bool Database::CommitTransaction()
     return true;
 }
 
+bool Database::CommitTransaction(SqlTransactionFailure const& failure)
+{
+    if (m_currentTransaction.get())
+        m_currentTransaction->SetFailure(failure);
+
+    return CommitTransaction();
+}
+
 bool Database::CommitTransactionDirect()
 {
     if (!m_pAsyncConn)
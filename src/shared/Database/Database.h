@@ -187,6 +187,8 @@ class Database
 
         bool BeginTransaction();
         bool CommitTransaction();
+        // failure is raised if the transaction is rolled back, which may only happen after the call returned
+        bool CommitTransaction(SqlTransactionFailure const& failure);
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
@@ -286,6 +288,7 @@ class Database
 
         bool m_logSQL;
         std::string m_logsDir;
+        std::string m_databaseName;
         uint32 m_pingIntervallms;
 };
 #endif
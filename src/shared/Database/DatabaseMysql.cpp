@@ -205,8 +205,67 @@ bool MySQLConnection::_Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD**
     return true;
 }
 
+bool MySQLConnection::_QueryStmt(const char* sql, std::unique_ptr<QueryResultMysqlStmt>& result, QueryFieldNames* names)
+{
+    if (!mMysql)
+        return false;
+
+    MYSQL_STMT* stmt = mysql_stmt_init(mMysql);
+    if (!stmt)
+        return false;
+
+    // statements the server cannot prepare are sent again as text, which also reports their errors
+    if (mysql_stmt_prepare(stmt, sql, strlen(sql)))
+    {
+        mysql_stmt_close(stmt);
+        return false;
+    }
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_stmt_execute(stmt))
+    {
+        sLog.outErrorDb("SQL: %s", sql);
+        sLog.outErrorDb("query ERROR: %s", mysql_stmt_error(stmt));
+        mysql_stmt_close(stmt);
+        return true;
+    }
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL: %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), sql);
+
+    if (MYSQL_RES* metadata = mysql_stmt_result_metadata(stmt))
+    {
+        uint32 fieldCount = mysql_num_fields(metadata);
+        MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+        if (names)
+        {
+            names->resize(fieldCount);
+            for (uint32 i = 0; i < fieldCount; ++i)
+                (*names)[i] = fields[i].name;
+        }
+
+        // rows are read from the connection here, the statement is not needed by the result afterwards
+        result = std::make_unique<QueryResultMysqlStmt>(stmt, fields, fieldCount);
+        mysql_free_result(metadata);
+
+        if (!result->GetRowCount())
+            result.reset();
+    }
+
+    mysql_stmt_close(stmt);
+    return true;
+}
+
 std::unique_ptr<QueryResult> MySQLConnection::Query(const char* sql)
 {
+    std::unique_ptr<QueryResultMysqlStmt> stmtResult;
+    if (_QueryStmt(sql, stmtResult, nullptr))
+    {
+        if (stmtResult)
+            stmtResult->NextRow();
+        return stmtResult;
+    }
+
     MYSQL_RES* result = nullptr;
     MYSQL_FIELD* fields = nullptr;
     uint64 rowCount = 0;
@@ -223,6 +282,17 @@ std::unique_ptr<QueryResult> MySQLConnection::Query(const char* sql)
 
 QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
 {
+    std::unique_ptr<QueryResultMysqlStmt> stmtResult;
+    QueryFieldNames names;
+    if (_QueryStmt(sql, stmtResult, &names))
+    {
+        if (!stmtResult)
+            return nullptr;
+
+        stmtResult->NextRow();
+        return new QueryNamedResult(stmtResult.release(), names);
+    }
+
     MYSQL_RES* result = nullptr;
     MYSQL_FIELD* fields = nullptr;
     uint64 rowCount = 0;
@@ -231,7 +301,7 @@ QueryNamedResult* MySQLConnection::QueryNamed(const char* sql)
     if (!_Query(sql, &result, &fields, &rowCount, &fieldCount))
         return nullptr;
 
-    QueryFieldNames names(fieldCount);
+    names.resize(fieldCount);
     for (uint32 i = 0; i < fieldCount; ++i)
         names[i] = fields[i].name;
 
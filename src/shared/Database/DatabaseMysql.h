@@ -28,6 +28,8 @@
 
 #include <mysql.h>
 
+class QueryResultMysqlStmt;
+
 // MySQL prepared statement class
 class MySqlPreparedStatement : public SqlPreparedStatement
 {
@@ -86,6 +88,8 @@ class MySQLConnection : public SqlConnection
     private:
         bool _TransactionCmd(const char* sql);
         bool _Query(const char* sql, MYSQL_RES** pResult, MYSQL_FIELD** pFields, uint64* pRowCount, uint32* pFieldCount);
+        // runs a query with the binary protocol, false if it cannot be prepared and has to be sent as text
+        bool _QueryStmt(const char* sql, std::unique_ptr<QueryResultMysqlStmt>& result, QueryFieldNames* names);
 
         MYSQL* mMysql;
 };
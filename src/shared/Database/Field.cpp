@@ -21,6 +21,32 @@
 
 #include <iomanip>
 
+void Field::FormatNative() const
+{
+    switch (mStorage)
+    {
+        case STORAGE_INT64:  snprintf(mText, sizeof(mText), SI64FMTD, mNative.i64); break;
+        case STORAGE_UINT64: snprintf(mText, sizeof(mText), UI64FMTD, mNative.ui64); break;
+        case STORAGE_DOUBLE:
+        {
+            // shortest text reading back as the same value, as the text protocol sends it; values of
+            // FLOAT columns only have to read back as the same float
+            bool single = static_cast<double>(static_cast<float>(mNative.d)) == mNative.d;
+            for (int precision = 1; precision <= 17; ++precision)
+            {
+                snprintf(mText, sizeof(mText), "%.*g", precision, mNative.d);
+                double parsed = strtod(mText, nullptr);
+                if (single ? static_cast<float>(parsed) == static_cast<float>(mNative.d) : parsed == mNative.d)
+                    break;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    mTextFormatted = true;
+}
+
 time_t Field::GetTime() const
 {
     std::string time = GetCppString();
@@ -34,8 +34,8 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN), mStorage(STORAGE_TEXT), mTextFormatted(false) { mNative.ui64 = 0; }
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mStorage(STORAGE_TEXT), mTextFormatted(false) { mNative.ui64 = 0; }
 
         ~Field() {}
 
@@ -44,21 +44,63 @@ class Field
 
         const char* GetString() const
         {
+            if (mStorage != STORAGE_TEXT && !mTextFormatted)
+                FormatNative();
             return mValue ? mValue : ""; // We need this null check as we do not always null check what we get back from the database everywhere
         }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            return GetString();                             // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<float>(GetNativeDouble());
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return GetNativeInteger() > 0;
+            return mValue ? atoi(mValue) > 0 : false;
+        }
+        int32 GetInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int32>(GetNativeInteger());
+            return mValue ? static_cast<int32>(atol(mValue)) : int32(0);
+        }
+        uint8 GetUInt8() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint8>(GetNativeInteger());
+            return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0);
+        }
+        uint16 GetUInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint16>(GetNativeInteger());
+            return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0);
+        }
+        int16 GetInt16() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<int16>(GetNativeInteger());
+            return mValue ? static_cast<int16>(atol(mValue)) : int16(0);
+        }
+        uint32 GetUInt32() const
+        {
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint32>(GetNativeInteger());
+            return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0);
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
+            if (mStorage == STORAGE_UINT64)
+                return mNative.ui64;
+            if (mStorage != STORAGE_TEXT)
+                return static_cast<uint64>(GetNativeInteger());
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -70,13 +112,47 @@ class Field
         void SetType(enum DataTypes type) { mType = type; }
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
-        void SetValue(const char* value) { mValue = value; }
+        void SetValue(const char* value) { mValue = value; mStorage = STORAGE_TEXT; }
+        // values of results read in binary form, their text is only formatted when asked for
+        void SetInt64(int64 value) { mNative.i64 = value; SetNative(STORAGE_INT64); }
+        void SetUInt64(uint64 value) { mNative.ui64 = value; SetNative(STORAGE_UINT64); }
+        void SetDouble(double value) { mNative.d = value; SetNative(STORAGE_DOUBLE); }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        enum Storage
+        {
+            STORAGE_TEXT,                                   // mValue points to the text of the value or is null
+            STORAGE_INT64,
+            STORAGE_UINT64,
+            STORAGE_DOUBLE
+        };
+
+        void SetNative(Storage storage) { mStorage = storage; mValue = mText; mTextFormatted = false; }
+        int64 GetNativeInteger() const { return mStorage == STORAGE_DOUBLE ? static_cast<int64>(mNative.d) : mNative.i64; }
+        double GetNativeDouble() const
+        {
+            switch (mStorage)
+            {
+                case STORAGE_INT64: return static_cast<double>(mNative.i64);
+                case STORAGE_UINT64: return static_cast<double>(mNative.ui64);
+                default: return mNative.d;
+            }
+        }
+        void FormatNative() const;
+
         const char* mValue;
         enum DataTypes mType;
+        Storage mStorage;
+        union
+        {
+            int64 i64;
+            uint64 ui64;
+            double d;
+        } mNative;
+        mutable bool mTextFormatted;
+        mutable char mText[32];
 };
 #endif
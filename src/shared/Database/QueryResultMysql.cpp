@@ -22,6 +22,9 @@
 #include "DatabaseEnv.h"
 #include "Util/Errors.h"
 
+#include <cstring>
+#include <type_traits>
+
 QueryResultMysql::QueryResultMysql(MYSQL_RES* result, MYSQL_FIELD* fields, uint64 rowCount, uint32 fieldCount) :
     QueryResult(rowCount, fieldCount), mResult(result)
 {
@@ -67,7 +70,7 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -97,5 +100,228 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+// is_null and error flags are my_bool in older client libraries and bool in recent ones
+typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type MysqlBindFlag;
+
+// initial size of the buffer receiving a text column, longer values are fetched again in a larger one
+static unsigned long const TEXT_BUFFER_SIZE = 256;
+
+QueryResultMysqlStmt::QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_FIELD* fields, uint32 fieldCount) :
+    QueryResult(0, fieldCount), mNextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    struct ColumnBuffer
+    {
+        union
+        {
+            int64 i64;
+            uint64 ui64;
+            float f;
+            double d;
+        } number;
+        std::vector<char> text;
+        unsigned long length;
+        MysqlBindFlag isNull;
+        MysqlBindFlag error;
+    };
+
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<ColumnBuffer> buffers(mFieldCount);
+    memset(binds.data(), 0, sizeof(MYSQL_BIND) * mFieldCount);
+
+    mColumns.resize(mFieldCount);
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+        mColumns[i] = GetColumnKind(fields[i]);
+
+        MYSQL_BIND& bind = binds[i];
+        ColumnBuffer& buffer = buffers[i];
+        switch (mColumns[i])
+        {
+            case COLUMN_SIGNED:
+            case COLUMN_UNSIGNED:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = mColumns[i] == COLUMN_UNSIGNED;
+                bind.buffer = &buffer.number.i64;
+                break;
+            case COLUMN_FLOAT:
+                bind.buffer_type = MYSQL_TYPE_FLOAT;
+                bind.buffer = &buffer.number.f;
+                break;
+            case COLUMN_DOUBLE:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &buffer.number.d;
+                break;
+            case COLUMN_TEXT:
+                buffer.text.resize(TEXT_BUFFER_SIZE);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = buffer.text.data();
+                bind.buffer_length = TEXT_BUFFER_SIZE;
+                break;
+        }
+        bind.length = &buffer.length;
+        bind.is_null = &buffer.isNull;
+        bind.error = &buffer.error;
+    }
+
+    if (mysql_stmt_bind_result(stmt, binds.data()))
+    {
+        sLog.outErrorDb("SQL ERROR: mysql_stmt_bind_result() failed: %s", mysql_stmt_error(stmt));
+        return;
+    }
+
+    while (true)
+    {
+        int status = mysql_stmt_fetch(stmt);
+        if (status == MYSQL_NO_DATA)
+            break;
+        if (status == 1)
+        {
+            sLog.outErrorDb("SQL ERROR: mysql_stmt_fetch() failed: %s", mysql_stmt_error(stmt));
+            break;
+        }
+
+        bool rebind = false;
+        for (uint32 i = 0; i < mFieldCount; ++i)
+        {
+            ColumnBuffer& buffer = buffers[i];
+            mNulls.push_back(buffer.isNull);
+            if (buffer.isNull)
+            {
+                mValues.push_back(0);
+                continue;
+            }
+
+            switch (mColumns[i])
+            {
+                case COLUMN_SIGNED:
+                case COLUMN_UNSIGNED:
+                    mValues.push_back(buffer.number.ui64);
+                    break;
+                case COLUMN_FLOAT:
+                {
+                    double value = buffer.number.f;
+                    uint64 bits;
+                    memcpy(&bits, &value, sizeof(bits));
+                    mValues.push_back(bits);
+                    break;
+                }
+                case COLUMN_DOUBLE:
+                {
+                    uint64 bits;
+                    memcpy(&bits, &buffer.number.d, sizeof(bits));
+                    mValues.push_back(bits);
+                    break;
+                }
+                case COLUMN_TEXT:
+                {
+                    MYSQL_BIND& bind = binds[i];
+                    if (buffer.length > bind.buffer_length)
+                    {
+                        // truncated, grow the buffer for this and the next rows and fetch the value again
+                        buffer.text.resize(buffer.length);
+                        bind.buffer = buffer.text.data();
+                        bind.buffer_length = buffer.length;
+                        mysql_stmt_fetch_column(stmt, &bind, i, 0);
+                        rebind = true;
+                    }
+
+                    mValues.push_back(mText.size());
+                    mText.insert(mText.end(), buffer.text.data(), buffer.text.data() + buffer.length);
+                    mText.push_back('\0');
+                    break;
+                }
+            }
+        }
+
+        if (rebind)
+            mysql_stmt_bind_result(stmt, binds.data());
+
+        ++mRowCount;
+    }
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (mNextRow >= mRowCount)
+    {
+        EndQuery();
+        return false;
+    }
+
+    size_t first = size_t(mNextRow) * mFieldCount;
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        if (mNulls[first + i])
+        {
+            mCurrentRow[i].SetValue(nullptr);
+            continue;
+        }
+
+        uint64 value = mValues[first + i];
+        switch (mColumns[i])
+        {
+            case COLUMN_SIGNED:
+                mCurrentRow[i].SetInt64(int64(value));
+                break;
+            case COLUMN_UNSIGNED:
+                mCurrentRow[i].SetUInt64(value);
+                break;
+            case COLUMN_FLOAT:
+            case COLUMN_DOUBLE:
+            {
+                double number;
+                memcpy(&number, &value, sizeof(number));
+                mCurrentRow[i].SetDouble(number);
+                break;
+            }
+            case COLUMN_TEXT:
+                mCurrentRow[i].SetValue(&mText[value]);
+                break;
+        }
+    }
+    ++mNextRow;
+
+    return true;
+}
+
+void QueryResultMysqlStmt::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+
+    std::vector<uint64>().swap(mValues);
+    std::vector<bool>().swap(mNulls);
+    std::vector<char>().swap(mText);
+}
+
+QueryResultMysqlStmt::ColumnKind QueryResultMysqlStmt::GetColumnKind(MYSQL_FIELD const& field)
+{
+    switch (field.type)
+    {
+        case MYSQL_TYPE_TINY:
+        case MYSQL_TYPE_SHORT:
+        case MYSQL_TYPE_LONG:
+        case MYSQL_TYPE_INT24:
+        case MYSQL_TYPE_LONGLONG:
+            return (field.flags & UNSIGNED_FLAG) ? COLUMN_UNSIGNED : COLUMN_SIGNED;
+        case MYSQL_TYPE_FLOAT:
+            return COLUMN_FLOAT;
+        case MYSQL_TYPE_DOUBLE:
+            return COLUMN_DOUBLE;
+        default:
+            // strings, blobs, decimals, enums and dates, the same text as sent by the text protocol
+            return COLUMN_TEXT;
+    }
+}
 #endif
 #endif
@@ -30,6 +30,8 @@
 
 #include <mysql.h>
 
+#include <vector>
+
 class QueryResultMysql : public QueryResult
 {
     public:
@@ -39,12 +41,45 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
         MYSQL_RES* mResult;
 };
+
+// Result of a statement executed with the binary protocol. All rows are read when it is built, numbers
+// as native values and other columns as text, so the statement can be closed right away and fields do
+// not parse their value again on each access.
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_FIELD* fields, uint32 fieldCount);
+
+        ~QueryResultMysqlStmt();
+
+        bool NextRow() override;
+
+    private:
+        enum ColumnKind
+        {
+            COLUMN_SIGNED,
+            COLUMN_UNSIGNED,
+            COLUMN_FLOAT,
+            COLUMN_DOUBLE,
+            COLUMN_TEXT
+        };
+
+        static ColumnKind GetColumnKind(MYSQL_FIELD const& field);
+        void EndQuery();
+
+        std::vector<ColumnKind> mColumns;
+        std::vector<uint64> mValues;                        // per row and column, the value bits or the offset of the text
+        std::vector<bool> mNulls;
+        std::vector<char> mText;                            // null terminated texts of all rows
+        uint64 mNextRow;
+};
 #endif
 #endif
 #endif
@@ -66,10 +66,24 @@ bool QueryResultSqlite::NextRow()
 
     for (int i = 0; i < mFieldCount; ++i)
     {
-        const unsigned char* value = sqlite3_column_text(*mStmt, i);
-
-        mCurrentRow[i].SetValue(value ? reinterpret_cast<const char*>(value) : nullptr);
-        mCurrentRow[i].SetType(ConvertNativeType(sqlite3_column_type(*mStmt, i)));
+        // numbers are read as stored, converting them to text would have them parsed again by the fields
+        int type = sqlite3_column_type(*mStmt, i);
+        switch (type)
+        {
+            case SQLITE_INTEGER:
+                mCurrentRow[i].SetInt64(sqlite3_column_int64(*mStmt, i));
+                break;
+            case SQLITE_FLOAT:
+                mCurrentRow[i].SetDouble(sqlite3_column_double(*mStmt, i));
+                break;
+            default:
+            {
+                const unsigned char* value = sqlite3_column_text(*mStmt, i);
+                mCurrentRow[i].SetValue(value ? reinterpret_cast<const char*>(value) : nullptr);
+                break;
+            }
+        }
+        mCurrentRow[i].SetType(ConvertNativeType(type));
     }
 
     return true;
@@ -20,8 +20,22 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+#include <algorithm>
+
+#ifdef BUILD_METRICS
+ #include "Metric/Instrument.h"
+#endif
+
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, std::string const& name) :
+    m_dbEngine(db), m_dbConnection(conn), m_running(true)
 {
+#ifdef BUILD_METRICS
+    std::map<std::string, std::string> tags = { { "database", name } };
+    m_queueSizeMetric = std::make_unique<metric::gauge>("db.async.queue_size", tags);
+    m_queueLatencyMetric = std::make_unique<metric::histogram>("db.async.latency", tags);
+#else
+    (void)name;
+#endif
 }
 
 SqlDelayThread::~SqlDelayThread()
@@ -38,22 +52,25 @@ void SqlDelayThread::run()
 #endif
 #endif
 
-    const uint32 loopSleepms = 10;
-
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
+    // without a ping interval the connections are pinged as often as the former 10ms polling loop did
+    const std::chrono::milliseconds pingInterval(std::max(m_dbEngine->GetPingIntervall(), 10u));
+    auto nextPing = std::chrono::steady_clock::now() + pingInterval;
 
-    uint32 loopCounter = 0;
     while (m_running)
     {
-        // if the running state gets turned off while sleeping
-        // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+            while (m_sqlQueue.empty() && m_running && std::chrono::steady_clock::now() < nextPing)
+                m_queueCondition.wait_until(lock, nextPing);
+        }
 
+        // if the running state gets turned off while waiting
+        // empty the queue before exiting
         ProcessRequests();
 
-        if ((loopCounter++) >= pingEveryLoop)
+        if (std::chrono::steady_clock::now() >= nextPing)
         {
-            loopCounter = 0;
+            nextPing = std::chrono::steady_clock::now() + pingInterval;
             m_dbEngine->Ping();
         }
     }
@@ -67,24 +84,33 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
+    {
+        std::lock_guard<std::mutex> guard(m_queueMutex);
+        m_running = false;
+    }
+    m_queueCondition.notify_all();
 }
 
 void SqlDelayThread::ProcessRequests()
 {
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
-
     // we need to move the contents of the queue to a local copy because executing these statements with the
     // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
     {
         std::lock_guard<std::mutex> guard(m_queueMutex);
-        sqlQueue = std::move(m_sqlQueue);
+        std::swap(m_processedQueue, m_sqlQueue);
     }
 
-    while (!sqlQueue.empty())
+#ifdef BUILD_METRICS
+    m_queueSizeMetric->set(double(m_processedQueue.size()));
+#endif
+
+    for (QueuedOperation& queued : m_processedQueue)
     {
-        auto const s = std::move(sqlQueue.front());
-        sqlQueue.pop();
-        s->Execute(m_dbConnection);
+#ifdef BUILD_METRICS
+        m_queueLatencyMetric->observe(double(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued.queueTime).count()));
+#endif
+        queued.operation->Execute(m_dbConnection);
     }
+
+    m_processedQueue.clear();
 }
@@ -23,35 +23,60 @@
 #include "SqlOperations.h"
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <string>
+#include <vector>
 
 class Database;
 class SqlOperation;
 class SqlConnection;
 
+namespace metric
+{
+    class gauge;
+    class histogram;
+}
+
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
+        struct QueuedOperation
+        {
+            std::unique_ptr<SqlOperation> operation;
+            std::chrono::steady_clock::time_point queueTime;
+        };
+
         std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
+        std::condition_variable m_queueCondition;               ///< Signaled when statements are queued or the thread stops
+        std::vector<QueuedOperation> m_sqlQueue;                ///< Queue of SQL statements
+        std::vector<QueuedOperation> m_processedQueue;          ///< Statements being executed, only used by the executing thread
         Database* m_dbEngine;                                   ///< Pointer to used Database engine
         SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
         std::atomic<bool> m_running;
 
+#ifdef BUILD_METRICS
+        std::unique_ptr<metric::gauge> m_queueSizeMetric;
+        std::unique_ptr<metric::histogram> m_queueLatencyMetric;
+#endif
+
         // process all enqueued requests
         void ProcessRequests();
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
+        SqlDelayThread(Database* db, SqlConnection* conn, std::string const& name = "");
         ~SqlDelayThread();
 
         ///< Put sql statement to delay queue
         bool Delay(SqlOperation* sql)
         {
-            std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
+            {
+                std::lock_guard<std::mutex> guard(m_queueMutex);
+                m_sqlQueue.push_back({ std::unique_ptr<SqlOperation>(sql), std::chrono::steady_clock::now() });
+            }
+            m_queueCondition.notify_one();
             return true;
         }
 
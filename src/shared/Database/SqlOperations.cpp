@@ -60,11 +60,20 @@ bool SqlTransaction::Execute(SqlConnection* conn)
         if (!pStmt->Execute(conn))
         {
             conn->RollbackTransaction();
+            if (m_failure)
+                *m_failure = true;
             return false;
         }
     }
 
-    return conn->CommitTransaction();
+    if (!conn->CommitTransaction())
+    {
+        if (m_failure)
+            *m_failure = true;
+        return false;
+    }
+
+    return true;
 }
 
 SqlPreparedRequest::SqlPreparedRequest(int nIndex, SqlStmtParameters* arg) : m_nIndex(nIndex), m_param(arg)
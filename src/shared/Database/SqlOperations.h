@@ -22,6 +22,7 @@
 #include "Common.h"
 #include "Utilities/Callback.h"
 
+#include <atomic>
 #include <queue>
 #include <vector>
 #include <mutex>
@@ -54,16 +55,21 @@ class SqlPlainRequest : public SqlOperation
         bool Execute(SqlConnection* conn) override;
 };
 
+// raised by the thread executing a transaction when it could not be committed, so its owner learns of it later
+typedef std::shared_ptr<std::atomic<bool>> SqlTransactionFailure;
+
 class SqlTransaction : public SqlOperation
 {
     private:
         std::vector<SqlOperation* > m_queue;
+        SqlTransactionFailure m_failure;
 
     public:
         SqlTransaction() {}
         ~SqlTransaction();
 
         void DelayExecute(SqlOperation* sql) { m_queue.push_back(sql); }
+        void SetFailure(SqlTransactionFailure const& failure) { m_failure = failure; }
 
         bool Execute(SqlConnection* conn) override;
 };
@@ -21,6 +21,7 @@
 
 #include "Common.h"
 
+#include <cstring>
 #include <vector>
 #include <stdexcept>
 
@@ -93,6 +94,15 @@ class SqlStmtFieldData
         // get underlying buffer type
         void* buff() const { return m_type == FIELD_STRING ? (void*)m_szStringData.c_str() : (void*)&m_binaryData; }
 
+        bool operator==(const SqlStmtFieldData& other) const
+        {
+            if (m_type != other.m_type)
+                return false;
+
+            return m_type == FIELD_STRING ? m_szStringData == other.m_szStringData : memcmp(&m_binaryData, &other.m_binaryData, size()) == 0;
+        }
+        bool operator!=(const SqlStmtFieldData& other) const { return !(*this == other); }
+
         // get size of data
         size_t size() const
         {
@@ -145,7 +155,7 @@ class SqlStmtParameters
         typedef std::vector<SqlStmtFieldData> ParameterContainer;
 
         // reserve memory to contain all input parameters of stmt
-        explicit SqlStmtParameters(uint32 nParams);
+        explicit SqlStmtParameters(uint32 nParams = 0);
 
         // get amount of bound parameters
         uint32 boundParams() const { return m_params.size(); }
@@ -159,11 +169,41 @@ class SqlStmtParameters
         // get bound parameters
         const ParameterContainer& params() const { return m_params; }
 
+        bool operator==(const SqlStmtParameters& other) const { return m_params == other.m_params; }
+        bool operator!=(const SqlStmtParameters& other) const { return m_params != other.m_params; }
+
     private:
         // statement parameter holder
         ParameterContainer m_params;
 };
 
+// Values bound by the last save of a row or a set of rows. A save binding the same values again has nothing
+// to write, so it can skip its statements. The values are taken when the save is queued, the owner must Reset
+// them when that save's transaction fails to commit, and bind rows of unordered containers in a fixed order.
+class SqlSavedValues
+{
+    public:
+        SqlSavedValues() : m_saved(false) {}
+
+        bool IsSaved() const { return m_saved; }
+        // true when values differ from the saved ones, which they then replace
+        bool Update(const SqlStmtParameters& values)
+        {
+            if (m_saved && m_values == values)
+                return false;
+
+            m_values = values;
+            m_saved = true;
+            return true;
+        }
+        // the next save writes its values, whatever they are
+        void Reset() { m_saved = false; }
+
+    private:
+        SqlStmtParameters m_values;
+        bool m_saved;
+};
+
 // statement ID encapsulation logic
 class SqlStatementID
 {
@@ -253,6 +293,13 @@ class SqlStatement
         void addString(const char* var) { arg(var); }
         void addString(const std::string& var) { arg(var.c_str()); }
         void addString(std::ostringstream& ss) { arg(ss.str().c_str()); ss.str(std::string()); }
+        // bind all parameters of a set, in order
+        void addParams(const SqlStmtParameters& params)
+        {
+            SqlStmtParameters* p = get();
+            for (const auto& param : params.params())
+                p->addParam(param);
+        }
 
     protected:
         // don't allow anyone except Database class to create static SqlStatement objects
@@ -287,6 +287,12 @@ void Log::Initialize()
 
     // Char log settings
     m_charLog_Dump = sConfig.GetBoolDefault("CharLogDump", false);
+
+    // Log writer settings, files are written by the logging threads when the queue size is set to 0
+    if (uint32 queueSize = sConfig.GetIntDefault("LogAsyncQueueSize", 10000))
+        m_writer.Start(queueSize, sConfig.GetIntDefault("LogAsyncOverflow", 0) ? LOG_OVERFLOW_DROP : LOG_OVERFLOW_BLOCK);
+    else
+        m_writer.Stop();
 }
 
 FILE* Log::openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode)
@@ -360,20 +366,59 @@ std::string Log::GetTimestampStr()
     return std::string(buf);
 }
 
-void Log::outString()
+void Log::WriteLine(FILE* file, char const* prefix, char const* format, va_list ap)
 {
+    std::string text = prefix;
+    size_t const start = text.size();
+
+    char buf[512];
+    va_list copy;
+    va_copy(copy, ap);
+    int len = vsnprintf(buf, sizeof(buf), format, copy);
+    va_end(copy);
+    if (len < 0)
+        return;
+
+    if (size_t(len) < sizeof(buf))
+        text.append(buf, len);
+    else
+    {
+        text.resize(start + len + 1);
+        vsnprintf(&text[start], len + 1, format, ap);
+        text.resize(start + len);
+    }
+
+    text += '\n';
+    WriteText(file, std::move(text));
+}
+
+void Log::WriteText(FILE* file, std::string&& text, bool timestamp)
+{
+    if (m_writer.IsRunning())
+    {
+        m_writer.Write(file, std::move(text), timestamp);
+        return;
+    }
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
-    printf("\n");
-    if (logfile)
+    if (timestamp)
+        outTimestamp(file);
+    fwrite(text.data(), 1, text.size(), file);
+    fflush(file);
+}
+
+void Log::outString()
+{
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "\n");
-        fflush(logfile);
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+        if (m_includeTime)
+            outTime();
+        printf("\n");
+        fflush(stdout);
     }
 
-    fflush(stdout);
+    if (logfile)
+        WriteText(logfile, "\n");
 }
 
 void Log::outString(const char* str, ...)
@@ -381,38 +426,34 @@ void Log::outString(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
 
-    if (m_colored)
-        SetColor(true, m_colors[LogNormal]);
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_includeTime)
-        outTime();
+        if (m_colored)
+            SetColor(true, m_colors[LogNormal]);
 
-    va_list ap;
+        if (m_includeTime)
+            outTime();
 
-    va_start(ap, str);
-    vutf8printf(stdout, str, &ap);
-    va_end(ap);
+        va_start(ap, str);
+        vutf8printf(stdout, str, &ap);
+        va_end(ap);
 
-    if (m_colored)
-        ResetColor(true);
+        if (m_colored)
+            ResetColor(true);
 
-    printf("\n");
+        printf("\n");
+        fflush(stdout);
+    }
 
     if (logfile)
     {
-        outTimestamp(logfile);
-
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        WriteLine(logfile, "", str, ap);
         va_end(ap);
-
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outError(const char* err, ...)
@@ -420,64 +461,53 @@ void Log::outError(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_includeTime)
-        outTime();
+        if (m_colored)
+            SetColor(false, m_colors[LogError]);
 
-    va_list ap;
+        if (m_includeTime)
+            outTime();
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+        va_start(ap, err);
+        vutf8printf(stderr, err, &ap);
+        va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
+        if (m_colored)
+            ResetColor(false);
+
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
 
-    fprintf(stderr, "\n");
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteLine(logfile, "ERROR:", err, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
-
-    fflush(stderr);
 }
 
 void Log::outErrorDb()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_includeTime)
-        outTime();
+        if (m_includeTime)
+            outTime();
 
-    fprintf(stderr, "\n");
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:\n");
-        fflush(logfile);
-    }
+        WriteText(logfile, "ERROR:\n");
 
     if (dberLogfile)
-    {
-        outTimestamp(dberLogfile);
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
-    }
-
-    fflush(stderr);
+        WriteText(dberLogfile, "\n");
 }
 
 void Log::outErrorDb(const char* err, ...)
@@ -485,78 +515,60 @@ void Log::outErrorDb(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
 
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_includeTime)
-        outTime();
+        if (m_colored)
+            SetColor(false, m_colors[LogError]);
 
-    va_list ap;
+        if (m_includeTime)
+            outTime();
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+        va_start(ap, err);
+        vutf8printf(stderr, err, &ap);
+        va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
+        if (m_colored)
+            ResetColor(false);
 
-    fprintf(stderr, "\n");
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR:");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteLine(logfile, "ERROR:", err, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (dberLogfile)
     {
-        outTimestamp(dberLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(dberLogfile, err, ap);
+        WriteLine(dberLogfile, "", err, ap);
         va_end(ap);
-
-        fprintf(dberLogfile, "\n");
-        fflush(dberLogfile);
     }
-
-    fflush(stderr);
 }
 
 void Log::outErrorEventAI()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_includeTime)
-        outTime();
+        if (m_includeTime)
+            outTime();
 
-    fprintf(stderr, "\n");
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
 
     if (logfile)
-    {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI\n");
-        fflush(logfile);
-    }
+        WriteText(logfile, "ERROR CreatureEventAI\n");
 
     if (eventAiErLogfile)
-    {
-        outTimestamp(eventAiErLogfile);
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
-    }
-
-    fflush(stderr);
+        WriteText(eventAiErLogfile, "\n");
 }
 
 void Log::outErrorEventAI(const char* err, ...)
@@ -564,51 +576,41 @@ void Log::outErrorEventAI(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    va_list ap;
+
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    if (m_includeTime)
-        outTime();
+        if (m_colored)
+            SetColor(false, m_colors[LogError]);
 
-    va_list ap;
+        if (m_includeTime)
+            outTime();
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+        va_start(ap, err);
+        vutf8printf(stderr, err, &ap);
+        va_end(ap);
 
-    if (m_colored)
-        ResetColor(false);
+        if (m_colored)
+            ResetColor(false);
 
-    fprintf(stderr, "\n");
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        fprintf(logfile, "ERROR CreatureEventAI: ");
-
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteLine(logfile, "ERROR CreatureEventAI: ", err, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (eventAiErLogfile)
     {
-        outTimestamp(eventAiErLogfile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(eventAiErLogfile, err, ap);
+        WriteLine(eventAiErLogfile, "", err, ap);
         va_end(ap);
-
-        fprintf(eventAiErLogfile, "\n");
-        fflush(eventAiErLogfile);
     }
-
-    fflush(stderr);
 }
 
 void Log::outBasic(const char* str, ...)
@@ -616,16 +618,18 @@ void Log::outBasic(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
+
     if (m_logLevel >= LOG_LVL_BASIC)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+
         if (m_colored)
             SetColor(true, m_colors[LogDetails]);
 
         if (m_includeTime)
             outTime();
 
-        va_list ap;
         va_start(ap, str);
         vutf8printf(stdout, str, &ap);
         va_end(ap);
@@ -634,20 +638,15 @@ void Log::outBasic(const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
     if (logfile && m_logFileLevel >= LOG_LVL_BASIC)
     {
-        va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        WriteLine(logfile, "", str, ap);
         va_end(ap);
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outDetail(const char* str, ...)
@@ -655,16 +654,18 @@ void Log::outDetail(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
+
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+
         if (m_colored)
             SetColor(true, m_colors[LogDetails]);
 
         if (m_includeTime)
             outTime();
 
-        va_list ap;
         va_start(ap, str);
         vutf8printf(stdout, str, &ap);
         va_end(ap);
@@ -673,22 +674,15 @@ void Log::outDetail(const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        outTimestamp(logfile);
-
-        va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        WriteLine(logfile, "", str, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outDebug(const char* str, ...)
@@ -696,16 +690,18 @@ void Log::outDebug(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
+
     if (m_logLevel >= LOG_LVL_DEBUG)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+
         if (m_colored)
             SetColor(true, m_colors[LogDebug]);
 
         if (m_includeTime)
             outTime();
 
-        va_list ap;
         va_start(ap, str);
         vutf8printf(stdout, str, &ap);
         va_end(ap);
@@ -714,22 +710,15 @@ void Log::outDebug(const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
     if (logfile && m_logFileLevel >= LOG_LVL_DEBUG)
     {
-        outTimestamp(logfile);
-
-        va_list ap;
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
+        WriteLine(logfile, "", str, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outCommand(uint32 account, const char* str, ...)
@@ -737,16 +726,18 @@ void Log::outCommand(uint32 account, const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    va_list ap;
+
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
+
         if (m_colored)
             SetColor(true, m_colors[LogDetails]);
 
         if (m_includeTime)
             outTime();
 
-        va_list ap;
         va_start(ap, str);
         vutf8printf(stdout, str, &ap);
         va_end(ap);
@@ -755,24 +746,22 @@ void Log::outCommand(uint32 account, const char* str, ...)
             ResetColor(true);
 
         printf("\n");
+        fflush(stdout);
     }
 
     if (logfile && m_logFileLevel >= LOG_LVL_DETAIL)
     {
-        va_list ap;
-        outTimestamp(logfile);
         va_start(ap, str);
-        vfprintf(logfile, str, ap);
-        fprintf(logfile, "\n");
+        WriteLine(logfile, "", str, ap);
         va_end(ap);
-        fflush(logfile);
     }
 
     if (m_gmlog_per_account)
     {
+        // a file of its own for every command, not worth the writer
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
         if (FILE* per_file = openGmlogPerAccount(account))
         {
-            va_list ap;
             outTimestamp(per_file);
             va_start(ap, str);
             vfprintf(per_file, str, ap);
@@ -783,16 +772,10 @@ void Log::outCommand(uint32 account, const char* str, ...)
     }
     else if (gmLogfile)
     {
-        va_list ap;
-        outTimestamp(gmLogfile);
         va_start(ap, str);
-        vfprintf(gmLogfile, str, ap);
-        fprintf(gmLogfile, "\n");
+        WriteLine(gmLogfile, "", str, ap);
         va_end(ap);
-        fflush(gmLogfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outChar(const char* str, ...)
@@ -800,45 +783,39 @@ void Log::outChar(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (charLogfile)
     {
         va_list ap;
-        outTimestamp(charLogfile);
         va_start(ap, str);
-        vfprintf(charLogfile, str, ap);
-        fprintf(charLogfile, "\n");
+        WriteLine(charLogfile, "", str, ap);
         va_end(ap);
-        fflush(charLogfile);
     }
 }
 
 void Log::outErrorScriptLib()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_includeTime)
-        outTime();
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    fprintf(stderr, "\n");
+        if (m_includeTime)
+            outTime();
+
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
+
+    std::lock_guard<std::mutex> guard(m_scriptErrLogMtx);
 
     if (logfile)
     {
-        outTimestamp(logfile);
         if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR:> ", m_scriptLibName);
+            WriteText(logfile, std::string("<") + m_scriptLibName + " ERROR:> ");
         else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
-        fflush(logfile);
+            WriteText(logfile, "<Scripting Library ERROR>: ");
     }
 
     if (scriptErrLogFile)
-    {
-        outTimestamp(scriptErrLogFile);
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
-    }
-
-    fflush(stderr);
+        WriteText(scriptErrLogFile, "\n");
 }
 
 void Log::outErrorScriptLib(const char* err, ...)
@@ -846,54 +823,45 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
-    if (m_colored)
-        SetColor(false, m_colors[LogError]);
+    va_list ap;
 
-    if (m_includeTime)
-        outTime();
+    {
+        std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
-    va_list ap;
+        if (m_colored)
+            SetColor(false, m_colors[LogError]);
 
-    va_start(ap, err);
-    vutf8printf(stderr, err, &ap);
-    va_end(ap);
+        if (m_includeTime)
+            outTime();
+
+        va_start(ap, err);
+        vutf8printf(stderr, err, &ap);
+        va_end(ap);
+
+        if (m_colored)
+            ResetColor(false);
 
-    if (m_colored)
-        ResetColor(false);
+        fprintf(stderr, "\n");
+        fflush(stderr);
+    }
 
-    fprintf(stderr, "\n");
+    std::lock_guard<std::mutex> guard(m_scriptErrLogMtx);
 
     if (logfile)
     {
-        outTimestamp(logfile);
-        if (m_scriptLibName)
-            fprintf(logfile, "<%s ERROR>: ", m_scriptLibName);
-        else
-            fprintf(logfile, "<Scripting Library ERROR>: ");
+        std::string prefix = m_scriptLibName ? std::string("<") + m_scriptLibName + " ERROR>: " : "<Scripting Library ERROR>: ";
 
         va_start(ap, err);
-        vfprintf(logfile, err, ap);
+        WriteLine(logfile, prefix.c_str(), err, ap);
         va_end(ap);
-
-        fprintf(logfile, "\n");
-        fflush(logfile);
     }
 
     if (scriptErrLogFile)
     {
-        outTimestamp(scriptErrLogFile);
-
-        va_list ap;
         va_start(ap, err);
-        vfprintf(scriptErrLogFile, err, ap);
+        WriteLine(scriptErrLogFile, "", err, ap);
         va_end(ap);
-
-        fprintf(scriptErrLogFile, "\n");
-        fflush(scriptErrLogFile);
     }
-
-    fflush(stderr);
 }
 
 void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opcodeName, ByteBuffer const& packet, bool incoming)
@@ -901,36 +869,46 @@ void Log::outWorldPacketDump(const char* socket, uint32 opcode, char const* opco
     if (!worldLogfile)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    char header[512];
+    snprintf(header, sizeof(header), "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
+             incoming ? "CLIENT" : "SERVER",
+             socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
 
-    outTimestamp(worldLogfile);
+    static char const digits[] = "0123456789ABCDEF";
 
-    fprintf(worldLogfile, "\n%s:\nSOCKET: %s\nLENGTH: %u\nOPCODE: %s (0x%.4X)\nDATA:\n",
-            incoming ? "CLIENT" : "SERVER",
-            socket, static_cast<uint32>(packet.size()), opcodeName, opcode);
+    std::string text = header;
+    text.reserve(text.size() + packet.size() * 3 + packet.size() / 16 + 3);
 
     size_t p = 0;
     while (p < packet.size())
     {
         for (size_t j = 0; j < 16 && p < packet.size(); ++j)
-            fprintf(worldLogfile, "%.2X ", packet[p++]);
+        {
+            uint8 byte = packet[p++];
+            text += digits[byte >> 4];
+            text += digits[byte & 0xF];
+            text += ' ';
+        }
 
-        fprintf(worldLogfile, "\n");
+        text += '\n';
     }
 
-    fprintf(worldLogfile, "\n\n");
-    fflush(worldLogfile);
+    text += "\n\n";
+    WriteText(worldLogfile, std::move(text));
 }
 
 void Log::outCharDump(const char* str, uint32 account_id, uint32 guid, const char* name)
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
+    if (!charLogfile)
+        return;
 
-    if (charLogfile)
-    {
-        fprintf(charLogfile, "== START DUMP == (account: %u guid: %u name: %s )\n%s\n== END DUMP ==\n", account_id, guid, name, str);
-        fflush(charLogfile);
-    }
+    char header[256];
+    snprintf(header, sizeof(header), "== START DUMP == (account: %u guid: %u name: %s )\n", account_id, guid, name);
+
+    std::string text = header;
+    text += str;
+    text += "\n== END DUMP ==\n";
+    WriteText(charLogfile, std::move(text), false);
 }
 
 void Log::outRALog(const char* str, ...)
@@ -938,19 +916,13 @@ void Log::outRALog(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (raLogfile)
     {
         va_list ap;
-        outTimestamp(raLogfile);
         va_start(ap, str);
-        vfprintf(raLogfile, str, ap);
-        fprintf(raLogfile, "\n");
+        WriteLine(raLogfile, "", str, ap);
         va_end(ap);
-        fflush(raLogfile);
     }
-
-    fflush(stdout);
 }
 
 void Log::outCustomLog(const char* str, ...)
@@ -958,19 +930,13 @@ void Log::outCustomLog(const char* str, ...)
     if (!str)
         return;
 
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (customLogFile)
     {
         va_list ap;
-        outTimestamp(customLogFile);
         va_start(ap, str);
-        vfprintf(customLogFile, str, ap);
-        fprintf(customLogFile, "\n");
+        WriteLine(customLogFile, "", str, ap);
         va_end(ap);
-        fflush(customLogFile);
     }
-
-    fflush(stdout);
 }
 
 void Log::WaitBeforeContinueIfNeed()
@@ -998,10 +964,17 @@ void Log::WaitBeforeContinueIfNeed()
 
 void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
 {
+    // no record may be queued for the file between the flush and the swap
+    std::lock_guard<std::mutex> guard(m_scriptErrLogMtx);
+
     m_scriptLibName = libName;
 
     if (scriptErrLogFile)
+    {
+        // records queued for the file are written before it is closed
+        m_writer.Flush();
         fclose(scriptErrLogFile);
+    }
 
     if (!fname)
     {
@@ -1110,14 +1083,8 @@ void script_error_log(const char* str, ...)
 
 void Log::traceLog()
 {
-    std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (customLogFile)
-    {
-        fprintf(customLogFile, "%s\n", GetTraceLog().data());
-        fflush(customLogFile);
-    }
-
-    fflush(stdout);
+        WriteText(customLogFile, GetTraceLog() + "\n", false);
 }
 
 // has to be in a locked enviroment on linux
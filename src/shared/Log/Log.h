@@ -21,7 +21,9 @@
 
 #include "Common.h"
 #include "Policies/Singleton.h"
+#include "Log/LogWriter.h"
 
+#include <cstdarg>
 #include <mutex>
 
 class Config;
@@ -100,6 +102,9 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
 
         ~Log()
         {
+            // records still queued refer to the files
+            m_writer.Stop();
+
             if (logfile != nullptr)
                 fclose(logfile);
             logfile = nullptr;
@@ -185,6 +190,7 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        std::string const& GetLogsDir() const { return m_logsDir; }
         std::string GetTraceLog();
 
         static void WaitBeforeContinueIfNeed();
@@ -198,6 +204,11 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
+        // writes prefix and the formatted line to file, see WriteText
+        void WriteLine(FILE* file, char const* prefix, char const* format, va_list ap);
+        // queues text for the log writer when it runs, otherwise writes it at once; not under m_worldLogMtx
+        void WriteText(FILE* file, std::string&& text, bool timestamp = true);
+
         FILE* raLogfile;
         FILE* logfile;
         FILE* gmLogfile;
@@ -208,8 +219,11 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         FILE* worldLogfile;
         FILE* customLogFile;
 
+        LogWriter m_writer;                                 // writes the files when LogAsyncQueueSize is set
+
         std::mutex m_worldLogMtx;
         std::mutex m_traceLogMtx;
+        std::mutex m_scriptErrLogMtx;                       // scriptErrLogFile and m_scriptLibName, swapped while scripts log
 
         // log/console control
         LogLevel m_logLevel;
@@ -0,0 +1,200 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Log/LogWriter.h"
+
+#include <algorithm>
+#include <vector>
+
+LogWriter::LogWriter() :
+    m_queueSize(0), m_policy(LOG_OVERFLOW_BLOCK), m_queued(0), m_enqueued(0), m_written(0), m_dropped(0),
+    m_sleeping(false), m_waiting(0), m_stop(false)
+{
+}
+
+void LogWriter::Start(uint32 queueSize, LogOverflowPolicy policy)
+{
+    Stop();
+
+    m_queueSize = std::max(queueSize, 1u);
+    m_policy = policy;
+    m_stop = false;
+    m_thread = std::thread(&LogWriter::Run, this);
+}
+
+void LogWriter::Stop()
+{
+    if (!m_thread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_one();
+    m_progress.notify_all();
+    m_thread.join();
+}
+
+template<class Done>
+void LogWriter::WaitForProgress(Done done)
+{
+    // counted before checking, so the writer either sees the waiter or the waiter sees the progress
+    ++m_waiting;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_progress.wait(lock, [&]() { return m_stop || done(); });
+    }
+    --m_waiting;
+}
+
+void LogWriter::Write(FILE* file, std::string&& text, bool timestamp)
+{
+    while (m_queued.fetch_add(1) >= m_queueSize)
+    {
+        --m_queued;
+
+        if (m_policy == LOG_OVERFLOW_DROP)
+        {
+            ++m_dropped;
+            return;
+        }
+
+        WaitForProgress([this]() { return m_queued.load() < m_queueSize; });
+    }
+
+    Record record;
+    record.file = file;
+    record.timestamp = timestamp;
+    if (timestamp)
+        record.time = time(nullptr);
+    record.text = std::move(text);
+
+    m_queue.Enqueue(std::move(record));
+    ++m_enqueued;
+
+    // the writer sets m_sleeping before it checks m_queued for the last time
+    if (m_sleeping.load())
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_wakeUp.notify_one();
+    }
+}
+
+void LogWriter::Flush()
+{
+    if (!IsRunning())
+        return;
+
+    uint64 const enqueued = m_enqueued.load();
+    WaitForProgress([this, enqueued]() { return m_written.load() >= enqueued; });
+}
+
+void LogWriter::ReportDropped()
+{
+    if (uint32 dropped = m_dropped.exchange(0))
+    {
+        fprintf(stderr, "%u log records dropped, the log queue was full\n", dropped);
+        fflush(stderr);
+    }
+}
+
+void LogWriter::Run()
+{
+    std::vector<Record> batch;
+    std::vector<FILE*> files;
+
+    // records of the same second share the formatted timestamp
+    time_t stampTime = 0;
+    char stamp[32] = "";
+    time_t droppedReport = 0;
+
+    for (;;)
+    {
+        Record record;
+        while (m_queue.Dequeue(record))
+            batch.push_back(std::move(record));
+
+        if (batch.empty())
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_sleeping = true;
+            m_wakeUp.wait(lock, [this]() { return m_stop || m_queued.load() != 0; });
+            m_sleeping = false;
+
+            if (!m_queued.load())
+            {
+                ReportDropped();
+                break;
+            }
+
+            // counted but not linked in yet, its producer is between both steps
+            lock.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+
+        m_queued -= uint32(batch.size());
+        if (m_waiting.load())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_progress.notify_all();
+        }
+
+        for (Record const& written : batch)
+        {
+            if (written.timestamp)
+            {
+                if (written.time != stampTime)
+                {
+                    stampTime = written.time;
+                    tm* aTm = localtime(&stampTime);
+                    snprintf(stamp, sizeof(stamp), "%-4d-%02d-%02d %02d:%02d:%02d ", aTm->tm_year + 1900, aTm->tm_mon + 1, aTm->tm_mday, aTm->tm_hour, aTm->tm_min, aTm->tm_sec);
+                }
+
+                fputs(stamp, written.file);
+            }
+
+            fwrite(written.text.data(), 1, written.text.size(), written.file);
+
+            if (std::find(files.begin(), files.end(), written.file) == files.end())
+                files.push_back(written.file);
+        }
+
+        for (FILE* file : files)
+            fflush(file);
+
+        m_written += batch.size();
+        batch.clear();
+        files.clear();
+
+        // at most once a second, the queue stays full as long as the load lasts
+        if (m_dropped.load() && time(nullptr) != droppedReport)
+        {
+            droppedReport = time(nullptr);
+            ReportDropped();
+        }
+
+        if (m_waiting.load())
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_progress.notify_all();
+        }
+    }
+}
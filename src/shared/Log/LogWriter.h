@@ -0,0 +1,95 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOSSERVER_LOG_WRITER_H
+#define MANGOSSERVER_LOG_WRITER_H
+
+#include "Platform/Define.h"
+#include "Util/MPSCQueue.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// what a thread writing to a full queue does
+enum LogOverflowPolicy
+{
+    LOG_OVERFLOW_BLOCK  = 0,                                // wait until the writer made room
+    LOG_OVERFLOW_DROP   = 1,                                // discard the record, the count of discarded ones is reported
+};
+
+// Writes already formatted records to their files from a thread of its own, so the threads logging only
+// queue them. The writer takes every record queued at once, writes them in order and flushes each file
+// they went to once per batch. Timestamps are taken when a record is queued but only formatted by the writer.
+// Files must stay open until the records queued for them are written, see Flush.
+class LogWriter
+{
+    public:
+        LogWriter();
+        LogWriter(LogWriter const&) = delete;
+        LogWriter& operator=(LogWriter const&) = delete;
+        ~LogWriter() { Stop(); }
+
+        // starts the writer thread, queueSize records at most wait for it; a running writer is stopped first
+        void Start(uint32 queueSize, LogOverflowPolicy policy);
+        // writes what is queued and stops the writer thread
+        void Stop();
+        bool IsRunning() const { return m_thread.joinable(); }
+
+        // queues text, a timestamp of the time of the call is written before it when timestamp is set
+        void Write(FILE* file, std::string&& text, bool timestamp);
+        // returns once everything queued before the call is written and flushed
+        void Flush();
+
+    private:
+        struct Record
+        {
+            FILE* file = nullptr;
+            time_t time = 0;
+            bool timestamp = false;
+            std::string text;
+        };
+
+        void Run();
+        void ReportDropped();
+        // waits until done holds or the writer is stopped
+        template<class Done> void WaitForProgress(Done done);
+
+        MPSCQueue<Record> m_queue;
+        uint32 m_queueSize;
+        LogOverflowPolicy m_policy;
+
+        std::atomic<uint32> m_queued;                       // records not taken by the writer yet
+        std::atomic<uint64> m_enqueued;                     // records queued since the start
+        std::atomic<uint64> m_written;                      // of those, the ones written and flushed
+        std::atomic<uint32> m_dropped;                      // not reported yet
+
+        std::thread m_thread;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeUp;                   // the writer waits for records
+        std::condition_variable m_progress;                 // producers wait for room, Flush for the writer
+        std::atomic<bool> m_sleeping;
+        std::atomic<uint32> m_waiting;                      // threads waiting on m_progress
+        bool m_stop;
+};
+
+#endif
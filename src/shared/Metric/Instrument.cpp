@@ -0,0 +1,202 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cmath>
+
+#include "Instrument.h"
+#include "Measurement.h"
+#include "Metric.h"
+
+metric::registry& metric::registry::instance()
+{
+    static registry instance;
+    return instance;
+}
+
+uint32 metric::registry::register_series(std::string const& name, std::map<std::string, std::string> const& tags, instrument_type type)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    auto itr = m_seriesIds.find({ name, tags });
+    if (itr != m_seriesIds.end())
+    {
+        ++m_series[itr->second].references;
+        return itr->second;
+    }
+
+    // series of maps and instances come and go, their ids are reused so the registry does not grow with them
+    uint32 id;
+    if (!m_freeSeries.empty())
+    {
+        id = m_freeSeries.back();
+        m_freeSeries.pop_back();
+        m_series[id] = { name, tags, type, 1 };
+    }
+    else
+    {
+        id = uint32(m_series.size());
+        m_series.push_back({ name, tags, type, 1 });
+    }
+
+    m_seriesIds.emplace(std::make_pair(name, tags), id);
+    return id;
+}
+
+void metric::registry::release_series(uint32 series)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    series_info& info = m_series[series];
+    if (--info.references)
+        return;
+
+    // samples of the series may still wait in the rings, the id is only reused after they are reported
+    m_seriesIds.erase({ info.name, info.tags });
+    m_retiredSeries.push_back(series);
+}
+
+metric::sample_ring& metric::registry::local_ring()
+{
+    // the ring outlives its thread, it is released by collect once abandoned and drained
+    struct ring_owner
+    {
+        sample_ring* ring = nullptr;
+        ~ring_owner() { if (ring) ring->abandon(); }
+    };
+    static thread_local ring_owner owner;
+
+    if (!owner.ring)
+    {
+        owner.ring = new sample_ring();
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_rings.emplace_back(owner.ring);
+    }
+
+    return *owner.ring;
+}
+
+void metric::registry::collect(std::vector<std::unique_ptr<Measurement>>& measurements)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    if (m_aggregates.size() < m_series.size())
+        m_aggregates.resize(m_series.size());
+
+    for (auto itr = m_rings.begin(); itr != m_rings.end();)
+    {
+        sample_ring& ring = **itr;
+        bool abandoned = ring.abandoned();                  // checked first, samples pushed before abandoning are drained below
+
+        ring.drain([this](sample const& value) { m_aggregates[value.series].add(value.type, value.value); });
+        m_dropped += ring.take_dropped();
+
+        if (abandoned)
+            itr = m_rings.erase(itr);
+        else
+            ++itr;
+    }
+
+    for (size_t i = 0; i < m_series.size(); ++i)
+    {
+        aggregate& data = m_aggregates[i];
+        if (!data.count)
+            continue;
+
+        series_info const& series = m_series[i];
+        std::map<std::string, boost::any> fields;
+        switch (series.type)
+        {
+            case instrument_type::counter:
+                fields["count"] = int64(data.sum);
+                break;
+            case instrument_type::gauge:
+                fields["value"] = float(data.last);
+                break;
+            case instrument_type::histogram:
+                fields["count"] = int64(data.count);
+                fields["mean"] = float(data.sum / data.count);
+                fields["max"] = float(data.max);
+                fields["p50"] = float(data.percentile(0.50));
+                fields["p90"] = float(data.percentile(0.90));
+                fields["p99"] = float(data.percentile(0.99));
+                break;
+        }
+
+        measurements.push_back(std::make_unique<Measurement>(series.name, series.tags, fields));
+        data.reset();
+    }
+
+    // all rings were drained above, nothing refers to the retired series anymore
+    for (uint32 series : m_retiredSeries)
+    {
+        m_series[series].name.clear();
+        m_series[series].tags.clear();
+        m_freeSeries.push_back(series);
+    }
+    m_retiredSeries.clear();
+
+    if (m_dropped)
+    {
+        measurements.push_back(std::make_unique<Measurement>("metric.dropped", std::map<std::string, std::string>(), std::map<std::string, boost::any>{ { "count", int64(m_dropped) } }));
+        m_dropped = 0;
+    }
+}
+
+void metric::registry::aggregate::add(instrument_type type, double value)
+{
+    ++count;
+    sum += value;
+    last = value;
+    max = std::max(max, value);
+
+    if (type == instrument_type::histogram)
+    {
+        // bucket n holds values in [2^(n-1), 2^n), bucket 0 everything below 1
+        size_t bucket = value >= 1.0 ? std::min(size_t(std::ilogb(value)) + 1, buckets - 1) : 0;
+        ++histogram[bucket];
+    }
+}
+
+double metric::registry::aggregate::percentile(double fraction) const
+{
+    uint64 rank = uint64(std::ceil(fraction * count));
+    uint64 seen = 0;
+    for (size_t bucket = 0; bucket < buckets; ++bucket)
+    {
+        seen += histogram[bucket];
+        if (seen >= rank)                                   // upper bound of the bucket, never above the real maximum
+            return bucket ? std::min(std::ldexp(1.0, int(bucket)), max) : std::min(1.0, max);
+    }
+    return max;
+}
+
+void metric::registry::aggregate::reset()
+{
+    count = 0;
+    sum = 0.0;
+    max = 0.0;
+    last = 0.0;
+    histogram.fill(0);
+}
+
+void metric::report_slow(std::string const& name, int64 duration, std::function<void(measurement&)> const& details)
+{
+    measurement slow(name, "duration", duration);
+    details(slow);
+}
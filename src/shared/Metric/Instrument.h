@@ -0,0 +1,251 @@
+/*
+* This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+*
+* This program is free software; you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation; either version 2 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program; if not, write to the Free Software
+* Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef MANGOSSERVER_INSTRUMENT_H
+#define MANGOSSERVER_INSTRUMENT_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Common.h"
+
+struct Measurement;
+
+// Typed instruments for hot paths. A sample is a fixed size record pushed into a ring owned by the
+// recording thread, the metric send thread drains all rings once per interval, aggregates the samples
+// per series and reports one measurement per series. Recording never locks nor allocates.
+namespace metric
+{
+    enum class instrument_type : uint8
+    {
+        counter,                                            // summed over the interval
+        gauge,                                              // last value of the interval
+        histogram                                           // count, mean, max and percentiles of the interval
+    };
+
+    struct sample
+    {
+        uint32 series;
+        instrument_type type;
+        double value;
+    };
+
+    // single producer (owning thread), single consumer (send thread)
+    class sample_ring
+    {
+        public:
+            static constexpr size_t capacity = 8192;        // must be a power of two
+
+            sample_ring() : m_head(0), m_tail(0), m_dropped(0), m_abandoned(false) {}
+
+            bool push(sample const& value)
+            {
+                size_t head = m_head.load(std::memory_order_relaxed);
+                if (head - m_tail.load(std::memory_order_acquire) >= capacity)
+                {
+                    m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                m_samples[head & (capacity - 1)] = value;
+                m_head.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            template <class Consumer>
+            void drain(Consumer&& consumer)
+            {
+                size_t tail = m_tail.load(std::memory_order_relaxed);
+                size_t head = m_head.load(std::memory_order_acquire);
+                for (; tail != head; ++tail)
+                    consumer(m_samples[tail & (capacity - 1)]);
+                m_tail.store(tail, std::memory_order_release);
+            }
+
+            uint64 take_dropped() { return m_dropped.exchange(0, std::memory_order_relaxed); }
+
+            void abandon() { m_abandoned = true; }
+            bool abandoned() const { return m_abandoned; }
+
+        private:
+            std::array<sample, capacity> m_samples;
+            alignas(64) std::atomic<size_t> m_head;
+            alignas(64) std::atomic<size_t> m_tail;
+            std::atomic<uint64> m_dropped;
+            std::atomic<bool> m_abandoned;
+    };
+
+    class registry
+    {
+        public:
+            static registry& instance();
+
+            // returns the id of the series, the same name and tags give the same id as long as an instrument uses it
+            uint32 register_series(std::string const& name, std::map<std::string, std::string> const& tags, instrument_type type);
+            // drops a reference taken by register_series, the last one retires the series once its samples are reported
+            void release_series(uint32 series);
+
+            void record(uint32 series, instrument_type type, double value)
+            {
+                if (m_enabled.load(std::memory_order_relaxed))
+                    local_ring().push({ series, type, value });
+            }
+
+            void set_enabled(bool enabled) { m_enabled = enabled; }
+            bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+            // drains all rings and appends one measurement per series recorded since the last call
+            void collect(std::vector<std::unique_ptr<Measurement>>& measurements);
+
+        private:
+            registry() : m_enabled(false), m_dropped(0) {}
+
+            struct series_info
+            {
+                std::string name;
+                std::map<std::string, std::string> tags;
+                instrument_type type;
+                uint32 references;                          // instruments using the series, none once it is retired
+            };
+
+            struct aggregate
+            {
+                static constexpr size_t buckets = 64;       // log2 buckets, for percentiles
+
+                aggregate() { reset(); }
+                void add(instrument_type type, double value);
+                double percentile(double fraction) const;
+                void reset();
+
+                uint64 count;
+                double sum;
+                double max;
+                double last;
+                std::array<uint32, buckets> histogram;
+            };
+
+            sample_ring& local_ring();
+
+            std::atomic<bool> m_enabled;
+
+            std::mutex m_lock;                              // guards series registration and the ring list
+            std::map<std::pair<std::string, std::map<std::string, std::string>>, uint32> m_seriesIds;
+            std::vector<series_info> m_series;
+            std::vector<uint32> m_retiredSeries;            // released, reported once more by the next collect
+            std::vector<uint32> m_freeSeries;               // ids to reuse, no sample refers to them anymore
+            std::vector<std::unique_ptr<sample_ring>> m_rings;
+
+            std::vector<aggregate> m_aggregates;            // only used by the collecting thread
+            uint64 m_dropped;
+    };
+
+    class instrument
+    {
+        public:
+            instrument(std::string const& name, std::map<std::string, std::string> const& tags, instrument_type type) :
+                m_series(registry::instance().register_series(name, tags, type)), m_type(type), m_name(name) {}
+            instrument(instrument const&) = delete;
+            instrument& operator=(instrument const&) = delete;
+            ~instrument() { registry::instance().release_series(m_series); }
+
+            std::string const& name() const { return m_name; }
+
+        protected:
+            void record(double value) const { registry::instance().record(m_series, m_type, value); }
+
+        private:
+            uint32 m_series;
+            instrument_type m_type;
+            std::string m_name;
+    };
+
+    class counter : public instrument
+    {
+        public:
+            counter(std::string const& name, std::map<std::string, std::string> const& tags = {}) : instrument(name, tags, instrument_type::counter) {}
+
+            void add(double value = 1) const { record(value); }
+    };
+
+    class gauge : public instrument
+    {
+        public:
+            gauge(std::string const& name, std::map<std::string, std::string> const& tags = {}) : instrument(name, tags, instrument_type::gauge) {}
+
+            void set(double value) const { record(value); }
+    };
+
+    class histogram : public instrument
+    {
+        public:
+            histogram(std::string const& name, std::map<std::string, std::string> const& tags = {}) : instrument(name, tags, instrument_type::histogram) {}
+
+            void observe(double value) const { record(value); }
+    };
+
+    class measurement;
+
+    // reports a single timing as measurement, details may add tags and fields to it
+    void report_slow(std::string const& name, int64 duration, std::function<void(measurement&)> const& details);
+
+    struct no_slow_report
+    {
+        void operator()(measurement& /*slow*/) const {}
+    };
+
+    // Records the lifetime of the scope into a histogram. When a threshold is given, a scope lasting at least
+    // that long is also reported on its own as a measurement named like the histogram and completed by slowReport,
+    // so rare spikes keep their details without paying for them on every call.
+    template <class precision, class SlowReport = no_slow_report>
+    class timer
+    {
+        public:
+            timer(histogram const& target, int64 threshold = 0, SlowReport slowReport = SlowReport()) :
+                m_target(target), m_threshold(threshold), m_slowReport(std::move(slowReport)), m_startTime(std::chrono::steady_clock::now()) {}
+
+            ~timer()
+            {
+                int64 elapsed = std::chrono::duration_cast<precision>(std::chrono::steady_clock::now() - m_startTime).count();
+                m_target.observe(double(elapsed));
+
+                if (m_threshold && elapsed >= m_threshold && registry::instance().enabled())
+                    report_slow(m_target.name(), elapsed, [this](measurement& slow) { m_slowReport(slow); });
+            }
+
+        private:
+            histogram const& m_target;
+            int64 m_threshold;
+            SlowReport m_slowReport;
+            std::chrono::steady_clock::time_point m_startTime;
+    };
+
+    template <class precision, class SlowReport>
+    timer<precision, SlowReport> make_timer(histogram const& target, int64 threshold, SlowReport slowReport)
+    {
+        return timer<precision, SlowReport>(target, threshold, std::move(slowReport));
+    }
+}
+
+#endif // MANGOSSERVER_INSTRUMENT_H
@@ -21,6 +21,7 @@
 
 #include "Config/Config.h"
 #include "Log/Log.h"
+#include "Instrument.h"
 #include "Metric.h"
 
 metric::measurement::measurement(std::string name, std::function<bool()> condition)
@@ -100,7 +101,9 @@ metric::metric::~metric()
 
 void metric::metric::initialize()
 {
-    if (!(m_enabled = sConfig.GetBoolDefault("Metric.Enable", false)))
+    m_enabled = sConfig.GetBoolDefault("Metric.Enable", false);
+    registry::instance().set_enabled(m_enabled);
+    if (!m_enabled)
         return;
 
     m_connectionInfo = {
@@ -204,6 +207,9 @@ void metric::metric::send()
         std::swap(measurements, m_measurementQueue);
     }
 
+    // typed instruments are aggregated once per send
+    registry::instance().collect(measurements);
+
     sLog.outDetail("Sending %zu measurements!", measurements.size());
 
     using boost::asio::ip::tcp;
@@ -36,6 +36,8 @@ namespace MaNGOS
             virtual ~AsyncSocket();
 
             void Read(char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
+            // completes as soon as any data is available, reading up to length bytes
+            void ReadSome(char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
             void ReadUntil(std::string& buffer, char delimiter, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
             void ReadSkip(size_t skipSize, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
             void Write(const char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback);
@@ -92,6 +94,12 @@ namespace MaNGOS
         boost::asio::async_read(m_socket, boost::asio::buffer(buffer, length), callback);
     }
 
+    template <typename SocketType>
+    void MaNGOS::AsyncSocket<SocketType>::ReadSome(char* buffer, size_t length, std::function<void(const boost::system::error_code&, std::size_t)>&& callback)
+    {
+        m_socket.async_read_some(boost::asio::buffer(buffer, length), callback);
+    }
+
     template <typename SocketType>
     void MaNGOS::AsyncSocket<SocketType>::ReadUntil(std::string& buffer, char delimiter, std::function<void(const boost::system::error_code&, std::size_t)>&& callback)
     {
@@ -364,6 +364,7 @@ class ByteBuffer
 
         size_t size() const { return _storage.size(); }
         bool empty() const { return _storage.empty(); }
+        size_t capacity() const { return _storage.capacity(); }
 
         void resize(size_t newsize)
         {
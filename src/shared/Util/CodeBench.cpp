@@ -19,9 +19,181 @@
 #include "Util/CodeBench.h"
 #include "Log/Log.h"
 
+#include <map>
+
 ChronoTimeTracker::~ChronoTimeTracker()
 {
     std::chrono::nanoseconds elapsed = elapsedNanos();
     sLog.outError("%s: time elapsed: %ldns, %ldµs, %ldms, %lds",
         m_name.c_str(), nanos(elapsed).count(), micros(elapsed).count(), millis(elapsed).count(), secs(elapsed).count());
 }
+
+std::atomic<bool> Profiler::m_enabled(false);
+
+static uint64 ProfilerNow()
+{
+    return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+void ProfilerBuffer::Push(ProfilerZone const* zone)
+{
+    uint64 written = m_written.load(std::memory_order_relaxed);
+    m_events[written & (capacity - 1)] = { zone, ProfilerNow() };
+    m_written.store(written + 1, std::memory_order_release);
+}
+
+std::vector<ProfilerEvent> ProfilerBuffer::Copy() const
+{
+    uint64 written = m_written.load(std::memory_order_acquire);
+    uint64 first = written > capacity ? written - capacity : 0;
+
+    std::vector<ProfilerEvent> events;
+    events.reserve(size_t(written - first));
+    for (uint64 i = first; i < written; ++i)
+        events.push_back(m_events[i & (capacity - 1)]);
+    return events;
+}
+
+Profiler& Profiler::Instance()
+{
+    static Profiler instance;
+    return instance;
+}
+
+void Profiler::Enable(uint32 spikeThreshold)
+{
+    m_requestedSpikeThreshold = spikeThreshold;
+    m_requestedEnabled = true;
+}
+
+void Profiler::Disable()
+{
+    m_requestedEnabled = false;
+    m_requestedSpikeThreshold = 0;
+}
+
+void Profiler::OnWorldTickStart()
+{
+    m_spikeThreshold = m_requestedSpikeThreshold.load();
+    m_enabled = m_requestedEnabled.load();
+}
+
+ProfilerBuffer& Profiler::LocalBuffer()
+{
+    static thread_local ProfilerBuffer* buffer = nullptr;
+    if (!buffer)
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+        m_buffers.push_back(std::make_unique<ProfilerBuffer>(uint32(m_buffers.size())));
+        buffer = m_buffers.back().get();
+    }
+    return *buffer;
+}
+
+std::vector<Profiler::ThreadEvents> Profiler::Snapshot()
+{
+    // not paused while copying, a pause would drop the ends of open zones; the map threads do not record now
+    // and the rings of the calling thread only grow after the copy
+    std::vector<ThreadEvents> threads;
+    std::lock_guard<std::mutex> guard(m_lock);
+    for (auto const& buffer : m_buffers)
+        threads.push_back({ buffer->GetThreadIndex(), buffer->Copy() });
+
+    return threads;
+}
+
+std::string Profiler::Dump(ProfilerDumpFormat format)
+{
+    std::vector<ThreadEvents> threads = Snapshot();
+    uint64 now = ProfilerNow();
+
+    std::string fileName = sLog.GetLogsDir() + "profile_" + Log::GetTimestampStr() + (format == PROFILER_DUMP_TRACE ? ".json" : ".folded");
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (!file)
+        return "";
+
+    uint64 origin = now;
+    for (auto const& thread : threads)
+        if (!thread.events.empty())
+            origin = std::min(origin, thread.events.front().time);
+
+    struct Frame
+    {
+        ProfilerZone const* zone;
+        uint64 begin;
+        uint64 childTime;
+        std::string path;
+    };
+
+    std::map<std::string, uint64> selfTimes;                // collapsed stack -> nanoseconds
+    bool firstTraceEvent = true;
+
+    if (format == PROFILER_DUMP_TRACE)
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    for (auto const& thread : threads)
+    {
+        std::vector<Frame> stack;
+        std::string root = "thread " + std::to_string(thread.threadIndex);
+
+        auto close = [&](uint64 end)
+        {
+            Frame const& frame = stack.back();
+            uint64 duration = end - frame.begin;
+
+            if (format == PROFILER_DUMP_TRACE)
+            {
+                fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                        firstTraceEvent ? "" : ",", frame.zone->name, thread.threadIndex, (frame.begin - origin) / 1000.0, duration / 1000.0);
+                firstTraceEvent = false;
+            }
+            else
+                selfTimes[frame.path] += duration - std::min(duration, frame.childTime);
+
+            stack.pop_back();
+            if (!stack.empty())
+                stack.back().childTime += duration;
+        };
+
+        for (ProfilerEvent const& event : thread.events)
+        {
+            if (event.zone)
+                stack.push_back({ event.zone, event.time, 0, (stack.empty() ? root : stack.back().path) + ";" + event.zone->name });
+            else if (!stack.empty())                        // end of a zone which began before the oldest kept event otherwise
+                close(event.time);
+        }
+
+        // zones still running at the time of the dump
+        while (!stack.empty())
+            close(now);
+    }
+
+    if (format == PROFILER_DUMP_TRACE)
+        fprintf(file, "\n]}\n");
+    else
+    {
+        for (auto const& selfTime : selfTimes)
+            if (selfTime.second >= 1000)
+                fprintf(file, "%s " UI64FMTD "\n", selfTime.first.c_str(), selfTime.second / 1000);
+    }
+
+    fclose(file);
+    return fileName;
+}
+
+void Profiler::OnWorldTick(uint32 tickTime)
+{
+    uint32 threshold = m_spikeThreshold;
+    if (!threshold || tickTime < threshold || !IsEnabled())
+        return;
+
+    // a burst of slow ticks is caught by the first dump already
+    time_t now = time(nullptr);
+    if (now < m_lastSpikeDump + 60)
+        return;
+
+    m_lastSpikeDump = now;
+    std::string fileName = Dump(PROFILER_DUMP_TRACE);
+    if (!fileName.empty())
+        sLog.outString("Profiler: world tick took %u ms, trace written to %s", tickTime, fileName.c_str());
+}
@@ -19,6 +19,15 @@
 #ifndef MANGOS_CODEBENCH_H
 #define MANGOS_CODEBENCH_H
 
+#include "Common.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
 struct ChronoTimeTracker
 {
     public:
@@ -50,5 +59,121 @@ struct ChronoTimeTracker
         inline constexpr std::chrono::seconds secs(std::chrono::nanoseconds nanos) { return std::chrono::duration_cast<std::chrono::seconds>(nanos); }
 };
 
+// Hierarchical profiler: every thread records the begin and end of the PROFILE_ZONE scopes it runs into its own
+// ring, so a dump shows the last ProfilerBuffer::capacity events of each thread as nested zones. Disabled zones
+// cost a single relaxed load. Recording only starts and stops at the start of a world tick, when no zone is open on
+// any thread, so every recorded begin has its end.
+struct ProfilerZone
+{
+    char const* name;
+};
+
+struct ProfilerEvent
+{
+    ProfilerZone const* zone;                               // nullptr closes the innermost open zone
+    uint64 time;                                            // steady clock, nanoseconds
+};
+
+enum ProfilerDumpFormat
+{
+    PROFILER_DUMP_TRACE,                                    // Chrome trace event json, for chrome://tracing or Perfetto
+    PROFILER_DUMP_STACKS                                    // collapsed stacks with self time in microseconds, for flamegraph.pl
+};
+
+// single producer ring, read by Profiler::Snapshot from the world thread while the map threads are idle
+class ProfilerBuffer
+{
+    public:
+        static constexpr size_t capacity = 1 << 16;         // must be a power of two
+
+        ProfilerBuffer(uint32 threadIndex) : m_events(capacity), m_written(0), m_threadIndex(threadIndex) {}
+
+        void Push(ProfilerZone const* zone);
+        std::vector<ProfilerEvent> Copy() const;
+        uint32 GetThreadIndex() const { return m_threadIndex; }
+
+    private:
+        std::vector<ProfilerEvent> m_events;
+        std::atomic<uint64> m_written;
+        uint32 m_threadIndex;
+};
+
+class Profiler
+{
+    public:
+        static Profiler& Instance();
+
+        static bool IsEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+        // spikeThreshold: dump a trace on its own when a world tick lasts at least this long, 0 to never do so
+        // both take effect at the start of the next world tick
+        void Enable(uint32 spikeThreshold);
+        void Disable();
+        uint32 GetSpikeThreshold() const { return m_spikeThreshold; }
+
+        void Begin(ProfilerZone const& zone) { LocalBuffer().Push(&zone); }
+        void End() { LocalBuffer().Push(nullptr); }
+
+        // writes the recorded zones of all threads, returns the file name or an empty string on failure
+        // must be called from the world thread outside of the map updates, zones still open end at the time of the dump
+        std::string Dump(ProfilerDumpFormat format);
+
+        // called at the start of each world tick, before its first zone, applies Enable and Disable
+        void OnWorldTickStart();
+        // called at the end of each world tick with its duration in milliseconds
+        void OnWorldTick(uint32 tickTime);
+
+    private:
+        Profiler() : m_requestedEnabled(false), m_requestedSpikeThreshold(0), m_spikeThreshold(0), m_lastSpikeDump(0) {}
+
+        struct ThreadEvents
+        {
+            uint32 threadIndex;
+            std::vector<ProfilerEvent> events;
+        };
+
+        ProfilerBuffer& LocalBuffer();
+        std::vector<ThreadEvents> Snapshot();
+
+        static std::atomic<bool> m_enabled;
+
+        std::mutex m_lock;                                  // guards the buffer list
+        std::vector<std::unique_ptr<ProfilerBuffer>> m_buffers;
+        std::atomic<bool> m_requestedEnabled;               // applied by OnWorldTickStart
+        std::atomic<uint32> m_requestedSpikeThreshold;
+        std::atomic<uint32> m_spikeThreshold;
+        time_t m_lastSpikeDump;
+};
+
+class ProfilerScope
+{
+    public:
+        explicit ProfilerScope(ProfilerZone const& zone) : m_active(Profiler::IsEnabled())
+        {
+            if (m_active)
+                Profiler::Instance().Begin(zone);
+        }
+
+        ~ProfilerScope()
+        {
+            if (m_active)
+                Profiler::Instance().End();
+        }
+
+        ProfilerScope(ProfilerScope const&) = delete;
+        ProfilerScope& operator=(ProfilerScope const&) = delete;
+
+    private:
+        bool m_active;
+};
+
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+
+// profiles the rest of the enclosing scope, name must be a string literal
+#define PROFILE_ZONE(zoneName) \
+    static ProfilerZone const PROFILE_ZONE_CONCAT(profilerZone_, __LINE__) = { zoneName }; \
+    ProfilerScope PROFILE_ZONE_CONCAT(profilerScope_, __LINE__)(PROFILE_ZONE_CONCAT(profilerZone_, __LINE__))
+
 #endif
 
@@ -0,0 +1,81 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef _MPSCQ_H
+#define _MPSCQ_H
+
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free queue for many producers and a single consumer at a time (Vyukov's node based queue).
+// Enqueue never blocks nor fails, it only swaps the head and links the previous one. Dequeue may see the
+// queue empty while a producer is between both steps; that producer is always done before its Enqueue
+// returns, so a consumer woken up after Enqueue returned finds the value.
+template <typename T>
+class MPSCQueue
+{
+    public:
+        MPSCQueue() : m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed)) {}
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+        ~MPSCQueue()
+        {
+            T value;
+            while (Dequeue(value)) {}
+
+            delete m_tail;
+        }
+
+        void Enqueue(T&& value)
+        {
+            Node* node = new Node(std::move(value));
+            Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        // consumer side, must not be called concurrently
+        bool Dequeue(T& value)
+        {
+            Node* tail = m_tail;
+            Node* next = tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            // next becomes the new stub, its value is moved out
+            value = std::move(next->value);
+            m_tail = next;
+            delete tail;
+            return true;
+        }
+
+    private:
+        struct Node
+        {
+            Node() : next(nullptr) {}
+            explicit Node(T&& value) : value(std::move(value)), next(nullptr) {}
+
+            T value;
+            std::atomic<Node*> next;
+        };
+
+        std::atomic<Node*> m_head;                          // last enqueued node, producers side
+        Node* m_tail;                                       // stub node preceding the next value, consumer side
+};
+
+#endif
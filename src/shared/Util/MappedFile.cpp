@@ -0,0 +1,128 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "Util/MappedFile.h"
+
+#include <cstdio>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    if (!m_mapped)
+    {
+        delete[] m_data;
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(m_data, m_size);
+#endif
+}
+
+std::shared_ptr<MappedFile> MappedFile::Open(char const* filename)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(handle, &size) && size.QuadPart > 0)
+    {
+        if (HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr))
+        {
+            file->m_data = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+            CloseHandle(mapping);                           // the view keeps the mapping alive
+        }
+        file->m_size = size_t(size.QuadPart);
+    }
+    CloseHandle(handle);
+#else
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* data = mmap(nullptr, size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+            file->m_data = static_cast<unsigned char*>(data);
+        file->m_size = size_t(st.st_size);
+    }
+    close(fd);                                              // the mapping keeps the file open
+#endif
+
+    if (file->m_data)
+    {
+        file->m_mapped = true;
+        return file;
+    }
+
+    // empty file or mapping not possible, read it
+    FILE* f = fopen(filename, "rb");
+    if (!f)
+        return nullptr;
+
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    if (size < 0)
+    {
+        fclose(f);
+        return nullptr;
+    }
+
+    file->m_size = size_t(size);
+    file->m_data = new unsigned char[file->m_size ? file->m_size : 1];
+    if (file->m_size && fread(file->m_data, file->m_size, 1, f) != 1)
+    {
+        fclose(f);
+        return nullptr;
+    }
+
+    fclose(f);
+    return file;
+}
+
+void MappedFile::Prefetch(char const* filename)
+{
+#if defined(POSIX_FADV_WILLNEED)
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    // only queues the read, the pages land in the page cache shared by all processes
+    posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+    close(fd);
+#else
+    (void)filename;
+#endif
+}
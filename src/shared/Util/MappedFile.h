@@ -0,0 +1,54 @@
+/*
+ * This file is part of the CMaNGOS Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPPEDFILE_H
+#define MANGOS_MAPPEDFILE_H
+
+#include "Common.h"
+
+#include <memory>
+
+// Read only view of a whole file. The file is mapped into memory when possible, so its pages are loaded on
+// first access and shared with every other process mapping the same file. The view is copy on write: a
+// page written to becomes private to this process and the file itself is never modified. When the file
+// cannot be mapped it is read into the heap instead.
+class MappedFile
+{
+    public:
+        ~MappedFile();
+        MappedFile(MappedFile const&) = delete;
+        MappedFile& operator=(MappedFile const&) = delete;
+
+        // nullptr when the file cannot be opened or read
+        static std::shared_ptr<MappedFile> Open(char const* filename);
+        // asks the system to start reading the file in the background, so a later Open does not wait for the disk
+        static void Prefetch(char const* filename);
+
+        unsigned char* GetData() const { return m_data; }
+        size_t GetSize() const { return m_size; }
+        bool IsMapped() const { return m_mapped; }
+
+    private:
+        MappedFile() : m_data(nullptr), m_size(0), m_mapped(false) {}
+
+        unsigned char* m_data;
+        size_t m_size;
+        bool m_mapped;
+};
+
+#endif
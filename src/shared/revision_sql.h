@@ -3,5 +3,5 @@
  #define REVISION_DB_REALMD "required_14083_01_realmd_joindate_datetime"
  #define REVISION_DB_LOGS "required_14039_01_logs_anticheat"
  #define REVISION_DB_CHARACTERS "required_14087_01_characters_equip_size"
- #define REVISION_DB_MANGOS "required_14089_01_mangos_reputation_spillover"
+ #define REVISION_DB_MANGOS "required_14090_02_mangos_command"
 #endif // __REVISION_SQL_H__